@@ -0,0 +1,3 @@
+#include "AnytimePathFinder.h"
+
+template class BasicAnytimePathFinder<NodeGraph, NodeHeuristic, EdgeCost>;
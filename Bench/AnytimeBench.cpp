@@ -0,0 +1,138 @@
+// Answers queries across a grid under a budget with the anytime pathfinder (ARA*), and compares the paths with the
+// shortest paths found by A*. Each row limits every query to a number of expansions or to a deadline. The cost of each
+// path must be within the bound reported for it, and with no budget the costs must match A*.
+//
+// Usage: AnytimeBench [size] [queries] [initial weight]
+
+#include "BenchCommon.h"
+
+#include "PathFinder/AnytimePathFinder.h"
+#include "PathFinder/GridPathFinder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+int main(int argc, char ** argv)
+{
+    int size      = (argc > 1) ? std::atoi(argv[1]) : 512;
+    int nQueries  = (argc > 2) ? std::atoi(argv[2]) : 50;
+    float weight  = (argc > 3) ? (float)std::atof(argv[3]) : 3.0f;
+
+    // Terrain costs between 1 and 3, with 20% of the cells impassable
+
+    std::mt19937 rng(1);
+    TerrainGrid terrain(size, rng);
+    GridGraph & grid = terrain.grid;
+
+    using Anytime = BasicAnytimePathFinder<GridGraph, OctileHeuristic>;
+    Anytime::Policy policy;
+    policy.initialWeight = weight;
+    Anytime anytime(grid, policy, OctileHeuristic{ grid.minimumCostScale() });
+    GridPathFinder astar(grid, GridPathFinder::Policy{ 0 });
+
+    // Queries between opposite corners
+
+    auto randomCell = [&] (int x0, int y0, int x1, int y1) {
+        std::uniform_int_distribution<int> x(x0, x1);
+        std::uniform_int_distribution<int> y(y0, y1);
+        for (;;)
+        {
+            int cx = x(rng);
+            int cy = y(rng);
+            if (grid.passable(cx, cy))
+                return grid.cell(cx, cy);
+        }
+    };
+
+    std::vector<GridPathFinder::Query> queries(nQueries);
+    for (auto & q : queries)
+    {
+        q.start = randomCell(0, 0, size / 4, size / 4);
+        q.end   = randomCell(size - 1 - size / 4, size - 1 - size / 4, size - 1, size - 1);
+    }
+
+    // Shortest paths
+
+    GridPathFinder::Context context;
+    GridPathFinder::Path path;
+    std::vector<float> references(nQueries);
+    double astarTime = 0.0;
+    double astarExpansions = 0.0;
+    for (int i = 0; i < nQueries; ++i)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        bool found = astar.findPath(context, queries[i].start, queries[i].end, &path);
+        astarTime += seconds(t0);
+        astarExpansions += context.expansions();
+        references[i] = found ? context.g(queries[i].end) : INFINITY;
+    }
+
+    std::printf("%dx%d grid, %d queries, initial weight %.2f\n", size, size, nQueries, weight);
+    std::printf("%-16s %10s %10s %10s %10s %10s %8s\n", "budget", "ms/query", "expansions", "cost/best", "bound",
+                "passes", "no path");
+    std::printf("%-16s %10.3f %10.0f %10.4f %10.4f %10s %8d\n", "A*", 1000.0 * astarTime / nQueries,
+                astarExpansions / nQueries, 1.0, 1.0, "-", 0);
+
+    int violations = 0;
+    auto run = [&] (char const * name, uint32_t maxExpansions, double deadlineMs) {
+        double time = 0.0;
+        double expansions = 0.0;
+        double ratio = 0.0;
+        double bound = 0.0;
+        double passes = 0.0;
+        int found = 0;
+        int bounded = 0;
+        for (int i = 0; i < nQueries; ++i)
+        {
+            Anytime::Budget budget;
+            budget.maxExpansions = maxExpansions;
+            auto t0 = std::chrono::steady_clock::now();
+            if (deadlineMs > 0.0)
+                budget.deadline = t0 + std::chrono::duration_cast<Anytime::Clock::duration>(
+                    std::chrono::duration<double, std::milli>(deadlineMs));
+            Anytime::Result result;
+            bool ok = anytime.findPath(context, queries[i].start, queries[i].end, budget, &path, &result);
+            time += seconds(t0);
+            expansions += context.expansions();
+            passes += result.passes;
+            if (!ok)
+                continue;
+
+            // The path must be valid and within its bound. Without a budget, it must be the shortest.
+            float const cost = pathCost(grid, path);
+            float const best = references[i];
+            if (std::isinf(cost) || cost > result.cost * 1.0001f || cost > best * result.bound * 1.0001f)
+                ++violations;
+            if (maxExpansions == 0 && deadlineMs <= 0.0 && !same(cost, best))
+                ++violations;
+
+            ++found;
+            ratio += cost / best;
+            if (std::isfinite(result.bound))
+            {
+                bound += result.bound;
+                ++bounded;
+            }
+        }
+        std::printf("%-16s %10.3f %10.0f %10.4f %10.4f %10.2f %8d\n", name, 1000.0 * time / nQueries,
+                    expansions / nQueries, found ? ratio / found : 0.0, bounded ? bound / bounded : 0.0,
+                    passes / nQueries, nQueries - found);
+    };
+
+    run("2000 expansions", 2000, 0.0);
+    run("10000 expansions", 10000, 0.0);
+    run("50000 expansions", 50000, 0.0);
+    run("0.5 ms", 0, 0.5);
+    run("2 ms", 0, 2.0);
+    run("10 ms", 0, 10.0);
+    run("unlimited", 0, 0.0);
+
+    std::printf("%d bound violations\n", violations);
+
+    return (violations > 0) ? 1 : 0;
+}
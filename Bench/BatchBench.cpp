@@ -0,0 +1,91 @@
+// Measures the throughput of batched queries on thread pools of increasing size, and checks that the batched results
+// match the results of the same queries run one at a time. The queries are a mix of long and short routes, so the
+// load is uneven.
+//
+// Usage: BatchBench [size] [queries] [max threads]
+
+#include "BenchCommon.h"
+
+#include "PathFinder/GridPathFinder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+int main(int argc, char ** argv)
+{
+    int size           = (argc > 1) ? std::atoi(argv[1]) : 512;
+    int nQueries       = (argc > 2) ? std::atoi(argv[2]) : 2000;
+    unsigned nThreads  = (argc > 3) ? (unsigned)std::atoi(argv[3]) : std::thread::hardware_concurrency();
+
+    // Rolling terrain with 20% of the cells impassable
+
+    std::mt19937 rng(1);
+    RollingGrid terrain(size, rng, 1.0f, 1.0f);
+    GridGraph & grid = terrain.grid;
+
+    // One query in ten crosses the map, and the rest are short
+
+    std::uniform_int_distribution<int> coordinate(0, size - 1);
+    std::uniform_int_distribution<int> offset(-size / 16, size / 16);
+    std::vector<GridPathFinder::Query> queries;
+    while ((int)queries.size() < nQueries)
+    {
+        int x0 = coordinate(rng);
+        int y0 = coordinate(rng);
+        int x1 = (queries.size() % 10 == 0) ? size - 1 - x0 : x0 + offset(rng);
+        int y1 = (queries.size() % 10 == 0) ? size - 1 - y0 : y0 + offset(rng);
+        if (grid.passable(x0, y0) && grid.passable(x1, y1))
+            queries.push_back({ grid.cell(x0, y0), grid.cell(x1, y1) });
+    }
+
+    GridPathFinder pathFinder(grid, GridPathFinder::Policy{ 0 });
+
+    // Sequential reference
+
+    std::vector<float> costs(queries.size());
+    GridPathFinder::Context context;
+    GridPathFinder::Path path;
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        costs[i] = pathFinder.findPath(context, queries[i].start, queries[i].end, &path) ? context.g(queries[i].end) : INFINITY;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double sequential = std::chrono::duration<double>(t1 - t0).count();
+
+    std::printf("%dx%d grid, %d queries, %u hardware threads\n", size, size, nQueries, std::thread::hardware_concurrency());
+    std::printf("%-12s %10s %12s %10s %10s\n", "threads", "seconds", "queries/s", "speedup", "mismatches");
+    std::printf("%-12s %10.3f %12.0f %10.2f %10d\n", "sequential", sequential, nQueries / sequential, 1.0, 0);
+
+    int failures = 0;
+    std::vector<GridPathFinder::Result> results(queries.size());
+    for (unsigned threads = 1; threads <= std::max(1u, nThreads); threads *= 2)
+    {
+        ThreadPool pool(threads);
+
+        // Warm up the contexts and the results' paths, then time a second batch
+        pathFinder.findPaths(pool, queries, results);
+        t0 = std::chrono::steady_clock::now();
+        pathFinder.findPaths(pool, queries, results);
+        t1 = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(t1 - t0).count();
+
+        int mismatches = 0;
+        for (size_t i = 0; i < queries.size(); ++i)
+        {
+            if (results[i].found != std::isfinite(costs[i]) || (results[i].found && results[i].cost != costs[i]))
+                ++mismatches;
+        }
+        failures += mismatches;
+
+        std::printf("%-12u %10.3f %12.0f %10.2f %10d\n", threads, seconds, nQueries / seconds, sequential / seconds, mismatches);
+    }
+
+    return (failures > 0) ? 1 : 0;
+}
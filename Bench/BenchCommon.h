@@ -0,0 +1,106 @@
+#if !defined(PATHFINDER_BENCHCOMMON_H_INCLUDED)
+#define PATHFINDER_BENCHCOMMON_H_INCLUDED
+
+#pragma once
+
+// Helpers shared by the benchmarks
+
+#include "PathFinder/GridGraph.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+//! Returns the number of seconds since t0.
+inline double seconds(std::chrono::steady_clock::time_point t0)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+//! Returns true if two costs are the same, within a relative tolerance. INFINITY is the same only as INFINITY.
+inline bool same(float a, float b)
+{
+    return std::isinf(a) ? std::isinf(b) : std::fabs(a - b) <= 1e-3f * std::max(1.0f, a);
+}
+
+//! Returns the cost of a path in a graph, or INFINITY if it uses an edge that does not exist. If there are several
+//! edges between two nodes, the cheapest is used.
+template <typename Graph, typename Path>
+float pathCost(Graph const & graph, Path const & path)
+{
+    float total = 0.0f;
+    for (size_t i = 1; i < path.size(); ++i)
+    {
+        float step = INFINITY;
+        graph.forEachEdge(path[i - 1], [&] (uint32_t to, float c) {
+            if (to == path[i])
+                step = std::min(step, c);
+        });
+        total += step;
+    }
+    return total;
+}
+
+//! A square grid with terrain costs between 1 and 3 (or whole costs 1, 2 and 3) and a fraction of its cells
+//! impassable, in which diagonal steps may cut corners. The grid refers to the costs and passable cells, which may be
+//! changed in place, so the fixture cannot be copied.
+struct TerrainGrid
+{
+    //! Draws the cost of each cell and then whether it is passable, from rng.
+    TerrainGrid(int size, std::mt19937 & rng, float walls = 0.2f, bool wholeCosts = false)
+        : costs(size * size)
+        , passable(size * size)
+        , grid(size, size, passable.data())
+    {
+        std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+        for (int i = 0; i < size * size; ++i)
+        {
+            costs[i]    = wholeCosts ? std::floor(1.0f + 3.0f * uniform(rng)) : 1.0f + 2.0f * uniform(rng);
+            passable[i] = uniform(rng) >= walls;
+        }
+        grid.setCosts(costs.data()).setCutCorners(true);
+    }
+
+    TerrainGrid(TerrainGrid const &) = delete;
+    TerrainGrid & operator=(TerrainGrid const &) = delete;
+
+    std::vector<float> costs;       //!< Cost of each cell
+    std::vector<uint8_t> passable;  //!< 1 for each passable cell
+    GridGraph grid;                 //!< The grid
+};
+
+//! A square grid of rolling terrain, with a fraction of its cells impassable. The cost of a step is scaled by the
+//! change in height (see GridGraph::setHeights). The grid refers to the heights and passable cells, which may be
+//! changed in place, so the fixture cannot be copied.
+struct RollingGrid
+{
+    //! Draws the noise in the height of each cell and then whether it is passable, from rng.
+    RollingGrid(int size, std::mt19937 & rng, float uphill, float downhill, float walls = 0.2f)
+        : heights(size * size)
+        , passable(size * size)
+        , grid(size, size, passable.data())
+    {
+        std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+        for (int y = 0; y < size; ++y)
+        {
+            for (int x = 0; x < size; ++x)
+            {
+                heights[y * size + x]  = 4.0f * std::sin(x * 0.05f) * std::cos(y * 0.07f) + uniform(rng);
+                passable[y * size + x] = uniform(rng) >= walls;
+            }
+        }
+        grid.setHeights(heights.data(), uphill, downhill);
+    }
+
+    RollingGrid(RollingGrid const &) = delete;
+    RollingGrid & operator=(RollingGrid const &) = delete;
+
+    std::vector<float> heights;     //!< Height of each cell
+    std::vector<uint8_t> passable;  //!< 1 for each passable cell
+    GridGraph grid;                 //!< The grid
+};
+
+#endif // !defined(PATHFINDER_BENCHCOMMON_H_INCLUDED)
@@ -0,0 +1,203 @@
+// Runs queries on grids with the open list limited to a few nodes (see Policy::maxNodes), in both directions, and
+// compares the paths with the shortest paths. The grids vary in the density of their walls, in their costs (uniform,
+// which makes many ties, or between 1 and 3) and in whether diagonal steps may cut corners. Every query must end: a
+// watchdog fails the benchmark if one runs longer than the timeout. Each path found must be valid and no shorter than
+// the shortest path, a path must be found exactly where there is one, and so the number of paths found must not drop
+// as the limit grows.
+//
+// Usage: BoundedBench [size] [grids] [queries per grid] [timeout seconds]
+
+#include "BenchCommon.h"
+
+#include "PathFinder/GridPathFinder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // A grid and the queries run on it, with the costs of their shortest paths
+    struct Map
+    {
+        // Returns the grid, which refers to the map's cells, so it is valid only as long as the map is
+        GridGraph graph() const
+        {
+            GridGraph grid(size, size, passable.data());
+            if (weighted)
+                grid.setCosts(costs.data());
+            grid.setCutCorners(cutCorners);
+            return grid;
+        }
+
+        int size        = 0;
+        bool weighted   = false;
+        bool cutCorners = false;
+        std::vector<float> costs;
+        std::vector<uint8_t> passable;
+        std::vector<GridPathFinder::Query> queries;
+        std::vector<float> references;
+    };
+
+    // Generates grid number i, with its queries and their shortest paths
+    void generate(Map & map, int size, int i, int nQueries)
+    {
+        std::mt19937 rng(i + 1);
+        std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+        float const walls = 0.05f + 0.4f * uniform(rng);
+        map.size       = size;
+        map.weighted   = (i % 2 == 1);
+        map.cutCorners = (i % 4 >= 2);
+        map.costs.resize(size * size);
+        map.passable.resize(size * size);
+        for (int c = 0; c < size * size; ++c)
+        {
+            map.costs[c]    = 1.0f + 2.0f * uniform(rng);
+            map.passable[c] = uniform(rng) >= walls;
+        }
+
+        std::uniform_int_distribution<int> cell(0, size * size - 1);
+        map.queries.clear();
+        while ((int)map.queries.size() < nQueries)
+        {
+            uint32_t start = cell(rng);
+            uint32_t goal  = cell(rng);
+            if (map.passable[start] && map.passable[goal])
+                map.queries.push_back({ start, goal });
+        }
+
+        GridGraph const grid = map.graph();
+        GridPathFinder astar(grid, GridPathFinder::Policy{ 0 });
+        GridPathFinder::Context context;
+        GridPathFinder::Path path;
+        map.references.resize(nQueries);
+        for (int q = 0; q < nQueries; ++q)
+        {
+            bool found = astar.findPath(context, map.queries[q].start, map.queries[q].end, &path);
+            map.references[q] = found ? pathCost(grid, path) : INFINITY;
+        }
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    int size       = (argc > 1) ? std::atoi(argv[1]) : 64;
+    int nGrids     = (argc > 2) ? std::atoi(argv[2]) : 32;
+    int nQueries   = (argc > 3) ? std::atoi(argv[3]) : 20;
+    double timeout = (argc > 4) ? std::atof(argv[4]) : 10.0;
+
+    std::vector<Map> maps(nGrids);
+    for (int i = 0; i < nGrids; ++i)
+        generate(maps[i], size, i, nQueries);
+
+    // The watchdog ends the process if the number of queries answered stops changing for longer than the timeout
+
+    std::atomic<uint64_t> answered(0);
+    std::atomic<bool> done(false);
+    std::thread watchdog([&] {
+        uint64_t last = answered.load();
+        auto t0 = std::chrono::steady_clock::now();
+        while (!done.load())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            uint64_t const now = answered.load();
+            if (now != last)
+            {
+                last = now;
+                t0 = std::chrono::steady_clock::now();
+            }
+            else if (seconds(t0) > timeout)
+            {
+                std::printf("A query did not end within %g s\n", timeout);
+                std::fflush(stdout);
+                std::_Exit(1);
+            }
+        }
+    });
+
+    int const total = nGrids * nQueries;
+    std::printf("%d %dx%d grids, %d queries, timeout %g s\n", nGrids, size, size, total, timeout);
+    std::printf("%-16s %8s %8s %8s %10s %10s %10s\n", "search", "limit", "found", "longer", "cost/best", "expanded",
+                "us/query");
+
+    int violations = 0;
+    GridPathFinder::Context context;
+    GridPathFinder::Path path;
+    for (bool bidirectional : { false, true })
+    {
+        int previous = 0;
+        for (int limit : { 1, 2, 3, 4, 5, 6, 7, 8, 64 })
+        {
+            GridPathFinder::Policy const policy{ limit, SearchPolicy::OpenList::INDEXED_HEAP, bidirectional };
+
+            int found = 0;
+            int longer = 0;
+            double ratio = 0.0;
+            double expanded = 0.0;
+            double time = 0.0;
+            for (Map const & map : maps)
+            {
+                GridGraph const grid = map.graph();
+                GridPathFinder pathFinder(grid, policy);
+                auto t0 = std::chrono::steady_clock::now();
+                for (int q = 0; q < nQueries; ++q)
+                {
+                    GridPathFinder::Query const & query = map.queries[q];
+                    bool ok = pathFinder.findPath(context, query.start, query.end, &path);
+                    ++answered;
+                    expanded += context.expansions();
+                    if (bidirectional)
+                        expanded += context.backward().expansions();
+                    if (!ok)
+                    {
+                        // Forgetting nodes must not lose the path
+                        if (!std::isinf(map.references[q]))
+                            ++violations;
+                        continue;
+                    }
+
+                    // The path must be valid and no shorter than the shortest
+                    float const cost = pathCost(grid, path);
+                    float const best = map.references[q];
+                    if (path.empty() || path.front() != query.start || path.back() != query.end || std::isinf(cost) ||
+                        std::isinf(best) || cost < best * 0.9999f)
+                    {
+                        ++violations;
+                        continue;
+                    }
+
+                    ++found;
+                    ratio += (best > 0.0f) ? cost / best : 1.0;
+                    if (cost > best * 1.0001f)
+                        ++longer;
+                }
+                time += seconds(t0);
+            }
+
+            std::printf("%-16s %8d %8d %8d %10.4f %10.1f %10.2f\n",
+                        bidirectional ? "bidirectional" : "unidirectional", limit, found, longer,
+                        found ? ratio / found : 0.0, expanded / total, 1e6 * time / total);
+
+            // A larger limit must not find fewer paths
+            if (found < previous)
+            {
+                std::printf("Fewer paths found with a limit of %d than with a smaller limit\n", limit);
+                ++violations;
+            }
+            previous = found;
+        }
+    }
+
+    done = true;
+    watchdog.join();
+
+    std::printf("%d violations\n", violations);
+
+    return (violations > 0) ? 1 : 0;
+}
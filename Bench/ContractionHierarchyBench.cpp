@@ -0,0 +1,120 @@
+// Measures the preprocessing time, size and query time of a contraction hierarchy on a synthetic road network, and
+// compares the queries with Dijkstra's algorithm. The costs must match, and every unpacked path must be a valid path in
+// the original graph with the same cost.
+//
+// Usage: ContractionHierarchyBench [size] [queries]
+
+#include "BenchCommon.h"
+
+#include "PathFinder/CompactGraph.h"
+#include "PathFinder/ContractionHierarchy.h"
+#include "PathFinder/PathFinder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+int main(int argc, char ** argv)
+{
+    int size     = (argc > 1) ? std::atoi(argv[1]) : 512;
+    int nQueries = (argc > 2) ? std::atoi(argv[2]) : 200;
+
+    // A road network: a square lattice of streets with random travel times, 10% of them missing, and some one-way.
+    // Every 16th street is an arterial road that is three times as fast.
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    std::vector<CompactGraph::Edge> edges;
+    auto street = [&] (int x0, int y0, int x1, int y1, bool arterial) {
+        if (uniform(rng) < 0.1f)
+            return;
+        uint32_t a = (uint32_t)(y0 * size + x0);
+        uint32_t b = (uint32_t)(y1 * size + x1);
+        float time = (arterial ? 1.0f : 3.0f) * (1.0f + uniform(rng));
+        bool oneWay = uniform(rng) < 0.05f;
+        edges.push_back({ a, b, time });
+        if (!oneWay)
+            edges.push_back({ b, a, time });
+    };
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            if (x + 1 < size)
+                street(x, y, x + 1, y, y % 16 == 0);
+            if (y + 1 < size)
+                street(x, y, x, y + 1, x % 16 == 0);
+        }
+    }
+    CompactGraph graph((uint32_t)(size * size), edges);
+
+    std::printf("%u nodes, %u edges\n", graph.size(), graph.edgeCount());
+
+    auto t0 = std::chrono::steady_clock::now();
+    ContractionHierarchy hierarchy(graph);
+    double preprocessing = seconds(t0);
+
+    std::printf("preprocessing: %.2f s, %u shortcuts, %.1f MB (graph %.1f MB)\n",
+                preprocessing, hierarchy.shortcutCount(), hierarchy.memoryUsage() / 1048576.0,
+                graph.memoryUsage() / 1048576.0);
+
+    std::uniform_int_distribution<uint32_t> node(0, graph.size() - 1);
+    std::vector<std::pair<uint32_t, uint32_t>> queries;
+    for (int i = 0; i < nQueries; ++i)
+    {
+        queries.emplace_back(node(rng), node(rng));
+    }
+
+    // Dijkstra reference
+
+    PathFinder dijkstra(nullptr, PathFinder::Policy{ 0 });
+    PathFinder::Context context;
+    PathFinder::IndexPath path;
+    std::vector<float> costs(queries.size());
+    t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        bool found = dijkstra.findPath(graph, context, queries[i].first, queries[i].second, &path);
+        costs[i] = found ? context.g(queries[i].second) : INFINITY;
+    }
+    double dijkstraTime = seconds(t0);
+
+    // Hierarchy queries, first without unpacking and then with
+
+    ContractionHierarchy::Context chContext;
+    int mismatches = 0;
+    t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        float c = hierarchy.findCost(chContext, queries[i].first, queries[i].second);
+        if (!same(c, costs[i]))
+            ++mismatches;
+    }
+    double costTime = seconds(t0);
+    uint32_t expansions = chContext.expansions() + chContext.backward().expansions();
+
+    int invalid = 0;
+    t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        bool found = hierarchy.findPath(chContext, queries[i].first, queries[i].second, &path);
+        if (found != std::isfinite(costs[i]))
+            ++invalid;
+        else if (found && (path.front() != queries[i].first || path.back() != queries[i].second ||
+                           !same(pathCost(graph, path), costs[i])))
+            ++invalid;
+    }
+    double pathTime = seconds(t0);
+
+    std::printf("%-24s %12s\n", "query", "ms/query");
+    std::printf("%-24s %12.3f\n", "dijkstra", 1000.0 * dijkstraTime / nQueries);
+    std::printf("%-24s %12.3f\n", "hierarchy (cost)", 1000.0 * costTime / nQueries);
+    std::printf("%-24s %12.3f\n", "hierarchy (path)", 1000.0 * pathTime / nQueries);
+    std::printf("last query settled %u nodes; %d cost mismatches, %d invalid paths\n", expansions, mismatches, invalid);
+
+    return (mismatches > 0 || invalid > 0) ? 1 : 0;
+}
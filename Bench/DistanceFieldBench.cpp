@@ -0,0 +1,144 @@
+// Compares one distance field with a separate search for each agent heading for the same goal, and measures how much
+// of the field is reused when the goal moves. The costs read from the field must match the costs found by A*, and the
+// costs of an updated field must match those of a field computed from scratch.
+//
+// Usage: DistanceFieldBench [size] [agents] [moves]
+
+#include "BenchCommon.h"
+
+#include "PathFinder/DistanceField.h"
+#include "PathFinder/GridPathFinder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+int main(int argc, char ** argv)
+{
+    int size    = (argc > 1) ? std::atoi(argv[1]) : 512;
+    int nAgents = (argc > 2) ? std::atoi(argv[2]) : 200;
+    int nMoves  = (argc > 3) ? std::atoi(argv[3]) : 10;
+
+    // Rolling terrain with 20% of the cells impassable. Uphill is more expensive than downhill, so the costs are not
+    // symmetric.
+
+    std::mt19937 rng(1);
+    RollingGrid terrain(size, rng, 2.0f, 0.5f);
+    GridGraph & grid = terrain.grid;
+
+    std::uniform_int_distribution<int> coordinate(0, size - 1);
+    auto randomCell = [&] {
+        for (;;)
+        {
+            int x = coordinate(rng);
+            int y = coordinate(rng);
+            if (grid.passable(x, y))
+                return grid.cell(x, y);
+        }
+    };
+
+    uint32_t goal = grid.cell(size / 2, size / 2);
+    terrain.passable[goal] = 1;
+    std::vector<uint32_t> agents(nAgents);
+    for (auto & agent : agents)
+    {
+        agent = randomCell();
+    }
+
+    // One search per agent
+
+    GridPathFinder pathFinder(grid, GridPathFinder::Policy{ 0 });
+    GridPathFinder::Context context;
+    GridPathFinder::Path path;
+    std::vector<float> costs(nAgents);
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < nAgents; ++i)
+    {
+        costs[i] = pathFinder.findPath(context, agents[i], goal, &path) ? context.g(goal) : INFINITY;
+    }
+    double searches = seconds(t0);
+
+    // One field for all agents
+
+    BasicDistanceField<GridGraph> field(grid);
+    t0 = std::chrono::steady_clock::now();
+    field.compute(goal);
+    double compute = seconds(t0);
+
+    t0 = std::chrono::steady_clock::now();
+    size_t steps = 0;
+    for (int i = 0; i < nAgents; ++i)
+    {
+        if (field.path(agents[i], &path))
+            steps += path.size();
+    }
+    double read = seconds(t0);
+
+    int failures = 0;
+    for (int i = 0; i < nAgents; ++i)
+    {
+        if (!same(costs[i], field.cost(agents[i])))
+            ++failures;
+    }
+
+    std::printf("%dx%d grid, %d agents\n", size, size, nAgents);
+    std::printf("%d searches: %.3f s, field: %.3f s, reading %zu path steps: %.6f s, mismatches: %d\n",
+                nAgents,
+                searches,
+                compute,
+                steps,
+                read,
+                failures);
+
+    // Move the goal a few cells at a time, and compare the updated field with a new one
+
+    BasicDistanceField<GridGraph> reference(grid);
+    std::uniform_int_distribution<int> step(-3, 3);
+    double incremental = 0.0;
+    double full        = 0.0;
+    uint64_t settled   = 0;
+    int moves          = 0;
+    while (moves < nMoves)
+    {
+        int x = grid.x(goal) + step(rng);
+        int y = grid.y(goal) + step(rng);
+        if (!grid.passable(x, y))
+            continue;
+        goal = grid.cell(x, y);
+        ++moves;
+
+        t0 = std::chrono::steady_clock::now();
+        field.moveGoal(goal);
+        incremental += seconds(t0);
+        settled += field.settled();
+
+        t0 = std::chrono::steady_clock::now();
+        reference.compute(goal);
+        full += seconds(t0);
+
+        int mismatches = 0;
+        for (uint32_t i = 0; i < grid.size(); ++i)
+        {
+            if (!same(reference.costs()[i], field.costs()[i]))
+                ++mismatches;
+        }
+        failures += mismatches;
+    }
+
+    std::printf("%d goal moves: incremental %.3f s (%.0f%% of the nodes searched again), full %.3f s\n",
+                nMoves,
+                incremental,
+                100.0 * settled / (double(reference.settled()) * nMoves),
+                full);
+
+    if (failures > 0)
+    {
+        std::printf("FAILED: %d mismatches\n", failures);
+        return 1;
+    }
+    return 0;
+}
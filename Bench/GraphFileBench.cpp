@@ -0,0 +1,193 @@
+// Builds a synthetic road network with its landmarks and contraction hierarchy, writes them to a graph file, and
+// compares the time taken to build them with the time taken to map the file. The mapped arrays must match the built
+// ones and must pass GraphFile::validate(), searches of the mapped data must find the same costs as searches of the
+// built data, a file with an edge leading out of the graph or with decreasing offsets must fail validation, and a file
+// with another version must be rejected.
+//
+// Usage: GraphFileBench [size] [queries] [file]
+
+#include "BenchCommon.h"
+
+#include "PathFinder/BasicPathFinder.h"
+#include "PathFinder/CompactGraph.h"
+#include "PathFinder/ContractionHierarchy.h"
+#include "PathFinder/GraphFile.h"
+#include "PathFinder/Landmarks.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // Returns true if two arrays have the same contents
+    template <typename T>
+    bool same(T const * a, T const * b, size_t n)
+    {
+        return n == 0 || std::memcmp(a, b, n * sizeof(T)) == 0;
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    int size         = (argc > 1) ? std::atoi(argv[1]) : 256;
+    int nQueries     = (argc > 2) ? std::atoi(argv[2]) : 200;
+    char const * out = (argc > 3) ? argv[3] : "GraphFileBench.graph";
+
+    // A road network: a square lattice of streets with random travel times, 10% of them missing, and some one-way.
+    // Every 16th street is an arterial road that is three times as fast.
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    std::vector<CompactGraph::Edge> edges;
+    auto street = [&] (int x0, int y0, int x1, int y1, bool arterial) {
+        if (uniform(rng) < 0.1f)
+            return;
+        uint32_t a = (uint32_t)(y0 * size + x0);
+        uint32_t b = (uint32_t)(y1 * size + x1);
+        float time = (arterial ? 1.0f : 3.0f) * (1.0f + uniform(rng));
+        bool oneWay = uniform(rng) < 0.05f;
+        edges.push_back({ a, b, time });
+        if (!oneWay)
+            edges.push_back({ b, a, time });
+    };
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            if (x + 1 < size)
+                street(x, y, x + 1, y, y % 16 == 0);
+            if (y + 1 < size)
+                street(x, y, x, y + 1, x % 16 == 0);
+        }
+    }
+
+    // Build everything, as a service would at startup
+
+    auto t0 = std::chrono::steady_clock::now();
+    CompactGraph graph((uint32_t)(size * size), edges);
+    Landmarks landmarks(graph, 16, Landmarks::Selection::FARTHEST);
+    ContractionHierarchy hierarchy(graph);
+    double buildTime = seconds(t0);
+
+    t0 = std::chrono::steady_clock::now();
+    if (!GraphFile::write(out, graph.view(), landmarks.table(), &hierarchy))
+    {
+        std::fprintf(stderr, "Unable to write %s\n", out);
+        return 1;
+    }
+    double writeTime = seconds(t0);
+
+    // Map the file instead
+
+    t0 = std::chrono::steady_clock::now();
+    GraphFile file;
+    bool opened = file.open(out);
+    ContractionHierarchy mappedHierarchy(opened ? file.hierarchy() : hierarchy.view());
+    double openTime = seconds(t0);
+    if (!opened || !file.hasLandmarks() || !file.hasHierarchy())
+    {
+        std::fprintf(stderr, "Unable to open %s\n", out);
+        return 1;
+    }
+
+    std::printf("%u nodes, %u edges, %u landmarks, %u shortcuts, %.1f MB file\n", graph.size(), graph.edgeCount(),
+                landmarks.count(), hierarchy.shortcutCount(), file.size() / 1048576.0);
+    std::printf("build: %.3f s, write: %.3f s, open: %.6f s\n", buildTime, writeTime, openTime);
+
+    // The mapped arrays must be the same as the built ones, and valid
+
+    int mismatches = 0;
+    if (!file.validate())
+        ++mismatches;
+    CompactGraphView const built = graph.view();
+    CompactGraphView const & mapped = file.graph();
+    ContractionHierarchy::View const & a = hierarchy.view();
+    ContractionHierarchy::View const & b = file.hierarchy();
+    if (mapped.size() != built.size() || mapped.edgeCount() != built.edgeCount() ||
+        !same(mapped.offsets(), built.offsets(), built.size() + 1) ||
+        !same(mapped.targets(), built.targets(), built.edgeCount()) ||
+        !same(mapped.costs(), built.costs(), built.edgeCount()) ||
+        file.landmarks().count() != landmarks.count() ||
+        !same(file.landmarks().landmarks(), landmarks.table().landmarks(), landmarks.count()) ||
+        !same(file.landmarks().distances(), landmarks.distances().data(), landmarks.distances().size()) ||
+        b.up.size() != a.up.size() || b.down.size() != a.down.size() || b.shortcuts != a.shortcuts ||
+        !same(b.ranks.data(), a.ranks.data(), a.ranks.size()) ||
+        !same(b.up.data(), a.up.data(), a.up.size()) ||
+        !same(b.down.data(), a.down.data(), a.down.size()))
+    {
+        ++mismatches;
+    }
+
+    // Searches of the mapped data must find the same costs
+
+    using AltPathFinder = BasicPathFinder<CompactGraphView, LandmarkTableHeuristic>;
+    AltPathFinder builtFinder(built, SearchPolicy{ 0 }, LandmarkTableHeuristic{ landmarks.table() });
+    AltPathFinder mappedFinder(mapped, SearchPolicy{ 0 }, LandmarkTableHeuristic{ file.landmarks() });
+    AltPathFinder::Context context;
+    AltPathFinder::Path path;
+    ContractionHierarchy::Context chContext;
+    std::uniform_int_distribution<uint32_t> node(0, graph.size() - 1);
+    double builtTime  = 0.0;
+    double mappedTime = 0.0;
+    for (int q = 0; q < nQueries; ++q)
+    {
+        uint32_t start = node(rng);
+        uint32_t goal  = node(rng);
+
+        t0 = std::chrono::steady_clock::now();
+        bool found = builtFinder.findPath(context, start, goal, &path);
+        float builtCost = found ? context.g(goal) : INFINITY;
+        builtTime += seconds(t0);
+
+        t0 = std::chrono::steady_clock::now();
+        found = mappedFinder.findPath(context, start, goal, &path);
+        float mappedCost = found ? context.g(goal) : INFINITY;
+        mappedTime += seconds(t0);
+
+        if (!same(builtCost, mappedCost) ||
+            !same(builtCost, mappedHierarchy.findCost(chContext, start, goal)) ||
+            !same(builtCost, hierarchy.findCost(chContext, start, goal)))
+        {
+            ++mismatches;
+        }
+    }
+    std::printf("ALT queries: built %.3f ms, mapped %.3f ms\n", 1000.0 * builtTime / nQueries,
+                1000.0 * mappedTime / nQueries);
+
+    // A file with an edge leading out of the graph, or with decreasing offsets, opens but is not valid
+
+    file.close();
+    uint32_t const offsets[][3] = { { 0, 2, 2 }, { 0, 2, 1 } };
+    uint32_t const targets[][2] = { { 1, 5 }, { 1, 0 } };
+    float const costs[]         = { 1.0f, 1.0f };
+    for (int i = 0; i < 2; ++i)
+    {
+        CompactGraphView const corrupt(2, offsets[i], targets[i], costs);
+        if (!GraphFile::write(out, corrupt) || !file.open(out) || file.validate())
+            ++mismatches;
+        file.close();
+    }
+
+    // A file written by another version of the format must be rejected
+
+    if (!GraphFile::write(out, graph.view(), landmarks.table(), &hierarchy))
+        ++mismatches;
+    std::FILE * f = std::fopen(out, "r+b");
+    uint32_t version = GraphFile::VERSION + 1;
+    bool patched = f && std::fseek(f, 8, SEEK_SET) == 0 && std::fwrite(&version, sizeof(version), 1, f) == 1;
+    if (f)
+        std::fclose(f);
+    if (!patched || file.open(out))
+        ++mismatches;
+    std::remove(out);
+
+    std::printf("%d mismatches\n", mismatches);
+
+    return (mismatches > 0) ? 1 : 0;
+}
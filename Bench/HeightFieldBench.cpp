@@ -0,0 +1,204 @@
+// Builds pathing graphs from a height field image, and from the same image magnified, comparing a serial scalar loop
+// that computes each step's cost from the heights (as GridGraph does during a search) with HeightFieldBuilder on one
+// thread and on a pool. It then edits a patch of terrain and rebuilds only the dirty rectangle. The costs of the
+// steps must match GridGraph's height model, the rebuilt graph must match a graph built from scratch, and the costs of
+// paths must match those found by GridPathFinder.
+//
+// Usage: HeightFieldBench [image] [magnification] [threads]
+
+#include "BenchCommon.h"
+
+#include "PathFinder/BasicPathFinder.h"
+#include "PathFinder/GridPathFinder.h"
+#include "PathFinder/HeightFieldGraph.h"
+#include "PathFinder/ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Returns the shortest time taken by a function over a few runs
+    template <typename Function>
+    double fastest(Function && function)
+    {
+        double best = INFINITY;
+        for (int run = 0; run < 5; ++run)
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            function();
+            best = std::min(best, seconds(t0));
+        }
+        return best;
+    }
+
+    // Returns a height map magnified by bilinear interpolation
+    HeightMap magnify(HeightMap const & map, int factor)
+    {
+        HeightMap result;
+        result.width  = (map.width - 1) * factor + 1;
+        result.height = (map.height - 1) * factor + 1;
+        result.heights.resize((size_t)result.width * result.height);
+        for (int y = 0; y < result.height; ++y)
+        {
+            int const y0 = std::min(y / factor, map.height - 2);
+            float const fy = (float)(y - y0 * factor) / factor;
+            for (int x = 0; x < result.width; ++x)
+            {
+                int const x0 = std::min(x / factor, map.width - 2);
+                float const fx = (float)(x - x0 * factor) / factor;
+                float const z0 = map.z(x0, y0) + (map.z(x0 + 1, y0) - map.z(x0, y0)) * fx;
+                float const z1 = map.z(x0, y0 + 1) + (map.z(x0 + 1, y0 + 1) - map.z(x0, y0 + 1)) * fx;
+                result.heights[(size_t)y * result.width + x] = z0 + (z1 - z0) * fy;
+            }
+        }
+        return result;
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    char const * image = (argc > 1) ? argv[1] : "Test/hf.tga";
+    int magnification  = (argc > 2) ? std::atoi(argv[2]) : 8;
+    unsigned nThreads  = (argc > 3) ? (unsigned)std::atoi(argv[3]) : std::thread::hardware_concurrency();
+
+    // The settings of the test application: heights up to 32, sea level at a quarter of that
+    float const zScale = 32.0f;
+    HeightFieldBuilder::Settings settings;
+    settings.seaLevel   = zScale * 0.25f;
+    settings.uphill     = 1.0f;
+    settings.downhill   = 0.5f;
+    settings.cutCorners = true;
+
+    HeightMap original;
+    if (!original.load(image, zScale))
+    {
+        std::fprintf(stderr, "Unable to load %s\n", image);
+        return 1;
+    }
+
+    ThreadPool pool(nThreads);
+    int mismatches = 0;
+
+    std::printf("%s: %dx%d, %u threads\n", image, original.width, original.height, pool.size());
+    std::printf("%-12s %10s %10s %10s %10s %10s %10s\n", "field", "cells", "scalar ms", "1 thread", "pool ms",
+                "speedup", "update ms");
+
+    for (int factor : { 1, magnification })
+    {
+        HeightMap map = (factor > 1) ? magnify(original, factor) : original;
+        int const size = map.width * map.height;
+
+        // Scalar reference: the mask and the cost of every step, computed one at a time from the heights
+
+        std::vector<uint8_t> passable(size);
+        std::vector<float> reference((size_t)size * HeightFieldGraph::DIRECTIONS);
+        GridGraph grid(map.width, map.height, passable.data());
+        grid.setHeights(map.heights.data(), settings.uphill, settings.downhill).setCutCorners(settings.cutCorners);
+        double scalarTime = fastest([&] {
+            for (int i = 0; i < size; ++i)
+            {
+                passable[i] = map.heights[i] >= settings.seaLevel;
+            }
+            std::fill(reference.begin(), reference.end(), INFINITY);
+            for (int i = 0; i < size; ++i)
+            {
+                if (!passable[i])
+                    continue;
+                for (int d = 0; d < HeightFieldGraph::DIRECTIONS; ++d)
+                {
+                    int const x = grid.x(i) + HeightFieldGraph::DX[d];
+                    int const y = grid.y(i) + HeightFieldGraph::DY[d];
+                    bool const diagonal = d >= 4;
+                    bool const corners  = grid.passable(x, grid.y(i)) && grid.passable(grid.x(i), y);
+                    float & cost = reference[(size_t)i * HeightFieldGraph::DIRECTIONS + d];
+                    if (grid.passable(x, y) && (settings.cutCorners || !diagonal || corners))
+                        cost = grid.stepCost(i, grid.cell(x, y), diagonal);
+                }
+            }
+        });
+
+        // The builder, serial and parallel
+
+        HeightFieldBuilder builder(map.heights.data(), map.width, map.height, settings);
+        double serialTime   = fastest([&] { builder.build(); });
+        double parallelTime = fastest([&] { builder.build(&pool); });
+
+        HeightFieldGraph graph = builder.graph();
+        for (uint32_t i = 0; i < (uint32_t)size; ++i)
+        {
+            for (int d = 0; d < HeightFieldGraph::DIRECTIONS; ++d)
+            {
+                if (graph.cost(i, d) != reference[(size_t)i * HeightFieldGraph::DIRECTIONS + d])
+                    ++mismatches;
+            }
+        }
+
+        // Paths must cost the same as in the grid
+
+        BasicPathFinder<HeightFieldGraph, OctileHeuristic> pathFinder(graph, SearchPolicy{ 0 },
+                                                                      OctileHeuristic{ graph.minimumCostScale() });
+        GridPathFinder gridPathFinder(grid, GridPathFinder::Policy{ 0 });
+        GridPathFinder::Context context;
+        GridPathFinder::Path path;
+        std::mt19937 rng(1);
+        std::uniform_int_distribution<int> cell(0, size - 1);
+        for (int q = 0; q < 20; ++q)
+        {
+            uint32_t start = cell(rng);
+            uint32_t goal  = cell(rng);
+            if (!passable[start] || !passable[goal])
+                continue;
+            bool found = pathFinder.findPath(context, start, goal, &path);
+            float cost = found ? context.g(goal) : INFINITY;
+            found = gridPathFinder.findPath(context, start, goal, &path);
+            if (!same(cost, found ? context.g(goal) : INFINITY))
+                ++mismatches;
+        }
+
+        // Raise a hill in a patch of terrain, rebuild the dirty rectangle, and compare with a new build
+
+        int const patch = std::min(32 * factor, map.width / 4);
+        int const px = map.width / 3;
+        int const py = map.height / 3;
+        for (int y = py; y < py + patch; ++y)
+        {
+            for (int x = px; x < px + patch; ++x)
+            {
+                float const dx = (x - px) / (float)patch - 0.5f;
+                float const dy = (y - py) / (float)patch - 0.5f;
+                map.heights[(size_t)y * map.width + x] += zScale * 0.25f * std::max(0.0f, 0.25f - dx * dx - dy * dy);
+            }
+        }
+        auto t0 = std::chrono::steady_clock::now();
+        builder.update(px, py, px + patch, py + patch, &pool);
+        double updateTime = seconds(t0);
+
+        HeightFieldBuilder fresh(map.heights.data(), map.width, map.height, settings);
+        fresh.build(&pool);
+        HeightFieldGraph freshGraph = fresh.graph();
+        for (uint32_t i = 0; i < (uint32_t)size; ++i)
+        {
+            for (int d = 0; d < HeightFieldGraph::DIRECTIONS; ++d)
+            {
+                if (graph.cost(i, d) != freshGraph.cost(i, d))
+                    ++mismatches;
+            }
+        }
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "x%d", factor);
+        std::printf("%-12s %10d %10.3f %10.3f %10.3f %10.2f %10.3f\n", name, size, 1000.0 * scalarTime,
+                    1000.0 * serialTime, 1000.0 * parallelTime, scalarTime / parallelTime, 1000.0 * updateTime);
+    }
+
+    std::printf("%d mismatches\n", mismatches);
+
+    return (mismatches > 0) ? 1 : 0;
+}
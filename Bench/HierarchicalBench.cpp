@@ -0,0 +1,144 @@
+// Compares the hierarchical pathfinder with A* on a large terrain grid: the time to build the clusters, the time per
+// query, and how much longer the hierarchical paths are. Then it changes a small region of the terrain and compares
+// updating the affected clusters with rebuilding all of them. Every path must be a valid path on the grid.
+//
+// Usage: HierarchicalBench [size] [cluster size] [queries]
+
+#include "BenchCommon.h"
+
+#include "PathFinder/GridPathFinder.h"
+#include "PathFinder/HierarchicalPathFinder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+int main(int argc, char ** argv)
+{
+    int size        = (argc > 1) ? std::atoi(argv[1]) : 1024;
+    int clusterSize = (argc > 2) ? std::atoi(argv[2]) : 32;
+    int nQueries    = (argc > 3) ? std::atoi(argv[3]) : 50;
+
+    // Rolling terrain with 20% of the cells impassable
+
+    std::mt19937 rng(1);
+    RollingGrid terrain(size, rng, 1.0f, 0.5f);
+    GridGraph & grid = terrain.grid;
+
+    // Queries between opposite corners of the map
+
+    std::uniform_int_distribution<int> coordinate(0, size / 8);
+    std::vector<std::pair<uint32_t, uint32_t>> queries;
+    while ((int)queries.size() < nQueries)
+    {
+        int x0 = coordinate(rng);
+        int y0 = coordinate(rng);
+        int x1 = size - 1 - coordinate(rng);
+        int y1 = size - 1 - coordinate(rng);
+        if (grid.passable(x0, y0) && grid.passable(x1, y1))
+            queries.emplace_back(grid.cell(x0, y0), grid.cell(x1, y1));
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    HierarchicalPathFinder hierarchical(grid, clusterSize, HierarchicalPathFinder::Policy{ 0 });
+    double build = seconds(t0);
+
+    std::printf("%dx%d grid, %dx%d clusters, %d queries\n", size, size, clusterSize, clusterSize, nQueries);
+    std::printf("build: %.3f s, %u clusters, %u abstract nodes, %u abstract edges\n",
+                build,
+                hierarchical.clusterCount(),
+                hierarchical.abstractGraph().size(),
+                hierarchical.abstractGraph().edgeCount());
+
+    GridPathFinder aStar(grid, GridPathFinder::Policy{ 0 });
+    int failures = 0;
+
+    auto compare = [&] {
+        GridPathFinder::Path path;
+        double aStarTime       = 0.0;
+        double abstractTime    = 0.0;
+        double hierarchicalTime = 0.0;
+        double aStarCost       = 0.0;
+        double hierarchicalCost = 0.0;
+        for (auto const & q : queries)
+        {
+            t0 = std::chrono::steady_clock::now();
+            bool found = aStar.findPath(q.first, q.second, &path);
+            aStarTime += seconds(t0);
+            float optimal = found ? pathCost(grid, path) : 0.0f;
+
+            HierarchicalPathFinder::Path waypoints;
+            t0 = std::chrono::steady_clock::now();
+            hierarchical.findAbstractPath(q.first, q.second, &waypoints);
+            abstractTime += seconds(t0);
+
+            t0 = std::chrono::steady_clock::now();
+            bool foundHierarchical = hierarchical.findPath(q.first, q.second, &path);
+            hierarchicalTime += seconds(t0);
+
+            if (found != foundHierarchical)
+            {
+                ++failures;
+                continue;
+            }
+            if (found)
+            {
+                float c = pathCost(grid, path);
+                if (std::isinf(c) || c < optimal * 0.999f || path.front() != q.first || path.back() != q.second)
+                    ++failures;
+                aStarCost += optimal;
+                hierarchicalCost += c;
+            }
+        }
+        std::printf("A*: %.2f ms/query, abstract path: %.2f ms/query, refined path: %.2f ms/query, %.2f%% longer\n",
+                    1e3 * aStarTime / nQueries,
+                    1e3 * abstractTime / nQueries,
+                    1e3 * hierarchicalTime / nQueries,
+                    100.0 * (hierarchicalCost / aStarCost - 1.0));
+    };
+
+    compare();
+
+    // Raise a hill and wall off part of it, then update the affected clusters
+
+    int const x0 = size / 3;
+    int const y0 = size / 3;
+    int const extent = clusterSize * 2;
+    for (int y = y0; y < y0 + extent; ++y)
+    {
+        for (int x = x0; x < x0 + extent; ++x)
+        {
+            terrain.heights[y * size + x] += 3.0f;
+            if (x == x0 + extent / 2)
+                terrain.passable[y * size + x] = 0;
+        }
+    }
+
+    t0 = std::chrono::steady_clock::now();
+    hierarchical.update(x0, y0, x0 + extent - 1, y0 + extent - 1);
+    double update = seconds(t0);
+
+    t0 = std::chrono::steady_clock::now();
+    HierarchicalPathFinder rebuilt(grid, clusterSize, HierarchicalPathFinder::Policy{ 0 });
+    double rebuild = seconds(t0);
+
+    std::printf("update of a %dx%d region: %.4f s, full rebuild: %.3f s\n", extent, extent, update, rebuild);
+    if (rebuilt.abstractGraph().size() != hierarchical.abstractGraph().size() ||
+        rebuilt.abstractGraph().edgeCount() != hierarchical.abstractGraph().edgeCount())
+    {
+        ++failures;
+    }
+
+    compare();
+
+    if (failures > 0)
+    {
+        std::printf("FAILED: %d invalid or missing paths\n", failures);
+        return 1;
+    }
+    return 0;
+}
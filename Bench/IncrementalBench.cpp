@@ -0,0 +1,136 @@
+// Simulates an agent walking to a goal across terrain while doors close on its path and open around it, replanning
+// after every change. Compares repairing the previous search (D* Lite) with searching from scratch (A*). The costs of
+// the repaired paths must match the costs found by A*.
+//
+// Usage: IncrementalBench [size] [changes] [steps between changes]
+
+#include "BenchCommon.h"
+
+#include "PathFinder/GridPathFinder.h"
+#include "PathFinder/IncrementalPathFinder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+int main(int argc, char ** argv)
+{
+    int size     = (argc > 1) ? std::atoi(argv[1]) : 512;
+    int nChanges = (argc > 2) ? std::atoi(argv[2]) : 200;
+    int nSteps   = (argc > 3) ? std::atoi(argv[3]) : 4;
+
+    // Terrain costs between 1 and 3, with 20% of the cells impassable. There are "doors": 4x4 blocks whose cost
+    // switches between their terrain cost and INFINITY.
+
+    std::mt19937 rng(1);
+    TerrainGrid terrain(size, rng);
+    GridGraph & grid = terrain.grid;
+    std::vector<float> const terrainCosts = terrain.costs;
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+
+    using Incremental = BasicIncrementalPathFinder<GridGraph, OctileHeuristic>;
+    Incremental incremental(grid, OctileHeuristic{ grid.minimumCostScale() });
+    GridPathFinder astar(grid, GridPathFinder::Policy{ 0 });
+
+    auto randomCell = [&] (int x0, int y0, int x1, int y1) {
+        std::uniform_int_distribution<int> x(x0, x1);
+        std::uniform_int_distribution<int> y(y0, y1);
+        for (;;)
+        {
+            int cx = x(rng);
+            int cy = y(rng);
+            if (grid.passable(cx, cy))
+                return grid.cell(cx, cy);
+        }
+    };
+
+    uint32_t start = randomCell(0, 0, size / 8, size / 8);
+    uint32_t goal  = randomCell(size - 1 - size / 8, size - 1 - size / 8, size - 1, size - 1);
+
+    Incremental::Path path;
+    GridPathFinder::Path reference;
+    GridPathFinder::Context context;
+
+    auto t0 = std::chrono::steady_clock::now();
+    incremental.reset(start, goal);
+    incremental.findPath(&path);
+    double initial = seconds(t0);
+    uint32_t initialExpansions = incremental.expansions();
+
+    double incrementalTime = 0.0;
+    double astarTime = 0.0;
+    double incrementalExpansions = 0.0;
+    double astarExpansions = 0.0;
+    int mismatches = 0;
+    int replans = 0;
+    std::vector<Incremental::EdgeChange> changes;
+
+    for (int c = 0; c < nChanges && start != goal; ++c)
+    {
+        // Walk a few steps along the path
+        if (path.size() > 1)
+        {
+            start = path[std::min<size_t>(nSteps, path.size() - 1)];
+            incremental.moveStart(start);
+        }
+
+        // Close a door on the path ahead of the agent, or open one near it. Every edge into or out of a changed cell
+        // changes.
+        bool close = uniform(rng) < 0.7f;
+        int dx = grid.x(start) + std::uniform_int_distribution<int>(-16, 16)(rng);
+        int dy = grid.y(start) + std::uniform_int_distribution<int>(-16, 16)(rng);
+        if (close && path.size() > 8)
+        {
+            uint32_t ahead = path[std::uniform_int_distribution<size_t>(4, std::min<size_t>(path.size() - 4, 64))(rng)];
+            dx = grid.x(ahead) - 2;
+            dy = grid.y(ahead) - 2;
+        }
+        changes.clear();
+        for (int y = dy; y < dy + 4; ++y)
+        {
+            for (int x = dx; x < dx + 4; ++x)
+            {
+                if (!grid.passable(x, y) || grid.cell(x, y) == start || grid.cell(x, y) == goal)
+                    continue;
+
+                uint32_t cell = grid.cell(x, y);
+                terrain.costs[cell] = close ? INFINITY : terrainCosts[cell];
+                grid.forEachEdge(cell, [&] (uint32_t neighbor, float) {
+                    changes.push_back({ cell, neighbor });
+                    changes.push_back({ neighbor, cell });
+                });
+            }
+        }
+
+        t0 = std::chrono::steady_clock::now();
+        incremental.updateEdges(changes);
+        bool found = incremental.findPath(&path);
+        incrementalTime += seconds(t0);
+        incrementalExpansions += incremental.expansions();
+
+        t0 = std::chrono::steady_clock::now();
+        bool referenceFound = astar.findPath(context, start, goal, &reference);
+        astarTime += seconds(t0);
+        astarExpansions += context.expansions();
+
+        float referenceCost = referenceFound ? context.g(goal) : INFINITY;
+        if (found != std::isfinite(referenceCost) || (found && !same(incremental.cost(), referenceCost)))
+            ++mismatches;
+        ++replans;
+
+        if (!found)
+            path.clear();
+    }
+
+    std::printf("%dx%d grid, initial search %.3f ms, %u expansions\n", size, size, 1000.0 * initial, initialExpansions);
+    std::printf("%-16s %12s %12s\n", "replanning", "ms/replan", "expansions");
+    std::printf("%-16s %12.3f %12.0f\n", "A* from scratch", 1000.0 * astarTime / replans, astarExpansions / replans);
+    std::printf("%-16s %12.3f %12.0f\n", "D* Lite", 1000.0 * incrementalTime / replans, incrementalExpansions / replans);
+    std::printf("%d replans, %d cost mismatches\n", replans, mismatches);
+
+    return (mismatches > 0) ? 1 : 0;
+}
@@ -0,0 +1,193 @@
+// Compares JPS and JPS+ with A* on uniform-cost grids. Every path found by JPS must have the same cost as the path found
+// by A*, and the benchmark fails if it does not.
+//
+// Usage: JumpPointSearchBench [size] [queries] [seed]
+
+#include "PathFinder/GridPathFinder.h"
+#include "PathFinder/JumpPointSearch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // Generates a grid with randomly placed rectangular obstacles, plus a sprinkling of single blocked cells
+    std::vector<uint8_t> generate(int size, unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> coordinate(0, size - 1);
+        std::uniform_int_distribution<int> extent(1, std::max(2, size / 32));
+        std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+
+        std::vector<uint8_t> passable(size * size, 1);
+        for (int r = 0; r < size * size / 2048; ++r)
+        {
+            int x0 = coordinate(rng);
+            int y0 = coordinate(rng);
+            int w  = extent(rng);
+            int h  = extent(rng);
+            for (int y = y0; y < std::min(size, y0 + h); ++y)
+            {
+                for (int x = x0; x < std::min(size, x0 + w); ++x)
+                {
+                    passable[y * size + x] = 0;
+                }
+            }
+        }
+        for (auto & p : passable)
+        {
+            if (uniform(rng) < 0.005f)
+                p = 0;
+        }
+        return passable;
+    }
+
+    struct Result
+    {
+        double seconds  = 0.0;
+        long expansions = 0;
+        int found       = 0;
+        std::vector<float> costs;
+    };
+
+    // Returns true if the path is a connected sequence of legal steps whose cost is the given cost
+    bool validate(GridGraph const & grid, std::vector<uint32_t> const & path, float cost)
+    {
+        float total = 0.0f;
+        for (size_t i = 1; i < path.size(); ++i)
+        {
+            float step = -1.0f;
+            grid.forEachEdge(path[i - 1], [&] (uint32_t to, float c) {
+                if (to == path[i])
+                    step = c;
+            });
+            if (step < 0.0f)
+                return false;
+            total += step;
+        }
+        return std::fabs(total - cost) <= 1e-3f * std::max(1.0f, cost);
+    }
+
+    // Runs the queries using the given search function
+    template <typename Search>
+    Result run(GridGraph const & grid, std::vector<std::pair<uint32_t, uint32_t>> const & queries, Search && search, int * invalid)
+    {
+        SearchContext context;
+        std::vector<uint32_t> path;
+        Result result;
+
+        for (auto const & q : queries)
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            bool found = search(context, q.first, q.second, &path);
+            auto t1 = std::chrono::steady_clock::now();
+            result.seconds += std::chrono::duration<double>(t1 - t0).count();
+
+            for (uint32_t i = 0; i < grid.size(); ++i)
+            {
+                if (context.isClosed(i))
+                    ++result.expansions;
+            }
+
+            float cost = found ? context.g(q.second) : INFINITY;
+            if (found)
+            {
+                ++result.found;
+                if (!validate(grid, path, cost))
+                    ++*invalid;
+            }
+            result.costs.push_back(cost);
+        }
+        return result;
+    }
+
+    void print(char const * name, Result const & r, int mismatches)
+    {
+        std::printf("%-8s %12ld %10.3f %14.1f %8d %10d\n",
+                    name,
+                    r.expansions,
+                    r.seconds,
+                    r.seconds * 1e6 / r.costs.size(),
+                    r.found,
+                    mismatches);
+    }
+
+    // Returns the number of queries whose cost differs from the reference
+    int compare(Result const & reference, Result const & r)
+    {
+        int mismatches = 0;
+        for (size_t i = 0; i < reference.costs.size(); ++i)
+        {
+            float a = reference.costs[i];
+            float b = r.costs[i];
+            if (std::isinf(a) != std::isinf(b) || (!std::isinf(a) && std::fabs(a - b) > 1e-3f * std::max(1.0f, a)))
+                ++mismatches;
+        }
+        return mismatches;
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    int size      = (argc > 1) ? std::atoi(argv[1]) : 512;
+    int nQueries  = (argc > 2) ? std::atoi(argv[2]) : 100;
+    unsigned seed = (argc > 3) ? (unsigned)std::atoi(argv[3]) : 1u;
+
+    std::vector<uint8_t> passable = generate(size, seed);
+    GridGraph grid(size, size, passable.data());
+
+    std::mt19937 rng(seed + 1);
+    std::uniform_int_distribution<uint32_t> cell(0, grid.size() - 1);
+    std::vector<std::pair<uint32_t, uint32_t>> queries;
+    while ((int)queries.size() < nQueries)
+    {
+        uint32_t from = cell(rng);
+        uint32_t to   = cell(rng);
+        if (passable[from] && passable[to])
+            queries.emplace_back(from, to);
+    }
+
+    GridPathFinder aStar(grid, GridPathFinder::Policy{ 0 });
+    JumpPointSearch jps(grid, JumpPointSearch::Mode::JPS);
+
+    auto t0 = std::chrono::steady_clock::now();
+    JumpPointSearch jpsPlus(grid, JumpPointSearch::Mode::JPS_PLUS);
+    auto t1 = std::chrono::steady_clock::now();
+
+    std::printf("%dx%d grid, %d queries, JPS+ precomputation: %.3f s\n",
+                size,
+                size,
+                nQueries,
+                std::chrono::duration<double>(t1 - t0).count());
+    std::printf("%-8s %12s %10s %14s %8s %10s\n", "search", "expansions", "seconds", "us/query", "found", "mismatches");
+
+    int invalid = 0;
+    Result reference = run(grid, queries, [&] (SearchContext & context, uint32_t from, uint32_t to, std::vector<uint32_t> * path) {
+        return aStar.findPath(context, from, to, path);
+    }, &invalid);
+    print("A*", reference, 0);
+
+    Result r = run(grid, queries, [&] (SearchContext & context, uint32_t from, uint32_t to, std::vector<uint32_t> * path) {
+        return jps.findPath(context, from, to, path);
+    }, &invalid);
+    int mismatches = compare(reference, r);
+    print("JPS", r, mismatches);
+
+    r = run(grid, queries, [&] (SearchContext & context, uint32_t from, uint32_t to, std::vector<uint32_t> * path) {
+        return jpsPlus.findPath(context, from, to, path);
+    }, &invalid);
+    mismatches += compare(reference, r);
+    print("JPS+", r, compare(reference, r));
+
+    if (mismatches > 0 || invalid > 0)
+    {
+        std::printf("FAILED: %d cost mismatches, %d invalid paths\n", mismatches, invalid);
+        return 1;
+    }
+    return 0;
+}
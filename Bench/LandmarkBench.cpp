@@ -0,0 +1,176 @@
+// Compares the landmark heuristic with a geometric heuristic provided by the nodes, on a graph of user-defined nodes
+// where the geometric estimate is poor: terrain whose costs vary by a factor of 8, divided into rooms by walls.
+// Reports the preprocessing time and size of the landmark tables, and the reduction in expansions. The costs of the
+// paths must match.
+//
+// Usage: LandmarkBench [size] [landmarks] [queries]
+
+#include "BenchCommon.h"
+
+#include "PathFinder/Landmarks.h"
+#include "PathFinder/PathFinder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // A terrain cell. Its heuristic is the straight-line distance at the cheapest terrain cost.
+    class Cell : public PathFinder::Node
+    {
+public:
+        float h(PathFinder::Node const & goal) const override
+        {
+            Cell const & g = static_cast<Cell const &>(goal);
+            return std::hypot(g.x - x, g.y - y);
+        }
+
+        float x = 0.0f;
+        float y = 0.0f;
+    };
+
+    struct Result
+    {
+        double seconds = 0.0;
+        double expansions = 0.0;
+        int mismatches = 0;
+    };
+
+    // Runs the queries, counting the expansions and comparing the costs with the reference costs, if there are any
+    template <typename Finder>
+    Result run(Finder const & finder,
+               std::vector<std::pair<PathFinder::Node *, PathFinder::Node *>> const & queries,
+               std::vector<float> * costs)
+    {
+        Result result;
+        SearchContext context;
+        PathFinder::Path path;
+        bool const reference = costs->empty();
+        for (size_t i = 0; i < queries.size(); ++i)
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            bool found = finder.findPath(context, queries[i].first, queries[i].second, &path);
+            result.seconds += seconds(t0);
+            result.expansions += context.expansions() + (context.hasBackward() ? context.backward().expansions() : 0);
+
+            float cost = found ? context.g(queries[i].second->index()) : INFINITY;
+            if (reference)
+                costs->push_back(cost);
+            else if (!same(cost, (*costs)[i]))
+                ++result.mismatches;
+        }
+        return result;
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    int size       = (argc > 1) ? std::atoi(argv[1]) : 256;
+    int nLandmarks = (argc > 2) ? std::atoi(argv[2]) : 16;
+    int nQueries   = (argc > 3) ? std::atoi(argv[3]) : 200;
+
+    // Terrain costs between 1 and 8 per unit of distance, divided into rooms by walls with a door in each side
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    std::vector<float> terrain(size * size);
+    std::vector<bool> wall(size * size);
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            float n = 0.5f + 0.25f * std::sin(x * 0.09f + 1.0f) + 0.25f * std::cos(y * 0.13f) * std::sin(x * 0.03f);
+            terrain[y * size + x] = 1.0f + 6.5f * std::min(1.0f, std::max(0.0f, n)) + 0.5f * uniform(rng);
+            wall[y * size + x]    = ((x % 32 == 16 && y % 32 != 0) || (y % 32 == 16 && x % 32 != 0));
+        }
+    }
+
+    std::vector<Cell> cells(size * size);
+    std::vector<std::unique_ptr<PathFinder::Edge>> edges;
+    PathFinder::NodeList domain;
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            Cell & cell = cells[y * size + x];
+            cell.x = (float)x;
+            cell.y = (float)y;
+            domain.push_back(&cell);
+            if (wall[y * size + x])
+                continue;
+
+            for (int dy = -1; dy <= 1; ++dy)
+            {
+                for (int dx = -1; dx <= 1; ++dx)
+                {
+                    int nx = x + dx;
+                    int ny = y + dy;
+                    if ((dx == 0 && dy == 0) || nx < 0 || ny < 0 || nx >= size || ny >= size || wall[ny * size + nx])
+                        continue;
+
+                    auto edge = std::make_unique<PathFinder::Edge>();
+                    edge->to   = &cells[ny * size + nx];
+                    edge->cost = std::hypot((float)dx, (float)dy) * 0.5f * (terrain[y * size + x] + terrain[ny * size + nx]);
+                    cell.adjacencies.push_back(edge.get());
+                    edges.push_back(std::move(edge));
+                }
+            }
+        }
+    }
+
+    std::uniform_int_distribution<int> coordinate(0, size * size - 1);
+    std::vector<std::pair<PathFinder::Node *, PathFinder::Node *>> queries;
+    while ((int)queries.size() < nQueries)
+    {
+        int a = coordinate(rng);
+        int b = coordinate(rng);
+        if (!wall[a] && !wall[b])
+            queries.emplace_back(&cells[a], &cells[b]);
+    }
+
+    std::printf("%d nodes, %zu edges, %d landmarks\n", size * size, edges.size(), nLandmarks);
+
+    PathFinder::Policy policy{ 0 };
+    PathFinder user(&domain, policy);
+    std::vector<float> costs;
+    Result baseline = run(user, queries, &costs);
+
+    std::printf("%-24s %12s %12s %12s %12s %10s\n", "heuristic", "build s", "table MB", "expansions", "ms/query", "reduction");
+    std::printf("%-24s %12s %12s %12.0f %12.3f %10s\n", "node h()", "-", "-",
+                baseline.expansions / nQueries, 1000.0 * baseline.seconds / nQueries, "-");
+
+    int failures = 0;
+    for (auto selection : { Landmarks::Selection::FARTHEST, Landmarks::Selection::AVOID })
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        Landmarks landmarks(NodeGraph(&domain), (uint32_t)nLandmarks, selection);
+        double build = seconds(t0);
+
+        for (bool bidirectional : { false, true })
+        {
+            PathFinder::Policy landmarkPolicy = policy;
+            landmarkPolicy.bidirectional = bidirectional;
+            LandmarkPathFinder finder(NodeGraph(&domain), landmarkPolicy, LandmarkHeuristic{ &landmarks });
+            Result result = run(finder, queries, &costs);
+            failures += result.mismatches;
+
+            char name[64];
+            std::snprintf(name, sizeof(name), "%s%s", (selection == Landmarks::Selection::AVOID) ? "avoid" : "farthest",
+                          bidirectional ? " (bidirectional)" : "");
+            std::printf("%-24s %12.2f %12.1f %12.0f %12.3f %9.1f%%", name, build, landmarks.memoryUsage() / 1048576.0,
+                        result.expansions / nQueries, 1000.0 * result.seconds / nQueries,
+                        100.0 * (1.0 - result.expansions / baseline.expansions));
+            if (result.mismatches > 0)
+                std::printf("  FAILED: %d cost mismatches", result.mismatches);
+            std::printf("\n");
+        }
+    }
+
+    return (failures > 0) ? 1 : 0;
+}
@@ -0,0 +1,139 @@
+// Runs a scenario of the MovingAI pathfinding benchmarks with A*, bidirectional A*, JPS and JPS+, and reports the time
+// taken by each bucket of the scenario. The cost of each path must be the scenario's optimal length, within the given
+// relative tolerance. The map is the one named by the scenario, in the scenario's directory, unless one is given.
+//
+// Usage: MovingAiBench <scenario> [map] [tolerance]
+
+#include "BenchCommon.h"
+
+#include "PathFinder/GridPathFinder.h"
+#include "PathFinder/JumpPointSearch.h"
+#include "PathFinder/MovingAi.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Returns the path of a file named by a scenario, which is relative to the scenario's directory
+    std::string resolve(std::string const & scenario, std::string const & name)
+    {
+        std::string const file = name.substr(name.find_last_of("/\\") + 1);
+        size_t const slash = scenario.find_last_of("/\\");
+        return (slash == std::string::npos) ? file : scenario.substr(0, slash + 1) + file;
+    }
+
+    // The measurements of a bucket
+    struct Bucket
+    {
+        int queries     = 0;
+        int failures    = 0;    // Paths not found or not optimal
+        double time     = 0.0;  // Seconds
+        double maxError = 0.0;  // Largest relative difference from the optimal length
+    };
+
+    // Runs every experiment of a scenario and returns the number of failures
+    template <typename PathFinder>
+    int run(PathFinder const & pathFinder, char const * name, GridGraph const & grid,
+            MovingAiScenario const & scenario, double tolerance)
+    {
+        std::map<int, Bucket> buckets;
+        typename PathFinder::Context context;
+        typename PathFinder::Path path;
+        for (MovingAiScenario::Experiment const & e : scenario.experiments)
+        {
+            uint32_t const start = grid.cell(e.startX, e.startY);
+            uint32_t const goal  = grid.cell(e.goalX, e.goalY);
+            auto t0 = std::chrono::steady_clock::now();
+            bool found = pathFinder.findPath(context, start, goal, &path);
+            double time = seconds(t0);
+
+            Bucket & bucket = buckets[e.bucket];
+            double const error = found ? std::fabs(context.g(goal) - e.optimal) / std::max(1.0, e.optimal) : INFINITY;
+            ++bucket.queries;
+            bucket.time += time;
+            bucket.maxError = std::max(bucket.maxError, error);
+            if (!(error <= tolerance))
+                ++bucket.failures;
+        }
+
+        int failures = 0;
+        Bucket total;
+        for (auto const & entry : buckets)
+        {
+            Bucket const & bucket = entry.second;
+            std::printf("%-14s %6d %8d %10.3f %10.2f %12.2e %8d\n", name, entry.first, bucket.queries,
+                        1000.0 * bucket.time, 1e6 * bucket.time / bucket.queries, bucket.maxError, bucket.failures);
+            total.queries += bucket.queries;
+            total.time    += bucket.time;
+            failures      += bucket.failures;
+        }
+        std::printf("%-14s %6s %8d %10.3f %10.2f %12s %8d\n", name, "all", total.queries, 1000.0 * total.time,
+                    1e6 * total.time / std::max(1, total.queries), "", failures);
+        return failures;
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "Usage: MovingAiBench <scenario> [map] [tolerance]\n");
+        return 1;
+    }
+    char const * scenarioPath = argv[1];
+    double tolerance          = (argc > 3) ? std::atof(argv[3]) : 1e-4;
+
+    MovingAiScenario scenario;
+    if (!scenario.load(scenarioPath) || scenario.experiments.empty())
+    {
+        std::fprintf(stderr, "Unable to load %s\n", scenarioPath);
+        return 1;
+    }
+    std::string const mapPath = (argc > 2) ? argv[2] : resolve(scenarioPath, scenario.experiments.front().map);
+    MovingAiMap map;
+    if (!map.load(mapPath.c_str()))
+    {
+        std::fprintf(stderr, "Unable to load %s\n", mapPath.c_str());
+        return 1;
+    }
+
+    // Every experiment must be on this map
+    GridGraph grid = map.graph();
+    for (MovingAiScenario::Experiment const & e : scenario.experiments)
+    {
+        if (e.mapWidth != map.width || e.mapHeight != map.height || !grid.passable(e.startX, e.startY) ||
+            !grid.passable(e.goalX, e.goalY))
+        {
+            std::fprintf(stderr, "Experiment in bucket %d does not fit %s\n", e.bucket, mapPath.c_str());
+            return 1;
+        }
+    }
+
+    GridPathFinder astar(grid, GridPathFinder::Policy{ 0 });
+    GridPathFinder bidirectional(grid, GridPathFinder::Policy{ 0, SearchPolicy::OpenList::INDEXED_HEAP, true });
+    JumpPointSearch jps(grid, JumpPointSearch::Mode::JPS);
+    JumpPointSearch jpsPlus(grid, JumpPointSearch::Mode::JPS_PLUS);
+    jpsPlus.precompute();
+
+    std::printf("%s: %dx%d, %zu experiments, tolerance %g\n", mapPath.c_str(), map.width, map.height,
+                scenario.experiments.size(), tolerance);
+    std::printf("%-14s %6s %8s %10s %10s %12s %8s\n", "search", "bucket", "queries", "total ms", "us/query",
+                "max error", "failures");
+
+    int failures = 0;
+    failures += run(astar, "astar", grid, scenario, tolerance);
+    failures += run(bidirectional, "bidirectional", grid, scenario, tolerance);
+    failures += run(jps, "jps", grid, scenario, tolerance);
+    failures += run(jpsPlus, "jps+", grid, scenario, tolerance);
+
+    std::printf("%d failures\n", failures);
+
+    return (failures > 0) ? 1 : 0;
+}
@@ -0,0 +1,367 @@
+// Compares the open list implementations, the node, compact and implicit grid graph representations, and
+// unidirectional and bidirectional searches, by measuring node expansions per second on large 8-connected grids.
+// The bucket queues quantize the costs, so their total cost is the sum of the rounded costs of the paths they found.
+// Before the searches, a randomized check compares every element removed from a bucket queue with the minimum and
+// maximum found by brute force, and the benchmark fails if they differ.
+//
+// Usage: OpenListBench [size] [queries] [seed]
+
+#include "PathFinder/CompactGraph.h"
+#include "PathFinder/GridPathFinder.h"
+#include "PathFinder/PathFinder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // A grid cell. The heuristic is the octile distance, which is admissible because no step is cheaper than its
+    // length.
+    class GridNode : public PathFinder::Node
+    {
+public:
+        float h(PathFinder::Node const & goal) const override
+        {
+            GridNode const & g = static_cast<GridNode const &>(goal);
+            float dx = std::fabs(float(x - g.x));
+            float dy = std::fabs(float(y - g.y));
+            return std::max(dx, dy) + (std::sqrt(2.0f) - 1.0f) * std::min(dx, dy);
+        }
+
+        int x;
+        int y;
+    };
+
+    // An 8-connected grid with rolling terrain. The cost of a step is its length scaled up by the change in height,
+    // which produces many cheaper routes to open nodes, and about 20% of the cells are impassable.
+    class Grid
+    {
+public:
+        Grid(int size, unsigned seed)
+            : size_(size)
+            , nodes_(size * size)
+            , edges_(size * size * 8)
+        {
+            std::mt19937 rng(seed);
+            std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+
+            heights_.resize(size * size);
+            passable_.resize(size * size);
+            for (int y = 0; y < size; ++y)
+            {
+                for (int x = 0; x < size; ++x)
+                {
+                    heights_[y * size + x]  = 4.0f * std::sin(x * 0.05f) * std::cos(y * 0.07f) + uniform(rng);
+                    passable_[y * size + x] = uniform(rng) >= 0.2f;
+                }
+            }
+
+            static int const DX[8] = { -1, 0, 1, -1, 1, -1, 0, 1 };
+            static int const DY[8] = { 1, 1, 1, 0, 0, -1, -1, -1 };
+
+            for (int y = 0; y < size; ++y)
+            {
+                for (int x = 0; x < size; ++x)
+                {
+                    int i = y * size + x;
+                    GridNode & node = nodes_[i];
+                    node.x = x;
+                    node.y = y;
+                    domain_.push_back(&node);
+                    if (!passable_[i])
+                        continue;
+
+                    node.adjacencies.reserve(8);
+                    for (int d = 0; d < 8; ++d)
+                    {
+                        int nx = x + DX[d];
+                        int ny = y + DY[d];
+                        if (nx < 0 || nx >= size || ny < 0 || ny >= size || !passable_[ny * size + nx])
+                            continue;
+                        PathFinder::Edge & edge = edges_[i * 8 + d];
+                        edge.to   = &nodes_[ny * size + nx];
+                        edge.cost = std::sqrt(float(DX[d] * DX[d] + DY[d] * DY[d])) *
+                                    (1.0f + std::fabs(heights_[ny * size + nx] - heights_[i]));
+                        node.adjacencies.push_back(&edge);
+                    }
+                }
+            }
+        }
+
+        PathFinder::NodeList * domain() { return &domain_; }
+        int size() const { return size_; }
+        GridNode * node(int i) { return &nodes_[i]; }
+
+        // Returns an equivalent grid graph, generating the same edges on the fly
+        GridGraph grid() const
+        {
+            return GridGraph(size_, size_, passable_.data()).setHeights(heights_.data(), 1.0f, 1.0f).setCutCorners(true);
+        }
+
+private:
+        int size_;
+        std::vector<float> heights_;
+        std::vector<uint8_t> passable_;
+        std::vector<GridNode> nodes_;
+        std::vector<PathFinder::Edge> edges_;
+        PathFinder::NodeList domain_;
+    };
+
+    struct Result
+    {
+        double seconds   = 0.0;
+        long expansions  = 0;
+        long backward    = 0;   // Expansions by the backward half of a bidirectional search
+        int found        = 0;
+        double totalCost = 0.0;
+    };
+
+    // The octile heuristic for a compact graph built from a grid, resolved at compile time
+    struct GridOctile
+    {
+        float operator ()(CompactGraph const &, uint32_t from, uint32_t goal) const
+        {
+            float dx = std::fabs(float(int(from % size) - int(goal % size)));
+            float dy = std::fabs(float(int(from / size) - int(goal / size)));
+            return std::max(dx, dy) + (std::sqrt(2.0f) - 1.0f) * std::min(dx, dy);
+        }
+
+        uint32_t size;
+    };
+
+    // Runs the queries using the given search function
+    template <typename Search>
+    Result run(std::vector<std::pair<int, int>> const & queries, Search && search)
+    {
+        PathFinder::Context context;
+        Result result;
+
+        for (auto const & q : queries)
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            bool found = search(context, q.first, q.second);
+            auto t1 = std::chrono::steady_clock::now();
+            result.seconds += std::chrono::duration<double>(t1 - t0).count();
+
+            result.expansions += context.expansions();
+            if (context.hasBackward())
+            {
+                result.expansions += context.backward().expansions();
+                result.backward   += context.backward().expansions();
+            }
+
+            if (found)
+            {
+                ++result.found;
+                result.totalCost += context.g((uint32_t)q.second);
+            }
+        }
+        return result;
+    }
+
+    // Priorities of the elements in the randomized check of BucketOpenList
+    struct CheckAccess
+    {
+        float priority(uint32_t i) const { return (*priorities)[i]; }
+        uint32_t handle(uint32_t i) const { return (*handles)[i]; }
+        void setHandle(uint32_t i, uint32_t handle) const { (*handles)[i] = handle; }
+        float resolution() const { return width; }
+
+        std::vector<float> * priorities;
+        std::vector<uint32_t> * handles;
+        float width;
+    };
+
+    // Pushes, decreases, pops and evicts at random as a monotone search would, with priorities that are multiples of
+    // the width plus rounding error. Returns the number of elements removed whose priorities are not the lowest (or the
+    // highest, when evicted) in the queue.
+    int checkBucketQueue(float width, int operations, unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> operation(0, 9);
+        std::uniform_int_distribution<int> steps(0, 40);
+        std::uniform_real_distribution<float> noise(-0.01f, 0.01f);
+
+        std::vector<float> priorities;
+        std::vector<uint32_t> handles;
+        std::vector<uint32_t> queued;
+        BucketOpenList<uint32_t, CheckAccess> open(CheckAccess{ &priorities, &handles, width });
+
+        int errors = 0;
+        long last = 0;  // Bucket of the last element removed, below which nothing may be pushed
+        auto quantized = [&] (long k) { return (float)(100.0 + (last + k) * width) + noise(rng) * width; };
+        auto bucket = [&] (float priority) { return std::lround((priority - 100.0) / width); };
+        auto remove = [&] (uint32_t key) { queued.erase(std::find(queued.begin(), queued.end(), key)); };
+
+        for (int n = 0; n < operations; ++n)
+        {
+            int const op = operation(rng);
+            if (queued.empty() || op < 4)
+            {
+                uint32_t key = (uint32_t)priorities.size();
+                priorities.push_back(quantized(steps(rng)));
+                handles.push_back(0);
+                queued.push_back(key);
+                open.push(key);
+            }
+            else if (op < 6)
+            {
+                uint32_t key = queued[std::uniform_int_distribution<size_t>(0, queued.size() - 1)(rng)];
+                long k = bucket(priorities[key]) - last;
+                if (k > 0)
+                {
+                    priorities[key] = quantized(std::uniform_int_distribution<long>(0, k - 1)(rng));
+                    open.decrease(key);
+                }
+            }
+            else if (op < 9)
+            {
+                auto lowest = std::min_element(queued.begin(), queued.end(),
+                                               [&] (uint32_t a, uint32_t b) { return priorities[a] < priorities[b]; });
+                uint32_t key = open.top();
+                open.pop();
+                if (bucket(priorities[key]) != bucket(priorities[*lowest]))
+                    ++errors;
+                last = std::max(last, bucket(priorities[key]));
+                remove(key);
+            }
+            else
+            {
+                auto highest = std::max_element(queued.begin(), queued.end(),
+                                                [&] (uint32_t a, uint32_t b) { return priorities[a] < priorities[b]; });
+                uint32_t key = open.evict();
+                if (bucket(priorities[key]) != bucket(priorities[*highest]))
+                    ++errors;
+                remove(key);
+            }
+            if (open.size() != queued.size())
+                ++errors;
+        }
+        return errors;
+    }
+
+    void print(char const * name, Result const & r)
+    {
+        std::printf("%-16s %12ld %12ld %10.3f %16.0f %8d %14.3f\n",
+                    name,
+                    r.expansions,
+                    r.backward,
+                    r.seconds,
+                    r.expansions / r.seconds,
+                    r.found,
+                    r.totalCost);
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    int size     = (argc > 1) ? std::atoi(argv[1]) : 1024;
+    int nQueries = (argc > 2) ? std::atoi(argv[2]) : 20;
+    unsigned seed = (argc > 3) ? (unsigned)std::atoi(argv[3]) : 1u;
+
+    // The bucket queue must remove the same priorities as a brute-force search, at any width
+    int errors = 0;
+    for (float width : { 1.0f, 0.1f, 0.01f })
+    {
+        errors += checkBucketQueue(width, 200000, seed);
+    }
+    std::printf("bucket queue check: %d errors\n", errors);
+
+    Grid grid(size, seed);
+
+    // Pick queries between passable cells that are far apart
+    std::mt19937 rng(seed + 1);
+    std::uniform_int_distribution<int> coordinate(0, size / 8);
+    std::vector<std::pair<int, int>> queries;
+    while ((int)queries.size() < nQueries)
+    {
+        int from = coordinate(rng) * size + coordinate(rng);
+        int to   = (size - 1 - coordinate(rng)) * size + (size - 1 - coordinate(rng));
+        if (!grid.node(from)->adjacencies.empty() && !grid.node(to)->adjacencies.empty())
+            queries.emplace_back(from, to);
+    }
+
+    CompactGraph compact(*grid.domain());
+
+    struct Backend
+    {
+        char const * name;
+        PathFinder::OpenList openList;
+        float resolution = 1.0f;
+    };
+    Backend const backends[] =
+    {
+        { "binary heap",  PathFinder::OpenList::BINARY_HEAP },
+        { "indexed heap", PathFinder::OpenList::INDEXED_HEAP },
+        { "pairing heap", PathFinder::OpenList::PAIRING_HEAP },
+        { "buckets 0.1",  PathFinder::OpenList::BUCKET_QUEUE, 0.1f },
+        { "buckets 0.01", PathFinder::OpenList::BUCKET_QUEUE, 0.01f },
+    };
+
+    std::printf("%dx%d grid, %d queries\n", size, size, nQueries);
+    std::printf("edges: %u, bytes per edge: %zu (nodes), %.1f (compact graph)\n",
+                compact.edgeCount(),
+                sizeof(PathFinder::Edge *) + sizeof(PathFinder::Edge),
+                double(compact.memoryUsage()) / compact.edgeCount());
+    std::printf("%-16s %12s %12s %10s %16s %8s %14s\n", "search", "expansions", "(backward)", "seconds", "expansions/s", "found", "total cost");
+
+    // Nodes with a virtual heuristic
+    for (auto const & backend : backends)
+    {
+        PathFinder pathFinder(grid.domain(), PathFinder::Policy{ 0, backend.openList, false, backend.resolution });
+        PathFinder::Path path;
+        print(backend.name, run(queries, [&] (PathFinder::Context & context, int from, int to) {
+            return pathFinder.findPath(context, grid.node(from), grid.node(to), &path);
+        }));
+    }
+
+    // Compact graph with the nodes' virtual heuristic
+    {
+        PathFinder pathFinder(grid.domain(), PathFinder::Policy{ 0 });
+        PathFinder::IndexPath path;
+        print("compact", run(queries, [&] (PathFinder::Context & context, int from, int to) {
+            return pathFinder.findPath(compact, context, (uint32_t)from, (uint32_t)to, &path);
+        }));
+    }
+
+    // Compact graph with a heuristic resolved at compile time
+    {
+        BasicPathFinder<CompactGraph, GridOctile> pathFinder(compact, PathFinder::Policy{ 0 }, GridOctile{ (uint32_t)size });
+        BasicPathFinder<CompactGraph, GridOctile>::Path path;
+        print("compact/inline h", run(queries, [&] (PathFinder::Context & context, int from, int to) {
+            return pathFinder.findPath(context, (uint32_t)from, (uint32_t)to, &path);
+        }));
+    }
+
+    // Implicit grid graph
+    {
+        GridPathFinder pathFinder(grid.grid(), PathFinder::Policy{ 0 });
+        GridPathFinder::Path path;
+        print("implicit grid", run(queries, [&] (PathFinder::Context & context, int from, int to) {
+            return pathFinder.findPath(context, (uint32_t)from, (uint32_t)to, &path);
+        }));
+    }
+
+    // Bidirectional searches
+    {
+        PathFinder pathFinder(grid.domain(), PathFinder::Policy{ 0, PathFinder::OpenList::INDEXED_HEAP, true });
+        PathFinder::Path path;
+        print("bidirectional", run(queries, [&] (PathFinder::Context & context, int from, int to) {
+            return pathFinder.findPath(context, grid.node(from), grid.node(to), &path);
+        }));
+    }
+    {
+        GridPathFinder pathFinder(grid.grid(), PathFinder::Policy{ 0, PathFinder::OpenList::INDEXED_HEAP, true });
+        GridPathFinder::Path path;
+        print("bidir. grid", run(queries, [&] (PathFinder::Context & context, int from, int to) {
+            return pathFinder.findPath(context, (uint32_t)from, (uint32_t)to, &path);
+        }));
+    }
+
+    return (errors > 0) ? 1 : 0;
+}
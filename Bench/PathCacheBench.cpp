@@ -0,0 +1,143 @@
+// Simulates agents leaving a few spawn points for a few objectives, each one replanning from its current position every
+// few steps, which is where a path cache pays off: the first agent's path answers the other agents' queries from the
+// same spawn point, and its suffixes answer the replanning queries. Halfway through, the terrain changes and the graph
+// version is incremented. The queries run on several threads sharing one cache. The costs of the cached paths must
+// match the costs found by A*.
+//
+// Usage: PathCacheBench [size] [agents] [cache MB] [threads]
+
+#include "BenchCommon.h"
+
+#include "PathFinder/GridPathFinder.h"
+#include "PathFinder/PathCache.h"
+#include "PathFinder/ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+int main(int argc, char ** argv)
+{
+    int size          = (argc > 1) ? std::atoi(argv[1]) : 512;
+    int nAgents       = (argc > 2) ? std::atoi(argv[2]) : 400;
+    int cacheMB       = (argc > 3) ? std::atoi(argv[3]) : 16;
+    unsigned nThreads = (argc > 4) ? (unsigned)std::atoi(argv[4]) : std::thread::hardware_concurrency();
+
+    int const nSpawns     = 8;
+    int const nObjectives = 4;
+    int const replanSteps = 16;
+
+    // Terrain costs between 1 and 3, with 10% of the cells impassable
+
+    std::mt19937 rng(1);
+    TerrainGrid terrain(size, rng, 0.1f);
+    GridGraph & grid = terrain.grid;
+    GridPathFinder pathFinder(grid, GridPathFinder::Policy{ 0 });
+
+    auto randomCell = [&] {
+        std::uniform_int_distribution<int> coordinate(0, size - 1);
+        for (;;)
+        {
+            int x = coordinate(rng);
+            int y = coordinate(rng);
+            if (grid.passable(x, y))
+                return grid.cell(x, y);
+        }
+    };
+
+    std::vector<uint32_t> spawns(nSpawns);
+    std::vector<uint32_t> objectives(nObjectives);
+    for (auto & s : spawns)
+        s = randomCell();
+    for (auto & o : objectives)
+        o = randomCell();
+
+    ThreadPool pool(nThreads);
+    PathCache cache((size_t)cacheMB << 20);
+    std::vector<GridPathFinder::Context> contexts(pool.size());
+    std::vector<GridPathFinder::Path> paths(pool.size());
+    double uncachedTime = 0.0;
+    double cachedTime = 0.0;
+    int nQueries = 0;
+    int mismatches = 0;
+
+    std::printf("%dx%d grid, %d agents, %d spawns, %d objectives, %d MB cache, %u threads\n", size, size, nAgents, nSpawns,
+                nObjectives, cacheMB, pool.size());
+
+    for (uint64_t version = 0; version < 2; ++version)
+    {
+        // Change the terrain for the second half
+        if (version > 0)
+        {
+            std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+            for (int i = 0; i < size * size; ++i)
+            {
+                terrain.costs[i] = 1.0f + 2.0f * uniform(rng);
+            }
+        }
+
+        // Each agent queries from its spawn point, then again every few steps along its path. The queries are made
+        // here from scratch, which gives the reference costs.
+
+        std::vector<GridPathFinder::Query> queries;
+        std::vector<float> references;
+        GridPathFinder::Context & context = contexts[0];
+        GridPathFinder::Path & path = paths[0];
+        for (int a = 0; a < nAgents / 2; ++a)
+        {
+            uint32_t const start = spawns[a % nSpawns];
+            uint32_t const goal  = objectives[(a / nSpawns) % nObjectives];
+            auto t0 = std::chrono::steady_clock::now();
+            bool found = pathFinder.findPath(context, start, goal, &path);
+            uncachedTime += seconds(t0);
+            queries.push_back({ start, goal });
+            references.push_back(found ? context.g(goal) : INFINITY);
+
+            GridPathFinder::Path route = path;
+            for (size_t step = replanSteps; step < route.size(); step += replanSteps)
+            {
+                t0 = std::chrono::steady_clock::now();
+                found = pathFinder.findPath(context, route[step], goal, &path);
+                uncachedTime += seconds(t0);
+                queries.push_back({ route[step], goal });
+                references.push_back(found ? context.g(goal) : INFINITY);
+            }
+        }
+
+        // The same queries through the cache, concurrently
+
+        std::vector<float> results(queries.size());
+        auto t0 = std::chrono::steady_clock::now();
+        pool.run((uint32_t)queries.size(), [&] (uint32_t i, unsigned worker) {
+            bool found = cache.findPath(pathFinder, contexts[worker], queries[i].start, queries[i].end, version, &paths[worker]);
+            results[i] = found ? pathCost(grid, paths[worker]) : INFINITY;
+        });
+        cachedTime += seconds(t0);
+
+        for (size_t i = 0; i < queries.size(); ++i)
+        {
+            if (!same(results[i], references[i]))
+                ++mismatches;
+        }
+        nQueries += (int)queries.size();
+    }
+
+    PathCache::Stats stats = cache.stats();
+    uint64_t lookups = stats.hits + stats.suffixHits + stats.misses;
+    std::printf("%-16s %12s %12s\n", "queries", "ms/query", "speedup");
+    std::printf("%-16s %12.3f %12.2f\n", "A*", 1000.0 * uncachedTime / nQueries, 1.0);
+    std::printf("%-16s %12.3f %12.2f\n", "cached A*", 1000.0 * cachedTime / nQueries, uncachedTime / cachedTime);
+    std::printf("%llu lookups: %.1f%% hits, %.1f%% suffix hits, %.1f%% misses\n", (unsigned long long)lookups,
+                100.0 * stats.hits / lookups, 100.0 * stats.suffixHits / lookups, 100.0 * stats.misses / lookups);
+    std::printf("%llu insertions, %llu stale, %llu evictions, %llu paths using %.2f MB\n",
+                (unsigned long long)stats.insertions, (unsigned long long)stats.stale, (unsigned long long)stats.evictions,
+                (unsigned long long)stats.paths, stats.bytes / 1048576.0);
+    std::printf("%d queries, %d cost mismatches\n", nQueries, mismatches);
+
+    return (mismatches > 0) ? 1 : 0;
+}
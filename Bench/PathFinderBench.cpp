@@ -0,0 +1,356 @@
+// Benchmark suite of the search engine. Runs a fixed set of queries on synthetic grids (random obstacles, mazes and
+// open fields) at several sizes and on the height field of the test application, with A*, bidirectional A* and JPS+
+// (on the uniform grids). It prints a table and writes a JSON report with the throughput, the latency percentiles and
+// the peak memory of each run, so that reports from two builds can be compared. The maps and queries depend only on
+// the arguments, and the searches of a map must agree on the cost of each path.
+//
+// The peak memory is the resident set size of the process, which only grows, so it is the peak of all of the runs so
+// far. It is 0 where it is not available.
+//
+// Usage: PathFinderBench [queries] [max size] [image] [report]
+
+#include "BenchCommon.h"
+
+#include "PathFinder/BasicPathFinder.h"
+#include "PathFinder/GridPathFinder.h"
+#include "PathFinder/HeightFieldGraph.h"
+#include "PathFinder/JumpPointSearch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+    // Returns the number of queries whose costs differ
+    int mismatched(std::vector<float> const & a, std::vector<float> const & b)
+    {
+        int count = 0;
+        for (size_t q = 0; q < a.size(); ++q)
+        {
+            count += same(a[q], b[q]) ? 0 : 1;
+        }
+        return count;
+    }
+
+    // Returns the peak resident set size of the process in bytes, or 0 if it is not available
+    uint64_t peakMemory()
+    {
+#if defined(__APPLE__)
+        rusage usage;
+        return (getrusage(RUSAGE_SELF, &usage) == 0) ? (uint64_t)usage.ru_maxrss : 0;
+#elif defined(__unix__)
+        rusage usage;
+        return (getrusage(RUSAGE_SELF, &usage) == 0) ? (uint64_t)usage.ru_maxrss * 1024 : 0;
+#else
+        return 0;
+#endif
+    }
+
+    // Returns the value below which the given fraction of the sorted values lie (nearest rank)
+    double percentile(std::vector<double> const & sorted, double fraction)
+    {
+        if (sorted.empty())
+            return 0.0;
+        size_t rank = (size_t)std::ceil(fraction * sorted.size());
+        return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+    }
+
+    // A map: the passability of its cells and the queries to run on it
+    struct Map
+    {
+        std::string name;
+        int width  = 0;
+        int height = 0;
+        std::vector<uint8_t> passable;
+        std::vector<GridPathFinder::Query> queries;
+    };
+
+    // The measurements of one search of a map's queries
+    struct Run
+    {
+        std::string map;
+        std::string search;
+        int width          = 0;
+        int height         = 0;
+        size_t queries     = 0;
+        size_t found       = 0;
+        uint64_t expanded  = 0;
+        double time        = 0.0;           // Total time of the queries in seconds
+        double checksum    = 0.0;           // Sum of the costs of the paths found
+        std::vector<double> latencies;      // Time of each query in seconds, sorted
+        uint64_t memory    = 0;             // Peak memory after the run
+    };
+
+    // Cells blocked at random, in clumps of up to 4
+    std::vector<uint8_t> randomObstacles(int size, float density, std::mt19937 & rng)
+    {
+        std::uniform_int_distribution<int> neighbor(-1, 1);
+        std::vector<uint8_t> passable((size_t)size * size, 1);
+        size_t const blocked = (size_t)(density * size * size);
+        std::uniform_int_distribution<int> coordinate(0, size - 1);
+        for (size_t n = 0; n < blocked; n += 4)
+        {
+            int x = coordinate(rng);
+            int y = coordinate(rng);
+            for (int k = 0; k < 4; ++k)
+            {
+                passable[(size_t)y * size + x] = 0;
+                x = std::min(size - 1, std::max(0, x + neighbor(rng)));
+                y = std::min(size - 1, std::max(0, y + neighbor(rng)));
+            }
+        }
+        return passable;
+    }
+
+    // A perfect maze with corridors 1 cell wide, generated by a depth-first search of the odd cells
+    std::vector<uint8_t> maze(int size, std::mt19937 & rng)
+    {
+        std::vector<uint8_t> passable((size_t)size * size, 0);
+        int const rooms = (size - 1) / 2;
+        std::vector<uint32_t> stack;
+        stack.push_back(0);
+        passable[(size_t)1 * size + 1] = 1;
+        static int const DX[] = { 1, -1, 0, 0 };
+        static int const DY[] = { 0, 0, 1, -1 };
+        while (!stack.empty())
+        {
+            int const rx = (int)(stack.back() % rooms);
+            int const ry = (int)(stack.back() / rooms);
+            int choices[4];
+            int n = 0;
+            for (int d = 0; d < 4; ++d)
+            {
+                int const nx = rx + DX[d];
+                int const ny = ry + DY[d];
+                bool const inside = nx >= 0 && nx < rooms && ny >= 0 && ny < rooms;
+                if (inside && !passable[(size_t)(2 * ny + 1) * size + 2 * nx + 1])
+                    choices[n++] = d;
+            }
+            if (n == 0)
+            {
+                stack.pop_back();
+                continue;
+            }
+            int const d = choices[std::uniform_int_distribution<int>(0, n - 1)(rng)];
+            passable[(size_t)(2 * ry + 1 + DY[d]) * size + 2 * rx + 1 + DX[d]] = 1;
+            passable[(size_t)(2 * (ry + DY[d]) + 1) * size + 2 * (rx + DX[d]) + 1] = 1;
+            stack.push_back((uint32_t)((ry + DY[d]) * rooms + rx + DX[d]));
+        }
+        return passable;
+    }
+
+    // Chooses queries between random passable cells
+    void chooseQueries(Map & map, int count, std::mt19937 & rng)
+    {
+        std::uniform_int_distribution<uint32_t> cell(0, (uint32_t)(map.width * map.height - 1));
+        while ((int)map.queries.size() < count)
+        {
+            uint32_t start = cell(rng);
+            uint32_t goal  = cell(rng);
+            if (map.passable[start] && map.passable[goal])
+                map.queries.push_back({ start, goal });
+        }
+    }
+
+    // Runs a map's queries, after running a few of them to warm up, and records the cost of each path. The expansions
+    // of a bidirectional search include those of its backward half.
+    template <typename PathFinder>
+    Run run(PathFinder const & pathFinder, Map const & map, char const * search, bool bidirectional,
+            std::vector<float> & costs)
+    {
+        Run result;
+        result.map     = map.name;
+        result.search  = search;
+        result.width   = map.width;
+        result.height  = map.height;
+        result.queries = map.queries.size();
+
+        typename PathFinder::Context context;
+        typename PathFinder::Path path;
+        for (size_t q = 0; q < std::min<size_t>(map.queries.size(), 5); ++q)
+        {
+            pathFinder.findPath(context, map.queries[q].start, map.queries[q].end, &path);
+        }
+
+        costs.resize(map.queries.size());
+        result.latencies.reserve(map.queries.size());
+        for (size_t q = 0; q < map.queries.size(); ++q)
+        {
+            GridPathFinder::Query const & query = map.queries[q];
+            auto t0 = std::chrono::steady_clock::now();
+            bool found = pathFinder.findPath(context, query.start, query.end, &path);
+            double time = seconds(t0);
+            result.latencies.push_back(time);
+            result.time += time;
+            result.expanded += context.expansions() + (bidirectional ? context.backward().expansions() : 0);
+            costs[q] = found ? context.g(query.end) : INFINITY;
+            if (found)
+            {
+                ++result.found;
+                result.checksum += costs[q];
+            }
+        }
+        std::sort(result.latencies.begin(), result.latencies.end());
+        result.memory = peakMemory();
+        return result;
+    }
+
+    // Writes the runs as JSON
+    bool writeReport(char const * path, std::vector<Run> const & runs, int nQueries, int maxSize)
+    {
+        std::FILE * f = std::fopen(path, "w");
+        if (!f)
+            return false;
+        std::fprintf(f, "{\n  \"benchmark\": \"PathFinderBench\",\n  \"version\": 1,\n");
+        std::fprintf(f, "  \"queries\": %d,\n  \"maxSize\": %d,\n  \"stats\": %s,\n", nQueries, maxSize,
+                     SearchStats::ENABLED ? "true" : "false");
+        std::fprintf(f, "  \"peakMemoryBytes\": %llu,\n  \"runs\": [", (unsigned long long)peakMemory());
+        for (size_t r = 0; r < runs.size(); ++r)
+        {
+            Run const & run = runs[r];
+            double const time = std::max(run.time, 1e-9);
+            std::fprintf(f, "%s\n    {\n", (r > 0) ? "," : "");
+            std::fprintf(f, "      \"map\": \"%s\", \"search\": \"%s\", \"width\": %d, \"height\": %d,\n",
+                         run.map.c_str(), run.search.c_str(), run.width, run.height);
+            std::fprintf(f, "      \"queries\": %zu, \"found\": %zu, \"expanded\": %llu, \"seconds\": %.6f,\n",
+                         run.queries, run.found, (unsigned long long)run.expanded, run.time);
+            std::fprintf(f, "      \"queriesPerSecond\": %.1f, \"expansionsPerSecond\": %.1f,\n", run.queries / time,
+                         run.expanded / time);
+            std::fprintf(f, "      \"latencyMicroseconds\": { \"mean\": %.2f, \"p50\": %.2f, \"p90\": %.2f, "
+                            "\"p99\": %.2f, \"max\": %.2f },\n",
+                         1e6 * time / std::max<size_t>(run.queries, 1), 1e6 * percentile(run.latencies, 0.5),
+                         1e6 * percentile(run.latencies, 0.9), 1e6 * percentile(run.latencies, 0.99),
+                         1e6 * percentile(run.latencies, 1.0));
+            std::fprintf(f, "      \"costChecksum\": %.3f, \"peakMemoryBytes\": %llu\n    }", run.checksum,
+                         (unsigned long long)run.memory);
+        }
+        std::fprintf(f, "\n  ]\n}\n");
+        return std::fclose(f) == 0;
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    int nQueries        = (argc > 1) ? std::atoi(argv[1]) : 100;
+    int maxSize         = (argc > 2) ? std::atoi(argv[2]) : 1024;
+    char const * image  = (argc > 3) ? argv[3] : "Test/hf.tga";
+    char const * report = (argc > 4) ? argv[4] : "PathFinderBench.json";
+
+    std::vector<Run> runs;
+    int mismatches = 0;
+
+    std::printf("%d queries per map, maps up to %dx%d, statistics %s\n", nQueries, maxSize, maxSize,
+                SearchStats::ENABLED ? "enabled" : "disabled");
+    std::printf("%-12s %-14s %6s %8s %12s %10s %10s %10s %10s %8s\n", "map", "search", "size", "found", "exp/s",
+                "queries/s", "p50 us", "p99 us", "max us", "MB");
+    auto print = [] (Run const & run) {
+        double const time = std::max(run.time, 1e-9);
+        std::printf("%-12s %-14s %6d %8zu %12.0f %10.1f %10.1f %10.1f %10.1f %8.1f\n", run.map.c_str(),
+                    run.search.c_str(), run.width, run.found, run.expanded / time, run.queries / time,
+                    1e6 * percentile(run.latencies, 0.5), 1e6 * percentile(run.latencies, 0.99),
+                    1e6 * percentile(run.latencies, 1.0), run.memory / 1048576.0);
+    };
+
+    // Synthetic grids with uniform costs, on which every search must find the same costs
+
+    for (int size = 128; size <= maxSize; size *= 2)
+    {
+        for (char const * kind : { "random", "maze", "open" })
+        {
+            std::mt19937 rng((unsigned)size);
+            Map map;
+            map.name   = kind;
+            map.width  = size;
+            map.height = size;
+            if (map.name == "random")
+                map.passable = randomObstacles(size, 0.3f, rng);
+            else if (map.name == "maze")
+                map.passable = maze(size, rng);
+            else
+                map.passable.assign((size_t)size * size, 1);
+            chooseQueries(map, nQueries, rng);
+
+            GridGraph grid(size, size, map.passable.data());
+            grid.setCutCorners(false);
+            GridPathFinder astar(grid, GridPathFinder::Policy{ 0 });
+            GridPathFinder bidirectional(grid, GridPathFinder::Policy{ 0, SearchPolicy::OpenList::INDEXED_HEAP, true });
+            JumpPointSearch jps(grid, JumpPointSearch::Mode::JPS_PLUS);
+            jps.precompute();
+
+            std::vector<float> expected;
+            std::vector<float> costs;
+            runs.push_back(run(astar, map, "astar", false, expected));
+            print(runs.back());
+            runs.push_back(run(bidirectional, map, "bidirectional", true, costs));
+            print(runs.back());
+            mismatches += mismatched(costs, expected);
+            runs.push_back(run(jps, map, "jps+", false, costs));
+            print(runs.back());
+            mismatches += mismatched(costs, expected);
+        }
+    }
+
+    // The height field, with the settings of the test application
+
+    HeightMap heights;
+    if (heights.load(image, 32.0f))
+    {
+        HeightFieldBuilder::Settings settings;
+        settings.seaLevel   = 8.0f;
+        settings.uphill     = 1.0f;
+        settings.downhill   = 0.5f;
+        settings.cutCorners = true;
+        HeightFieldBuilder builder(heights.heights.data(), heights.width, heights.height, settings);
+        builder.build();
+        HeightFieldGraph graph = builder.graph();
+
+        std::mt19937 rng(1);
+        Map map;
+        map.name   = "heightfield";
+        map.width  = heights.width;
+        map.height = heights.height;
+        map.passable.resize(graph.size());
+        for (uint32_t i = 0; i < graph.size(); ++i)
+        {
+            map.passable[i] = heights.heights[i] >= settings.seaLevel;
+        }
+        chooseQueries(map, nQueries, rng);
+
+        using HeightFieldPathFinder = BasicPathFinder<HeightFieldGraph, OctileHeuristic>;
+        OctileHeuristic const heuristic{ graph.minimumCostScale() };
+        HeightFieldPathFinder astar(graph, SearchPolicy{ 0 }, heuristic);
+        HeightFieldPathFinder bidirectional(graph, SearchPolicy{ 0, SearchPolicy::OpenList::INDEXED_HEAP, true },
+                                            heuristic);
+
+        std::vector<float> expected;
+        std::vector<float> costs;
+        runs.push_back(run(astar, map, "astar", false, expected));
+        print(runs.back());
+        runs.push_back(run(bidirectional, map, "bidirectional", true, costs));
+        print(runs.back());
+        mismatches += mismatched(costs, expected);
+    }
+    else
+    {
+        std::fprintf(stderr, "Unable to load %s, skipping the height field\n", image);
+    }
+
+    if (!writeReport(report, runs, nQueries, maxSize))
+    {
+        std::fprintf(stderr, "Unable to write %s\n", report);
+        return 1;
+    }
+    std::printf("Report written to %s, %d cost mismatches\n", report, mismatches);
+
+    return (mismatches > 0) ? 1 : 0;
+}
@@ -0,0 +1,146 @@
+// Simulates a game in which agents request paths every frame, and compares running each search to completion in the
+// frame it is requested with running the searches in slices under a per-frame budget. Slicing caps the time spent in
+// each frame at the price of latency: the number of frames an agent waits for its path. The costs of the sliced
+// searches must match the costs found by A*.
+//
+// Usage: SlicedBench [size] [frames] [requests per frame] [expansions per frame]
+
+#include "BenchCommon.h"
+
+#include "PathFinder/GridPathFinder.h"
+#include "PathFinder/SlicedSearch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+int main(int argc, char ** argv)
+{
+    int size                = (argc > 1) ? std::atoi(argv[1]) : 512;
+    int nFrames             = (argc > 2) ? std::atoi(argv[2]) : 200;
+    int nRequests           = (argc > 3) ? std::atoi(argv[3]) : 2;
+    uint32_t frameBudget    = (argc > 4) ? (uint32_t)std::atoi(argv[4]) : 100000;
+
+    // Terrain costs between 1 and 3, with 20% of the cells impassable
+
+    std::mt19937 rng(1);
+    TerrainGrid terrain(size, rng);
+    GridGraph & grid = terrain.grid;
+    GridPathFinder pathFinder(grid, GridPathFinder::Policy{ 0 });
+
+    auto randomCell = [&] {
+        std::uniform_int_distribution<int> coordinate(0, size - 1);
+        for (;;)
+        {
+            int x = coordinate(rng);
+            int y = coordinate(rng);
+            if (grid.passable(x, y))
+                return grid.cell(x, y);
+        }
+    };
+
+    // The requests made in each frame, with their priorities
+
+    struct Request
+    {
+        uint32_t start;
+        uint32_t goal;
+        int priority;
+        int frame;
+    };
+    std::vector<Request> requests;
+    for (int f = 0; f < nFrames; ++f)
+    {
+        for (int r = 0; r < nRequests; ++r)
+        {
+            requests.push_back({ randomCell(), randomCell(), std::uniform_int_distribution<int>(0, 2)(rng), f });
+        }
+    }
+
+    // Complete each search in the frame it is requested
+
+    GridPathFinder::Context context;
+    GridPathFinder::Path path;
+    std::vector<float> references(requests.size());
+    double wholeTime = 0.0;
+    double wholeWorst = 0.0;
+    for (int f = 0, r = 0; f < nFrames; ++f)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        for (; r < (int)requests.size() && requests[r].frame == f; ++r)
+        {
+            bool found = pathFinder.findPath(context, requests[r].start, requests[r].goal, &path);
+            references[r] = found ? context.g(requests[r].goal) : INFINITY;
+        }
+        double t = seconds(t0);
+        wholeTime += t;
+        wholeWorst = std::max(wholeWorst, t);
+    }
+
+    // Slice the searches, under a budget of expansions per frame, then under a budget of time per frame equal to the
+    // average time per frame taken by the complete searches
+
+    using Search = BasicSlicedSearch<GridGraph, OctileHeuristic, EdgeCost>;
+    int mismatches = 0;
+
+    auto simulate = [&] (char const * name, bool timed) {
+        double const frameTime = wholeTime / nFrames;
+        std::vector<std::unique_ptr<Search>> searches(requests.size());
+        SearchScheduler<Search> scheduler;
+        double time = 0.0;
+        double worst = 0.0;
+        double latency = 0.0;
+        int maxLatency = 0;
+        int completed = 0;
+        int f = 0;
+        for (int r = 0; f < nFrames || !scheduler.empty(); ++f)
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            for (; r < (int)requests.size() && requests[r].frame == f; ++r)
+            {
+                searches[r] = std::make_unique<Search>(pathFinder, requests[r].start, requests[r].goal);
+                scheduler.add(searches[r].get(), requests[r].priority);
+            }
+            if (timed)
+                scheduler.run(t0 + std::chrono::duration_cast<Search::Clock::duration>(
+                    std::chrono::duration<double>(frameTime)));
+            else
+                scheduler.run(frameBudget);
+            double t = seconds(t0);
+            time += t;
+            worst = std::max(worst, t);
+
+            // Collect the searches that ended
+            for (int i = 0; i < r; ++i)
+            {
+                if (!searches[i] || searches[i]->status() == Search::Status::IN_PROGRESS)
+                    continue;
+                if (!same(searches[i]->cost(), references[i]))
+                    ++mismatches;
+                int frames = f - requests[i].frame;
+                latency += frames;
+                maxLatency = std::max(maxLatency, frames);
+                ++completed;
+                searches[i].reset();
+            }
+        }
+        std::printf("%-20s %10.3f %10.3f %10.2f %10d %8d\n", name, 1000.0 * time / f, 1000.0 * worst,
+                    latency / completed, maxLatency, f);
+    };
+
+    std::printf("%dx%d grid, %d frames, %d requests per frame, %u expansions per frame\n", size, size, nFrames,
+                nRequests, frameBudget);
+    std::printf("%-20s %10s %10s %10s %10s %8s\n", "searches", "ms/frame", "worst ms", "latency", "worst", "frames");
+    std::printf("%-20s %10.3f %10.3f %10.2f %10d %8d\n", "complete", 1000.0 * wholeTime / nFrames, 1000.0 * wholeWorst,
+                0.0, 0, nFrames);
+    simulate("sliced (expansions)", false);
+    simulate("sliced (time)", true);
+    std::printf("%d cost mismatches\n", mismatches);
+
+    return (mismatches > 0) ? 1 : 0;
+}
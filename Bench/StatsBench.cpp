@@ -0,0 +1,134 @@
+// Runs queries on a grid with several policies, one at a time and in batches on a pool, and prints the statistics
+// collected by the pathfinder. The statistics of each query must agree with its path and its context, and the
+// pathfinder's counters must add up to the statistics of the queries. If statistics are not enabled (see the
+// PathFinder_ENABLE_STATS option), they must all be 0. Compare the times with and without the option to measure the
+// cost of collecting them.
+//
+// Usage: StatsBench [size] [queries] [threads]
+
+#include "BenchCommon.h"
+
+#include "PathFinder/GridPathFinder.h"
+#include "PathFinder/ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+int main(int argc, char ** argv)
+{
+    int size          = (argc > 1) ? std::atoi(argv[1]) : 256;
+    int nQueries      = (argc > 2) ? std::atoi(argv[2]) : 200;
+    unsigned nThreads = (argc > 3) ? (unsigned)std::atoi(argv[3]) : std::thread::hardware_concurrency();
+
+    // Terrain costs between 1 and 3, with 20% of the cells impassable
+
+    std::mt19937 rng(1);
+    TerrainGrid terrain(size, rng);
+    GridGraph & grid = terrain.grid;
+
+    std::vector<GridPathFinder::Query> queries;
+    std::uniform_int_distribution<int> cell(0, size * size - 1);
+    while ((int)queries.size() < nQueries)
+    {
+        uint32_t start = cell(rng);
+        uint32_t goal  = cell(rng);
+        if (terrain.passable[start] && terrain.passable[goal])
+            queries.push_back({ start, goal });
+    }
+
+    struct Configuration
+    {
+        char const * name;
+        GridPathFinder::Policy policy;
+    };
+    Configuration const configurations[] = {
+        { "indexed heap",   { 0 } },
+        { "binary heap",    { 0, SearchPolicy::OpenList::BINARY_HEAP } },
+        { "bidirectional",  { 0, SearchPolicy::OpenList::INDEXED_HEAP, true } },
+        { "bounded",        { 512 } },
+    };
+
+    ThreadPool pool(nThreads);
+    int violations = 0;
+
+    std::printf("%dx%d grid, %d queries, %u threads, statistics %s\n", size, size, nQueries, pool.size(),
+                SearchStats::ENABLED ? "enabled" : "disabled");
+    std::printf("%-16s %8s %10s %10s %10s %10s %8s %10s %10s\n", "search", "found", "expanded", "opened", "updated",
+                "evicted", "peak", "us/query", "batch us");
+
+    for (Configuration const & configuration : configurations)
+    {
+        GridPathFinder pathFinder(grid, configuration.policy);
+        GridPathFinder::Context context;
+        GridPathFinder::Path path;
+
+        // One query at a time, checking the statistics of each
+
+        SearchStats sum;
+        uint64_t found = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (GridPathFinder::Query const & query : queries)
+        {
+            bool ok = pathFinder.findPath(context, query.start, query.end, &path);
+            SearchStats const & stats = context.stats();
+            uint32_t expansions = context.expansions();
+            if (configuration.policy.bidirectional)
+                expansions += context.backward().expansions();
+
+            if (SearchStats::ENABLED)
+            {
+                if (stats.expanded != expansions || stats.pathLength != (ok ? path.size() : 0) ||
+                    !same(stats.cost, ok ? context.g(query.end) : INFINITY) || stats.peakOpen == 0 ||
+                    (configuration.policy.maxNodes > 0 && stats.peakOpen > (uint32_t)configuration.policy.maxNodes))
+                {
+                    ++violations;
+                }
+            }
+            else if (stats.expanded != 0 || stats.opened != 0 || stats.pathLength != 0 || stats.seconds != 0.0)
+            {
+                ++violations;
+            }
+            uint32_t const peakOpen = std::max(sum.peakOpen, stats.peakOpen);
+            sum.merge(stats);
+            sum.peakOpen = peakOpen;
+            found += ok ? 1 : 0;
+        }
+        double time = seconds(t0);
+
+        SearchCounters::Totals const totals = pathFinder.counters().totals();
+        uint64_t const expected = SearchStats::ENABLED ? queries.size() : 0;
+        if (totals.queries != expected || totals.found != (SearchStats::ENABLED ? found : 0) ||
+            totals.expanded != sum.expanded || totals.opened != sum.opened || totals.updated != sum.updated ||
+            totals.evicted != sum.evicted || totals.peakOpen != sum.peakOpen)
+        {
+            ++violations;
+        }
+
+        // In batches, with every worker adding to the same counters
+
+        pathFinder.counters().reset();
+        std::vector<GridPathFinder::Result> results(queries.size());
+        t0 = std::chrono::steady_clock::now();
+        pathFinder.findPaths(pool, queries, results);
+        double batchTime = seconds(t0);
+
+        SearchCounters::Totals const batch = pathFinder.counters().totals();
+        if (batch.queries != totals.queries || batch.found != totals.found || batch.expanded != totals.expanded)
+            ++violations;
+
+        double const n = (double)queries.size();
+        std::printf("%-16s %8llu %10.1f %10.1f %10.1f %10.1f %8u %10.2f %10.2f\n", configuration.name,
+                    (unsigned long long)found, sum.expanded / n, sum.opened / n, sum.updated / n, sum.evicted / n,
+                    sum.peakOpen, 1e6 * time / n, 1e6 * batchTime / n);
+    }
+
+    std::printf("%d violations\n", violations);
+
+    return (violations > 0) ? 1 : 0;
+}
@@ -0,0 +1,160 @@
+// Runs the same queries on a grid with a context, which creates an open list for each search, and with a workspace,
+// which reuses its open lists, for each open list implementation and for bidirectional and memory-bounded searches.
+// The allocations are counted by replacing the global operator new. Once the workspace has run the queries, running
+// them again must not allocate, whether the paths are written into a buffer or into a vector with enough capacity,
+// and the paths must match those found with the context.
+//
+// Usage: WorkspaceBench [size] [queries]
+
+#include "BenchCommon.h"
+
+#include "PathFinder/GridPathFinder.h"
+#include "PathFinder/SearchWorkspace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+namespace
+{
+    size_t s_allocations = 0;   // Number of calls to operator new
+}
+
+void * operator new(size_t size)
+{
+    ++s_allocations;
+    if (void * p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void * p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void * p, size_t) noexcept
+{
+    std::free(p);
+}
+
+int main(int argc, char ** argv)
+{
+    int size     = (argc > 1) ? std::atoi(argv[1]) : 256;
+    int nQueries = (argc > 2) ? std::atoi(argv[2]) : 200;
+
+    // Integer terrain costs between 1 and 3, with 20% of the cells impassable
+
+    std::mt19937 rng(1);
+    TerrainGrid terrain(size, rng, 0.2f, true);
+    GridGraph & grid = terrain.grid;
+
+    struct Query
+    {
+        uint32_t start;
+        uint32_t goal;
+    };
+    std::vector<Query> queries;
+    std::uniform_int_distribution<int> cell(0, size * size - 1);
+    while ((int)queries.size() < nQueries)
+    {
+        uint32_t start = cell(rng);
+        uint32_t goal  = cell(rng);
+        if (terrain.passable[start] && terrain.passable[goal])
+            queries.push_back({ start, goal });
+    }
+
+    struct Configuration
+    {
+        char const * name;
+        GridPathFinder::Policy policy;
+    };
+    Configuration const configurations[] = {
+        { "binary heap",    { 0, SearchPolicy::OpenList::BINARY_HEAP } },
+        { "indexed heap",   { 0, SearchPolicy::OpenList::INDEXED_HEAP } },
+        { "pairing heap",   { 0, SearchPolicy::OpenList::PAIRING_HEAP } },
+        { "bucket queue",   { 0, SearchPolicy::OpenList::BUCKET_QUEUE } },
+        { "bidirectional",  { 0, SearchPolicy::OpenList::INDEXED_HEAP, true } },
+        { "bidi buckets",   { 0, SearchPolicy::OpenList::BUCKET_QUEUE, true } },
+        { "bounded",        { 4096 } },
+    };
+
+    int mismatches = 0;
+    size_t leaks   = 0;
+
+    std::printf("%dx%d grid, %d queries\n", size, size, nQueries);
+    std::printf("%-16s %12s %12s %12s %12s %12s\n", "search", "context us", "allocs", "workspace us", "buffer",
+                "vector");
+
+    for (Configuration const & configuration : configurations)
+    {
+        GridPathFinder pathFinder(grid, configuration.policy);
+
+        // With a context
+
+        GridPathFinder::Context context;
+        GridPathFinder::Path path;
+        std::vector<float> references(queries.size());
+        std::vector<size_t> lengths(queries.size());
+        size_t before = s_allocations;
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t q = 0; q < queries.size(); ++q)
+        {
+            bool found    = pathFinder.findPath(context, queries[q].start, queries[q].goal, &path);
+            references[q] = found ? context.g(queries[q].goal) : INFINITY;
+            lengths[q]    = found ? path.size() : 0;
+        }
+        double contextTime = seconds(t0);
+        size_t contextAllocations = s_allocations - before;
+
+        // With a workspace, once to warm it up and once to measure it, writing the paths into a buffer
+
+        GridPathFinder::Workspace workspace;
+        std::vector<uint32_t> buffer(grid.size());
+        double workspaceTime = 0.0;
+        size_t bufferAllocations = 0;
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            before = s_allocations;
+            t0 = std::chrono::steady_clock::now();
+            for (size_t q = 0; q < queries.size(); ++q)
+            {
+                Span<uint32_t> out(buffer);
+                size_t length = pathFinder.findPath(workspace, queries[q].start, queries[q].goal, out);
+                float cost    = (length > 0) ? workspace.context().g(queries[q].goal) : INFINITY;
+                if (length != lengths[q] || !same(cost, references[q]) ||
+                    (length > 0 && (buffer[0] != queries[q].start || buffer[length - 1] != queries[q].goal)))
+                {
+                    ++mismatches;
+                }
+            }
+            workspaceTime     = seconds(t0);
+            bufferAllocations = s_allocations - before;
+        }
+
+        // Again, writing the paths into a vector that is large enough
+
+        path.reserve(grid.size());
+        before = s_allocations;
+        for (size_t q = 0; q < queries.size(); ++q)
+        {
+            bool found = pathFinder.findPath(workspace, queries[q].start, queries[q].goal, &path);
+            if ((found ? path.size() : 0) != lengths[q])
+                ++mismatches;
+        }
+        size_t vectorAllocations = s_allocations - before;
+        leaks += bufferAllocations + vectorAllocations;
+
+        std::printf("%-16s %12.2f %12zu %12.2f %12zu %12zu\n", configuration.name, 1e6 * contextTime / queries.size(),
+                    contextAllocations, 1e6 * workspaceTime / queries.size(), bufferAllocations, vectorAllocations);
+    }
+
+    std::printf("%d mismatches, %zu allocations by warm queries\n", mismatches, leaks);
+
+    return (mismatches > 0 || leaks > 0) ? 1 : 0;
+}
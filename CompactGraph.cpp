@@ -0,0 +1,82 @@
+#include "CompactGraph.h"
+
+#include <cassert>
+#include <unordered_map>
+#include <utility>
+
+//! @param  nodes   Nodes of the graph. The index of each node in the graph is its index in this list.
+
+CompactGraph::CompactGraph(PathFinder::NodeList const & nodes)
+{
+    std::unordered_map<PathFinder::Node const *, uint32_t> indexes;
+    indexes.reserve(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        indexes.emplace(nodes[i], (uint32_t)i);
+    }
+
+    size_t nEdges = 0;
+    for (auto const & node : nodes)
+    {
+        nEdges += node->adjacencies.size();
+    }
+
+    offsets_.reserve(nodes.size() + 1);
+    targets_.reserve(nEdges);
+    costs_.reserve(nEdges);
+
+    offsets_.push_back(0);
+    for (auto const & node : nodes)
+    {
+        for (auto const & edge : node->adjacencies)
+        {
+            auto to = indexes.find(edge->to);
+            assert(to != indexes.end());
+            targets_.push_back(to->second);
+            costs_.push_back(edge->cost);
+        }
+        offsets_.push_back((uint32_t)targets_.size());
+    }
+}
+
+//! @param  size    Number of nodes
+//! @param  edges   Edges of the graph, in any order
+
+CompactGraph::CompactGraph(uint32_t size, std::vector<Edge> const & edges)
+    : offsets_(size + 1, 0)
+    , targets_(edges.size())
+    , costs_(edges.size())
+{
+    // Count the edges leaving each node, and then convert the counts into offsets
+    for (auto const & edge : edges)
+    {
+        assert(edge.from < size && edge.to < size);
+        ++offsets_[edge.from + 1];
+    }
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        offsets_[i + 1] += offsets_[i];
+    }
+
+    // Place each edge at the next free slot of its source node (keeping the given order within a node)
+    std::vector<uint32_t> next(offsets_.begin(), offsets_.end() - 1);
+    for (auto const & edge : edges)
+    {
+        uint32_t e = next[edge.from]++;
+        targets_[e] = edge.to;
+        costs_[e]   = edge.cost;
+    }
+}
+
+//! @param  offsets     Index of the first edge of each node, followed by the total number of edges
+//! @param  targets     Destination of each edge
+//! @param  costs       Cost of each edge
+
+CompactGraph::CompactGraph(std::vector<uint32_t> offsets, std::vector<uint32_t> targets, std::vector<float> costs)
+    : offsets_(std::move(offsets))
+    , targets_(std::move(targets))
+    , costs_(std::move(costs))
+{
+    assert(!offsets_.empty() && offsets_.front() == 0 && offsets_.back() == targets_.size());
+    assert(targets_.size() == costs_.size());
+}
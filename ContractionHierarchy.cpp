@@ -0,0 +1,570 @@
+#include "ContractionHierarchy.h"
+
+#include "OpenList.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <utility>
+
+namespace
+{
+    uint32_t constexpr NONE = SearchContext::NONE;
+
+    // Maximum number of nodes settled by a witness search when estimating the shortcuts needed to contract a node
+    int constexpr ESTIMATE_LIMIT = 100;
+
+    // Maximum number of nodes settled by a witness search when contracting a node. If the limit is reached, a shortcut
+    // may be added that is not needed, but it is never wrong.
+    int constexpr CONTRACT_LIMIT = 1000;
+
+    using Open = IndexedHeapOpenList<uint32_t, SearchContextAccess>;
+
+    // An edge of the graph being contracted
+    struct Arc
+    {
+        uint32_t node;      // The other node
+        float cost;
+        uint32_t middle;    // Node bypassed by a shortcut, or NONE
+    };
+
+    // The graph in the process of being contracted. When a node is contracted, its edges are removed from its
+    // neighbors' lists but kept in its own, where they are the node's upward and downward edges in the hierarchy.
+    class Contractor
+    {
+public:
+        explicit Contractor(CompactGraph const & graph);
+
+        // Contracts every node, and returns the rank of each node
+        std::vector<uint32_t> run();
+
+        // Returns the number of shortcuts added
+        uint32_t shortcuts() const { return shortcuts_; }
+
+        std::vector<std::vector<Arc>> out;  // Edges leaving each node to nodes that are not contracted
+        std::vector<std::vector<Arc>> in;   // Edges entering each node from nodes that are not contracted
+
+private:
+        // Returns the priority of a node. Nodes with lower priorities are contracted first.
+        int priority(uint32_t node);
+
+        // Contracts a node, or just counts the shortcuts that contracting it would add. Returns the count.
+        int contract(uint32_t node, bool simulate);
+
+        // Searches from a node, avoiding another node, until the targets are settled or the search reaches a maximum
+        // cost or number of settled nodes
+        void witnessSearch(uint32_t source, uint32_t avoid, int targets, float maxCost, int limit);
+
+        // Adds an edge, or lowers the cost of an existing edge between the same nodes
+        void addArc(uint32_t from, uint32_t to, float cost, uint32_t middle);
+
+        // Removes the edges to or from a node from a list
+        static void removeArcs(std::vector<Arc> & arcs, uint32_t node);
+
+        std::vector<bool> contracted_;
+        std::vector<int> contractedNeighbors_;  // Number of neighbors that have been contracted
+        std::vector<int> level_;                // Depth of the node in the hierarchy
+        std::vector<uint32_t> target_;          // Node being contracted, for the targets of its witness searches
+        SearchContext witness_;
+        uint32_t shortcuts_ = 0;
+    };
+
+    Contractor::Contractor(CompactGraph const & graph)
+        : out(graph.size())
+        , in(graph.size())
+        , contracted_(graph.size(), false)
+        , contractedNeighbors_(graph.size(), 0)
+        , level_(graph.size(), 0)
+        , target_(graph.size(), NONE)
+    {
+        for (uint32_t i = 0; i < graph.size(); ++i)
+        {
+            graph.forEachEdge(i, [&] (uint32_t to, float cost) {
+                if (to != i)
+                    addArc(i, to, cost, NONE);
+            });
+        }
+    }
+
+    std::vector<uint32_t> Contractor::run()
+    {
+        uint32_t const size = (uint32_t)out.size();
+
+        using Entry = std::pair<int, uint32_t>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            queue.push({ priority(i), i });
+        }
+
+        // The priorities change as the neighbors are contracted. Rather than updating them all, a node's priority is
+        // recomputed when it reaches the top, and if it is no longer the lowest, the node goes back in the queue.
+        std::vector<uint32_t> rank(size);
+        uint32_t next = 0;
+        while (!queue.empty())
+        {
+            uint32_t node = queue.top().second;
+            queue.pop();
+            if (contracted_[node])
+                continue;
+
+            int p = priority(node);
+            if (!queue.empty() && p > queue.top().first)
+            {
+                queue.push({ p, node });
+                continue;
+            }
+
+            contract(node, false);
+            contracted_[node] = true;
+            rank[node] = next++;
+
+            for (auto const & arc : out[node])
+            {
+                removeArcs(in[arc.node], node);
+                ++contractedNeighbors_[arc.node];
+                level_[arc.node] = std::max(level_[arc.node], level_[node] + 1);
+            }
+            for (auto const & arc : in[node])
+            {
+                removeArcs(out[arc.node], node);
+                ++contractedNeighbors_[arc.node];
+                level_[arc.node] = std::max(level_[arc.node], level_[node] + 1);
+            }
+        }
+        return rank;
+    }
+
+    int Contractor::priority(uint32_t node)
+    {
+        // Edge difference, plus terms that spread the contractions evenly over the graph
+        int removed = (int)(out[node].size() + in[node].size());
+        return contract(node, true) - removed + contractedNeighbors_[node] + level_[node];
+    }
+
+    int Contractor::contract(uint32_t node, bool simulate)
+    {
+        for (auto const & arcOut : out[node])
+        {
+            target_[arcOut.node] = node;
+        }
+
+        int added = 0;
+        for (auto const & arcIn : in[node])
+        {
+            uint32_t const from = arcIn.node;
+            float maxCost = -1.0f;
+            int targets = 0;
+            for (auto const & arcOut : out[node])
+            {
+                if (arcOut.node != from)
+                {
+                    maxCost = std::max(maxCost, arcIn.cost + arcOut.cost);
+                    ++targets;
+                }
+            }
+            if (targets == 0)
+                continue;
+
+            witnessSearch(from, node, targets + (target_[from] == node), maxCost, simulate ? ESTIMATE_LIMIT : CONTRACT_LIMIT);
+
+            for (auto const & arcOut : out[node])
+            {
+                uint32_t const to = arcOut.node;
+                if (to == from)
+                    continue;
+
+                // A shortcut is needed unless the search found a path that is no longer
+                float cost = arcIn.cost + arcOut.cost;
+                if (witness_.status(to) != SearchContext::Status::NOT_VISITED && witness_.g(to) <= cost)
+                    continue;
+
+                ++added;
+                if (!simulate)
+                    addArc(from, to, cost, node);
+            }
+        }
+        return added;
+    }
+
+    void Contractor::witnessSearch(uint32_t source, uint32_t avoid, int targets, float maxCost, int limit)
+    {
+        Open open(SearchContextAccess{ &witness_ });
+        witness_.begin(out.size());
+        witness_.open(source, 0.f, 0.f, NONE);
+        open.push(source);
+
+        int settled = 0;
+        while (!open.empty() && settled < limit)
+        {
+            uint32_t current = open.top();
+            float const g = witness_.g(current);
+            if (g > maxCost)
+                break;
+            witness_.expand(current);
+            open.pop();
+            ++settled;
+
+            if (target_[current] == avoid && --targets == 0)
+                break;
+
+            for (auto const & arc : out[current])
+            {
+                uint32_t const to = arc.node;
+                if (to == avoid || witness_.isClosed(to))
+                    continue;
+
+                if (!witness_.isOpen(to))
+                {
+                    witness_.open(to, g + arc.cost, 0.f, current);
+                    open.push(to);
+                }
+                else if (g + arc.cost < witness_.g(to))
+                {
+                    witness_.update(to, g + arc.cost, current);
+                    open.decrease(to);
+                }
+            }
+        }
+    }
+
+    void Contractor::addArc(uint32_t from, uint32_t to, float cost, uint32_t middle)
+    {
+        for (auto & arc : out[from])
+        {
+            if (arc.node == to)
+            {
+                if (cost < arc.cost)
+                {
+                    arc.cost   = cost;
+                    arc.middle = middle;
+                    for (auto & reverse : in[to])
+                    {
+                        if (reverse.node == from)
+                            reverse = { from, cost, middle };
+                    }
+                }
+                return;
+            }
+        }
+
+        out[from].push_back({ to, cost, middle });
+        in[to].push_back({ from, cost, middle });
+        if (middle != NONE)
+            ++shortcuts_;
+    }
+
+    void Contractor::removeArcs(std::vector<Arc> & arcs, uint32_t node)
+    {
+        arcs.erase(std::remove_if(arcs.begin(), arcs.end(), [node] (Arc const & arc) { return arc.node == node; }),
+                   arcs.end());
+    }
+}
+
+//! @param  graph   Graph. Its edge costs must not be negative.
+//!
+//! @note   The preprocessing is done here.
+
+ContractionHierarchy::ContractionHierarchy(CompactGraph const & graph)
+{
+    build(graph);
+}
+
+//! @param  domain  Nodes of the graph. The index of each node in the graph is its index in this list.
+//!
+//! @note   The preprocessing is done here. The list must outlive the hierarchy, and it must not change.
+
+ContractionHierarchy::ContractionHierarchy(PathFinder::NodeList * domain)
+    : nodes_(domain)
+{
+    assert(domain);
+    build(CompactGraph(*domain));
+}
+
+//! @param  view    Arrays of a hierarchy, such as those of a GraphFile
+//!
+//! @note   The arrays are used in place, so they must outlive the hierarchy.
+
+ContractionHierarchy::ContractionHierarchy(View const & view)
+    : view_(view)
+{
+    assert(view.upOffsets.size() == view.ranks.size() + 1 && view.downOffsets.size() == view.ranks.size() + 1);
+    assert(view.upOffsets[view.ranks.size()] == view.up.size());
+    assert(view.downOffsets[view.ranks.size()] == view.down.size());
+}
+
+//! @param  start   Index of the start node
+//! @param  end     Index of the end node
+//! @param  path    Path from start to end, including both
+//!
+//! @returns    true, if a path was found
+
+bool ContractionHierarchy::findPath(uint32_t start, uint32_t end, IndexPath * path)
+{
+    return findPath(context_, start, end, path);
+}
+
+//! @param  context Query state
+//! @param  start   Index of the start node
+//! @param  end     Index of the end node
+//! @param  path    Path from start to end, including both
+//!
+//! @returns    true, if a path was found
+
+bool ContractionHierarchy::findPath(Context & context, uint32_t start, uint32_t end, IndexPath * path) const
+{
+    assert(path);
+    path->clear();
+
+    float cost;
+    uint32_t meet = search(context, start, end, &cost);
+    if (meet == NONE)
+        return false;
+
+    // Collect the hierarchy's path: up from the start to the meeting node, and then down to the end
+
+    Context const & backward = context.backward();
+    IndexPath nodes;
+    for (uint32_t i = meet; i != NONE; i = context.predecessor(i))
+    {
+        nodes.push_back(i);
+    }
+    std::reverse(nodes.begin(), nodes.end());
+    for (uint32_t i = backward.predecessor(meet); i != NONE; i = backward.predecessor(i))
+    {
+        nodes.push_back(i);
+    }
+
+    // An edge is missing only if the arrays of a view do not belong together
+
+    path->push_back(start);
+    for (size_t k = 1; k < nodes.size(); ++k)
+    {
+        if (!unpack(nodes[k - 1], nodes[k], path))
+        {
+            path->clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+//! @param  context Query state
+//! @param  start   Start node
+//! @param  end     End node
+//! @param  path    Path from start to end, including both
+//!
+//! @returns    true, if a path was found
+//!
+//! @note   The hierarchy must have been built from a list of PathFinder nodes.
+//! @note   A node that is not in the list is an error, asserted in debug builds. In release builds, no path is found.
+
+bool ContractionHierarchy::findPath(Context & context, PathFinder::Node * start, PathFinder::Node * end, PathFinder::Path * path) const
+{
+    assert(nodes_.nodes());
+    assert(path);
+    path->clear();
+
+    uint32_t const from = nodes_.index(start);
+    uint32_t const to   = nodes_.index(end);
+    assert(from != NONE && to != NONE);
+    if (from == NONE || to == NONE)
+        return false;
+
+    IndexPath indexes;
+    if (!findPath(context, from, to, &indexes))
+        return false;
+
+    path->reserve(indexes.size());
+    for (uint32_t i : indexes)
+    {
+        path->push_back(nodes_.vertex(i));
+    }
+    return true;
+}
+
+//! @param  context Query state
+//! @param  start   Index of the start node
+//! @param  end     Index of the end node
+//!
+//! @returns    cost of the shortest path, or INFINITY if there is none
+
+float ContractionHierarchy::findCost(Context & context, uint32_t start, uint32_t end) const
+{
+    float cost;
+    return (search(context, start, end, &cost) != NONE) ? cost : INFINITY;
+}
+
+size_t ContractionHierarchy::memoryUsage() const
+{
+    return (view_.ranks.size() + view_.upOffsets.size() + view_.downOffsets.size()) * sizeof(uint32_t) +
+           (view_.up.size() + view_.down.size()) * sizeof(Edge);
+}
+
+void ContractionHierarchy::build(CompactGraph const & graph)
+{
+    Contractor contractor(graph);
+    rank_ = contractor.run();
+
+    // The edges left in a contracted node's lists lead to and from the nodes contracted after it. The edges entering
+    // it are its downward edges, which the backward search follows in reverse.
+
+    uint32_t const size = graph.size();
+    upOffsets_.assign(1, 0);
+    downOffsets_.assign(1, 0);
+    up_.clear();
+    down_.clear();
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        for (auto const & arc : contractor.out[i])
+        {
+            up_.push_back({ arc.node, arc.cost, arc.middle });
+        }
+        for (auto const & arc : contractor.in[i])
+        {
+            down_.push_back({ arc.node, arc.cost, arc.middle });
+        }
+        upOffsets_.push_back((uint32_t)up_.size());
+        downOffsets_.push_back((uint32_t)down_.size());
+
+        // Release the node's lists as soon as they are copied
+        std::vector<Arc>().swap(contractor.out[i]);
+        std::vector<Arc>().swap(contractor.in[i]);
+    }
+
+    view_.ranks       = Span<uint32_t const>(rank_.data(), rank_.size());
+    view_.upOffsets   = Span<uint32_t const>(upOffsets_.data(), upOffsets_.size());
+    view_.up          = Span<Edge const>(up_.data(), up_.size());
+    view_.downOffsets = Span<uint32_t const>(downOffsets_.data(), downOffsets_.size());
+    view_.down        = Span<Edge const>(down_.data(), down_.size());
+    view_.shortcuts   = contractor.shortcuts();
+}
+
+uint32_t ContractionHierarchy::search(Context & forward, uint32_t start, uint32_t end, float * cost) const
+{
+    uint32_t const size = this->size();
+    assert(start < size && end < size);
+
+    Context & backward = forward.backward();
+    forward.begin(size);
+    backward.begin(size);
+
+    Open forwardOpen(SearchContextAccess{ &forward });
+    Open backwardOpen(SearchContextAccess{ &backward });
+    forward.open(start, 0.f, 0.f, NONE);
+    forwardOpen.push(start);
+    backward.open(end, 0.f, 0.f, NONE);
+    backwardOpen.push(end);
+
+    float best = (start == end) ? 0.0f : INFINITY;
+    uint32_t meet = (start == end) ? start : NONE;
+
+    // Both searches only go up, so neither one can stop when it reaches the other's nodes; the best path may meet at
+    // a higher node. A search stops when its next node is no closer than the best path found so far.
+    //
+    // A node reached by a path that is not the shortest is not expanded ("stall on demand"). That is the case if a
+    // higher-ranked node already visited by the same search has a cheaper edge to it, which is an edge this search
+    // cannot follow, because it leads down. Its edges are in the other search's lists.
+
+    auto step = [&] (Context & context, Open & open, Context const & other,
+                     Span<uint32_t const> offsets, Span<Edge const> edges,
+                     Span<uint32_t const> downOffsets, Span<Edge const> downEdges) {
+        uint32_t current = open.top();
+        context.expand(current);
+        open.pop();
+
+        float const g = context.g(current);
+        for (uint32_t e = downOffsets[current], last = downOffsets[current + 1]; e != last; ++e)
+        {
+            uint32_t const from = downEdges[e].node;
+            if (context.status(from) != SearchContext::Status::NOT_VISITED && context.g(from) + downEdges[e].cost < g)
+                return;
+        }
+
+        for (uint32_t e = offsets[current], last = offsets[current + 1]; e != last; ++e)
+        {
+            uint32_t const to = edges[e].node;
+            float const c = g + edges[e].cost;
+            if (context.isClosed(to))
+                continue;
+
+            if (!context.isOpen(to))
+            {
+                context.open(to, c, 0.f, current);
+                open.push(to);
+            }
+            else if (c < context.g(to))
+            {
+                context.update(to, c, current);
+                open.decrease(to);
+            }
+            else
+            {
+                continue;
+            }
+
+            if (other.status(to) != SearchContext::Status::NOT_VISITED && c + other.g(to) < best)
+            {
+                best = c + other.g(to);
+                meet = to;
+            }
+        }
+    };
+
+    for (;;)
+    {
+        bool const forwardDone  = forwardOpen.empty() || forward.g(forwardOpen.top()) >= best;
+        bool const backwardDone = backwardOpen.empty() || backward.g(backwardOpen.top()) >= best;
+        if (forwardDone && backwardDone)
+            break;
+
+        if (!forwardDone && (backwardDone || forward.g(forwardOpen.top()) <= backward.g(backwardOpen.top())))
+            step(forward, forwardOpen, backward, view_.upOffsets, view_.up, view_.downOffsets, view_.down);
+        else
+            step(backward, backwardOpen, forward, view_.downOffsets, view_.down, view_.upOffsets, view_.up);
+    }
+
+    *cost = best;
+    return meet;
+}
+
+bool ContractionHierarchy::unpack(uint32_t from, uint32_t to, IndexPath * path) const
+{
+    Edge const * e = edge(from, to);
+    assert(e);
+    if (!e)
+        return false;
+
+    if (e->middle == NONE)
+    {
+        path->push_back(to);
+        return true;
+    }
+
+    uint32_t const middle = e->middle;
+    return unpack(from, middle, path) && unpack(middle, to, path);
+}
+
+ContractionHierarchy::Edge const * ContractionHierarchy::edge(uint32_t from, uint32_t to) const
+{
+    // An edge is stored with its lower-ranked node, and there is at most one edge from a node to another
+    if (view_.ranks[from] < view_.ranks[to])
+    {
+        for (uint32_t e = view_.upOffsets[from]; e != view_.upOffsets[from + 1]; ++e)
+        {
+            if (view_.up[e].node == to)
+                return &view_.up[e];
+        }
+    }
+    else
+    {
+        for (uint32_t e = view_.downOffsets[to]; e != view_.downOffsets[to + 1]; ++e)
+        {
+            if (view_.down[e].node == from)
+                return &view_.down[e];
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,3 @@
+#include "DistanceField.h"
+
+template class BasicDistanceField<NodeGraph, EdgeCost>;
@@ -0,0 +1,437 @@
+#include "GraphFile.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    char const MAGIC[8] = { 'P', 'F', 'G', 'R', 'A', 'P', 'H', 0 };
+    uint32_t constexpr ENDIANNESS = 0x01020304;     // Reads differently on a machine with the other byte order
+    uint64_t constexpr ALIGNMENT  = 64;             // Alignment of each section
+
+    // The arrays that can be stored in a file
+    enum SectionType : uint32_t
+    {
+        GRAPH_OFFSETS = 1,
+        GRAPH_TARGETS,
+        GRAPH_COSTS,
+        LANDMARK_NODES,
+        LANDMARK_DISTANCES,
+        HIERARCHY_RANKS,
+        HIERARCHY_UP_OFFSETS,
+        HIERARCHY_UP_EDGES,
+        HIERARCHY_DOWN_OFFSETS,
+        HIERARCHY_DOWN_EDGES,
+        SECTION_TYPES
+    };
+
+    // The start of the file
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint64_t fileSize;
+        uint32_t sectionCount;      // Number of entries in the section table, which follows the header
+        uint32_t nodeCount;
+        uint32_t shortcutCount;     // Number of shortcuts in the contraction hierarchy
+        uint32_t reserved;
+    };
+    static_assert(sizeof(Header) == 40, "The layout of the header is part of the format");
+
+    // An entry in the section table
+    struct Section
+    {
+        uint32_t type;
+        uint32_t elementSize;
+        uint64_t offset;            // Offset of the array from the start of the file
+        uint64_t count;             // Number of elements in the array
+    };
+    static_assert(sizeof(Section) == 24, "The layout of a section table entry is part of the format");
+    static_assert(sizeof(ContractionHierarchy::Edge) == 12, "The layout of an edge is part of the format");
+
+    // An array to be written
+    struct Array
+    {
+        uint32_t type;
+        uint32_t elementSize;
+        void const * data;
+        uint64_t count;
+    };
+
+    template <typename T>
+    Array array(uint32_t type, T const * data, uint64_t count)
+    {
+        return Array{ type, (uint32_t)sizeof(T), data, count };
+    }
+
+    uint64_t alignUp(uint64_t offset)
+    {
+        return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+    // Returns the size of the elements of each type of section
+    uint32_t elementSize(uint32_t type)
+    {
+        switch (type)
+        {
+        case GRAPH_COSTS:
+        case LANDMARK_DISTANCES:
+            return (uint32_t)sizeof(float);
+        case HIERARCHY_UP_EDGES:
+        case HIERARCHY_DOWN_EDGES:
+            return (uint32_t)sizeof(ContractionHierarchy::Edge);
+        default:
+            return (uint32_t)sizeof(uint32_t);
+        }
+    }
+}
+
+GraphFile::~GraphFile()
+{
+    close();
+}
+
+GraphFile::GraphFile(GraphFile && other) noexcept
+    : data_(std::exchange(other.data_, nullptr))
+    , size_(std::exchange(other.size_, 0))
+    , graph_(std::exchange(other.graph_, CompactGraphView()))
+    , landmarks_(std::exchange(other.landmarks_, LandmarkTable()))
+    , hierarchy_(std::exchange(other.hierarchy_, ContractionHierarchy::View()))
+{
+}
+
+GraphFile & GraphFile::operator =(GraphFile && other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        data_      = std::exchange(other.data_, nullptr);
+        size_      = std::exchange(other.size_, 0);
+        graph_     = std::exchange(other.graph_, CompactGraphView());
+        landmarks_ = std::exchange(other.landmarks_, LandmarkTable());
+        hierarchy_ = std::exchange(other.hierarchy_, ContractionHierarchy::View());
+    }
+    return *this;
+}
+
+//! @param  path        Name of the file
+//! @param  graph       Graph
+//! @param  landmarks   Tables of the graph's landmarks, or an empty table if there are none
+//! @param  hierarchy   Contraction hierarchy of the graph, or nullptr if there is none
+//!
+//! @returns    true, if the file was written
+
+bool GraphFile::write(char const *                 path,
+                      CompactGraphView const &     graph,
+                      LandmarkTable const &        landmarks,
+                      ContractionHierarchy const * hierarchy)
+{
+    assert(landmarks.count() == 0 || landmarks.size() == graph.size());
+    assert(!hierarchy || hierarchy->size() == graph.size());
+
+    uint32_t const size = graph.size();
+    std::vector<Array> arrays;
+    arrays.push_back(array(GRAPH_OFFSETS, graph.offsets(), (uint64_t)size + 1));
+    arrays.push_back(array(GRAPH_TARGETS, graph.targets(), graph.edgeCount()));
+    arrays.push_back(array(GRAPH_COSTS, graph.costs(), graph.edgeCount()));
+    if (landmarks.count() > 0)
+    {
+        arrays.push_back(array(LANDMARK_NODES, landmarks.landmarks(), landmarks.count()));
+        arrays.push_back(array(LANDMARK_DISTANCES, landmarks.distances(), (uint64_t)size * 2 * landmarks.count()));
+    }
+    if (hierarchy)
+    {
+        ContractionHierarchy::View const & view = hierarchy->view();
+        arrays.push_back(array(HIERARCHY_RANKS, view.ranks.data(), view.ranks.size()));
+        arrays.push_back(array(HIERARCHY_UP_OFFSETS, view.upOffsets.data(), view.upOffsets.size()));
+        arrays.push_back(array(HIERARCHY_UP_EDGES, view.up.data(), view.up.size()));
+        arrays.push_back(array(HIERARCHY_DOWN_OFFSETS, view.downOffsets.data(), view.downOffsets.size()));
+        arrays.push_back(array(HIERARCHY_DOWN_EDGES, view.down.data(), view.down.size()));
+    }
+
+    // Lay out the sections after the header and the section table
+
+    std::vector<Section> sections;
+    uint64_t offset = sizeof(Header) + arrays.size() * sizeof(Section);
+    for (Array const & a : arrays)
+    {
+        offset = alignUp(offset);
+        sections.push_back(Section{ a.type, a.elementSize, offset, a.count });
+        offset += a.count * a.elementSize;
+    }
+
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version       = VERSION;
+    header.byteOrder     = ENDIANNESS;
+    header.fileSize      = offset;
+    header.sectionCount  = (uint32_t)sections.size();
+    header.nodeCount     = size;
+    header.shortcutCount = hierarchy ? hierarchy->shortcutCount() : 0;
+
+    std::FILE * file = std::fopen(path, "wb");
+    if (!file)
+        return false;
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              std::fwrite(sections.data(), sizeof(Section), sections.size(), file) == sections.size();
+    uint64_t position = sizeof(Header) + sections.size() * sizeof(Section);
+    char const padding[ALIGNMENT] = {};
+    for (size_t s = 0; ok && s < sections.size(); ++s)
+    {
+        size_t const gap   = (size_t)(sections[s].offset - position);
+        size_t const bytes = (size_t)(sections[s].count * sections[s].elementSize);
+        ok = std::fwrite(padding, 1, gap, file) == gap &&
+             (bytes == 0 || std::fwrite(arrays[s].data, 1, bytes, file) == bytes);
+        position = sections[s].offset + bytes;
+    }
+
+    ok = (std::fclose(file) == 0) && ok;
+    return ok;
+}
+
+//! @param  path    Name of the file
+//!
+//! @returns    true, if the file was mapped and is a valid graph file of this version
+//!
+//! @note   Any file that was already open is closed first.
+
+bool GraphFile::open(char const * path)
+{
+    close();
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    // The view keeps the file mapped after the handles are closed
+    LARGE_INTEGER size;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping)
+        return false;
+
+    void * data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!data)
+        return false;
+    data_ = data;
+    size_ = (size_t)size.QuadPart;
+#else
+    int file = ::open(path, O_RDONLY);
+    if (file < 0)
+        return false;
+
+    // The mapping remains after the file is closed
+    struct stat status;
+    void * data = MAP_FAILED;
+    if (fstat(file, &status) == 0 && status.st_size > 0)
+        data = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_SHARED, file, 0);
+    ::close(file);
+    if (data == MAP_FAILED)
+        return false;
+    data_ = data;
+    size_ = (size_t)status.st_size;
+#endif
+
+    if (!bind())
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void GraphFile::close()
+{
+    if (data_)
+    {
+#if defined(_WIN32)
+        UnmapViewOfFile(data_);
+#else
+        munmap(const_cast<void *>(data_), size_);
+#endif
+    }
+    data_      = nullptr;
+    size_      = 0;
+    graph_     = CompactGraphView();
+    landmarks_ = LandmarkTable();
+    hierarchy_ = ContractionHierarchy::View();
+}
+
+//! @returns    true, if every array of the file can be searched safely
+//!
+//! @note   Every element of the arrays is read, so the whole file is brought into memory.
+//! @note   A shortcut of the hierarchy must bypass a node ranked lower than both of its ends, so that unpacking it
+//!         ends. The costs are not checked.
+
+bool GraphFile::validate() const
+{
+    if (!isOpen())
+        return false;
+
+    uint32_t const size = graph_.size();
+
+    // The offsets must not decrease, and each edge must lead to a node of the graph
+    auto validOffsets = [size] (uint32_t const * offsets) {
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            if (offsets[i] > offsets[i + 1])
+                return false;
+        }
+        return true;
+    };
+    if (!validOffsets(graph_.offsets()))
+        return false;
+    for (uint32_t e = 0; e < graph_.edgeCount(); ++e)
+    {
+        if (graph_.target(e) >= size)
+            return false;
+    }
+
+    for (uint32_t k = 0; k < landmarks_.count(); ++k)
+    {
+        if (landmarks_.landmarks()[k] >= size)
+            return false;
+    }
+
+    if (!hasHierarchy())
+        return true;
+
+    ContractionHierarchy::View const & h = hierarchy_;
+    if (!validOffsets(h.upOffsets.data()) || !validOffsets(h.downOffsets.data()))
+        return false;
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        if (h.ranks[i] >= size)
+            return false;
+    }
+    auto validEdge = [&] (uint32_t node, ContractionHierarchy::Edge const & edge) {
+        return edge.node < size && (edge.middle == SearchContext::NONE ||
+                                    (edge.middle < size && h.ranks[edge.middle] < h.ranks[node] &&
+                                     h.ranks[edge.middle] < h.ranks[edge.node]));
+    };
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        for (uint32_t e = h.upOffsets[i]; e != h.upOffsets[i + 1]; ++e)
+        {
+            if (!validEdge(i, h.up[e]))
+                return false;
+        }
+        for (uint32_t e = h.downOffsets[i]; e != h.downOffsets[i + 1]; ++e)
+        {
+            if (!validEdge(i, h.down[e]))
+                return false;
+        }
+    }
+    return true;
+}
+
+//! @returns    true, if the file is a valid graph file of this version
+//!
+//! @note   Only the header, the section table and the last offset of each offset array are read, so the rest of the
+//!         file is not touched until it is searched.
+
+bool GraphFile::bind()
+{
+    char const * bytes = static_cast<char const *>(data_);
+
+    Header header;
+    if (size_ < sizeof(header))
+        return false;
+    std::memcpy(&header, bytes, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.byteOrder != ENDIANNESS || header.fileSize != size_ ||
+        header.sectionCount > (size_ - sizeof(Header)) / sizeof(Section))
+    {
+        return false;
+    }
+
+    // Find each section, checking that it lies within the file and is aligned. Unknown sections are ignored.
+
+    void const * data[SECTION_TYPES] = {};
+    uint64_t count[SECTION_TYPES] = {};
+    Section const * sections = reinterpret_cast<Section const *>(bytes + sizeof(Header));
+    for (uint32_t s = 0; s < header.sectionCount; ++s)
+    {
+        Section const & section = sections[s];
+        if (section.type == 0 || section.type >= SECTION_TYPES)
+            continue;
+        if (section.elementSize != elementSize(section.type) || section.offset % ALIGNMENT != 0 ||
+            section.offset > size_ || section.count > (size_ - section.offset) / section.elementSize)
+        {
+            return false;
+        }
+        data[section.type]  = bytes + section.offset;
+        count[section.type] = section.count;
+    }
+
+    auto offsets = [&] (uint32_t type) { return static_cast<uint32_t const *>(data[type]); };
+
+    // The graph is required
+
+    uint32_t const size = header.nodeCount;
+    if (count[GRAPH_OFFSETS] != (uint64_t)size + 1 || offsets(GRAPH_OFFSETS)[0] != 0 ||
+        count[GRAPH_TARGETS] != offsets(GRAPH_OFFSETS)[size] || count[GRAPH_COSTS] != count[GRAPH_TARGETS])
+    {
+        return false;
+    }
+    graph_ = CompactGraphView(size,
+                              offsets(GRAPH_OFFSETS),
+                              static_cast<uint32_t const *>(data[GRAPH_TARGETS]),
+                              static_cast<float const *>(data[GRAPH_COSTS]));
+
+    // The landmarks and the hierarchy are optional
+
+    uint64_t const nLandmarks = count[LANDMARK_NODES];
+    if (nLandmarks > 0)
+    {
+        if (count[LANDMARK_DISTANCES] != (uint64_t)size * 2 * nLandmarks)
+            return false;
+        landmarks_ = LandmarkTable(size,
+                                   (uint32_t)nLandmarks,
+                                   static_cast<uint32_t const *>(data[LANDMARK_NODES]),
+                                   static_cast<float const *>(data[LANDMARK_DISTANCES]));
+    }
+
+    if (count[HIERARCHY_RANKS] > 0)
+    {
+        if (count[HIERARCHY_RANKS] != size || count[HIERARCHY_UP_OFFSETS] != (uint64_t)size + 1 ||
+            count[HIERARCHY_DOWN_OFFSETS] != (uint64_t)size + 1 ||
+            count[HIERARCHY_UP_EDGES] != offsets(HIERARCHY_UP_OFFSETS)[size] ||
+            count[HIERARCHY_DOWN_EDGES] != offsets(HIERARCHY_DOWN_OFFSETS)[size])
+        {
+            return false;
+        }
+        using Edge = ContractionHierarchy::Edge;
+        hierarchy_.ranks       = Span<uint32_t const>(offsets(HIERARCHY_RANKS), size);
+        hierarchy_.upOffsets   = Span<uint32_t const>(offsets(HIERARCHY_UP_OFFSETS), (size_t)size + 1);
+        hierarchy_.up          = Span<Edge const>(static_cast<Edge const *>(data[HIERARCHY_UP_EDGES]),
+                                                  (size_t)count[HIERARCHY_UP_EDGES]);
+        hierarchy_.downOffsets = Span<uint32_t const>(offsets(HIERARCHY_DOWN_OFFSETS), (size_t)size + 1);
+        hierarchy_.down        = Span<Edge const>(static_cast<Edge const *>(data[HIERARCHY_DOWN_EDGES]),
+                                                  (size_t)count[HIERARCHY_DOWN_EDGES]);
+        hierarchy_.shortcuts   = header.shortcutCount;
+    }
+
+    return true;
+}
@@ -0,0 +1,49 @@
+#include "GridPathFinder.h"
+
+#include <cassert>
+
+template class BasicPathFinder<GridGraph, OctileHeuristic, EdgeCost>;
+
+//! @param  grid    Grid to search
+//! @param  policy  Configuration options
+//!
+//! @note   If the grid has a cost array, it is scanned once to find the lowest cost, which scales the heuristic.
+
+GridPathFinder::GridPathFinder(GridGraph const & grid, Policy const & policy)
+    : BasicPathFinder(grid, policy, OctileHeuristic{ grid.minimumCostScale() })
+{
+}
+
+//! @param    x0, y0    Start cell
+//! @param    x1, y1    End cell
+//! @param    path      Resulting path
+//!
+//! @returns    true, if a path is found
+//!
+//! @note   This function uses a workspace owned by the pathfinder, so it cannot be called concurrently.
+//! @note   A cell outside the grid is an error, asserted in debug builds. In release builds, no path is found.
+
+bool GridPathFinder::findPath(int x0, int y0, int x1, int y1, Path * path)
+{
+    assert(graph().contains(x0, y0) && graph().contains(x1, y1));
+    if (!graph().contains(x0, y0) || !graph().contains(x1, y1))
+        return false;
+    return findPath(graph().cell(x0, y0), graph().cell(x1, y1), path);
+}
+
+//! @param    context   State of the search
+//! @param    x0, y0    Start cell
+//! @param    x1, y1    End cell
+//! @param    path      Resulting path
+//!
+//! @returns    true, if a path is found
+//!
+//! @note   A cell outside the grid is an error, asserted in debug builds. In release builds, no path is found.
+
+bool GridPathFinder::findPath(Context & context, int x0, int y0, int x1, int y1, Path * path) const
+{
+    assert(graph().contains(x0, y0) && graph().contains(x1, y1));
+    if (!graph().contains(x0, y0) || !graph().contains(x1, y1))
+        return false;
+    return findPath(context, graph().cell(x0, y0), graph().cell(x1, y1), path);
+}
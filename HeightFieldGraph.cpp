@@ -0,0 +1,396 @@
+#include "HeightFieldGraph.h"
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+
+// The kernels use SSE2 where it is available, unless PATHFINDER_NO_SIMD is defined
+#if !defined(PATHFINDER_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define PATHFINDER_SSE2
+#include <emmintrin.h>
+#endif
+
+// Directions 0-3 are straight and 4-7 are diagonal
+int const HeightFieldGraph::DX[DIRECTIONS] = { -1, 1, 0, 0, -1, 1, -1, 1 };
+int const HeightFieldGraph::DY[DIRECTIONS] = { 0, 0, -1, 1, -1, -1, 1, 1 };
+
+namespace
+{
+    // Number of rows in each task of a parallel pass
+    int constexpr ROWS_PER_TASK = 8;
+
+    float constexpr SQRT2 = 1.41421356f;
+
+    // Sets the penalty and passability of n cells from their heights: 0 and 1 at or above sea level, and INFINITY and
+    // 0 below it
+    void maskKernel(float const * z, int n, float seaLevel, float * penalty, uint8_t * passable)
+    {
+        int i = 0;
+#if defined(PATHFINDER_SSE2)
+        __m128 const sea      = _mm_set1_ps(seaLevel);
+        __m128 const infinity = _mm_set1_ps(INFINITY);
+        __m128i const one     = _mm_set1_epi8(1);
+        for (; i + 16 <= n; i += 16)
+        {
+            __m128 const below0 = _mm_cmplt_ps(_mm_loadu_ps(z + i), sea);
+            __m128 const below1 = _mm_cmplt_ps(_mm_loadu_ps(z + i + 4), sea);
+            __m128 const below2 = _mm_cmplt_ps(_mm_loadu_ps(z + i + 8), sea);
+            __m128 const below3 = _mm_cmplt_ps(_mm_loadu_ps(z + i + 12), sea);
+            _mm_storeu_ps(penalty + i, _mm_and_ps(below0, infinity));
+            _mm_storeu_ps(penalty + i + 4, _mm_and_ps(below1, infinity));
+            _mm_storeu_ps(penalty + i + 8, _mm_and_ps(below2, infinity));
+            _mm_storeu_ps(penalty + i + 12, _mm_and_ps(below3, infinity));
+
+            // Narrow the 32-bit masks to bytes
+            __m128i const below01 = _mm_packs_epi32(_mm_castps_si128(below0), _mm_castps_si128(below1));
+            __m128i const below23 = _mm_packs_epi32(_mm_castps_si128(below2), _mm_castps_si128(below3));
+            __m128i const below   = _mm_packs_epi16(below01, below23);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(passable + i), _mm_andnot_si128(below, one));
+        }
+#endif
+        for (; i < n; ++i)
+        {
+            bool const below = z[i] < seaLevel;
+            penalty[i]  = below ? INFINITY : 0.0f;
+            passable[i] = below ? 0 : 1;
+        }
+    }
+
+    // Computes the costs of n steps of the given length from heights z0 to heights z1, matching GridGraph's height
+    // model. Each cost is increased by the penalties p0 and p1 of the cells, and by the penalties p2 and p3 of the
+    // cells at the corners if Corners is true.
+    template <bool Corners>
+    void slopeKernel(float const * z0,
+                     float const * z1,
+                     float const * p0,
+                     float const * p1,
+                     float const * p2,
+                     float const * p3,
+                     int           n,
+                     float         length,
+                     float         uphill,
+                     float         downhill,
+                     float *       costs)
+    {
+        int i = 0;
+#if defined(PATHFINDER_SSE2)
+        __m128 const zero  = _mm_setzero_ps();
+        __m128 const one   = _mm_set1_ps(1.0f);
+        __m128 const up    = _mm_set1_ps(uphill);
+        __m128 const down  = _mm_set1_ps(downhill);
+        __m128 const scale = _mm_set1_ps(length);
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128 const dz = _mm_sub_ps(_mm_loadu_ps(z1 + i), _mm_loadu_ps(z0 + i));
+            __m128 c = _mm_add_ps(one, _mm_mul_ps(_mm_max_ps(dz, zero), up));
+            c = _mm_add_ps(c, _mm_mul_ps(_mm_max_ps(_mm_sub_ps(zero, dz), zero), down));
+            c = _mm_mul_ps(c, scale);
+            c = _mm_add_ps(c, _mm_add_ps(_mm_loadu_ps(p0 + i), _mm_loadu_ps(p1 + i)));
+            if (Corners)
+                c = _mm_add_ps(c, _mm_add_ps(_mm_loadu_ps(p2 + i), _mm_loadu_ps(p3 + i)));
+            _mm_storeu_ps(costs + i, c);
+        }
+#endif
+        for (; i < n; ++i)
+        {
+            float const dz = z1[i] - z0[i];
+            float c = (1.0f + std::max(dz, 0.0f) * uphill + std::max(-dz, 0.0f) * downhill) * length;
+            c += p0[i] + p1[i];
+            if (Corners)
+                c += p2[i] + p3[i];
+            costs[i] = c;
+        }
+    }
+
+    // Interleaves the costs of cells [x0, x1) from the rows of a scratch buffer, one row for each direction, so that
+    // the costs of each cell are together
+    void interleaveKernel(float const * scratch, int stride, int x0, int x1, float * costs)
+    {
+        int x = x0;
+#if defined(PATHFINDER_SSE2)
+        for (; x + 4 <= x1; x += 4)
+        {
+            for (int half = 0; half < 2; ++half)
+            {
+                float const * rows = scratch + half * 4 * stride + x;
+                __m128 r0 = _mm_loadu_ps(rows);
+                __m128 r1 = _mm_loadu_ps(rows + stride);
+                __m128 r2 = _mm_loadu_ps(rows + 2 * stride);
+                __m128 r3 = _mm_loadu_ps(rows + 3 * stride);
+                _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                float * out = costs + (size_t)x * HeightFieldGraph::DIRECTIONS + half * 4;
+                _mm_storeu_ps(out, r0);
+                _mm_storeu_ps(out + HeightFieldGraph::DIRECTIONS, r1);
+                _mm_storeu_ps(out + 2 * HeightFieldGraph::DIRECTIONS, r2);
+                _mm_storeu_ps(out + 3 * HeightFieldGraph::DIRECTIONS, r3);
+            }
+        }
+#endif
+        for (; x < x1; ++x)
+        {
+            for (int d = 0; d < HeightFieldGraph::DIRECTIONS; ++d)
+            {
+                costs[(size_t)x * HeightFieldGraph::DIRECTIONS + d] = scratch[d * stride + x];
+            }
+        }
+    }
+
+    // Returns a / b rounded up, for b > 0
+    int divideUp(int a, int b)
+    {
+        return (a >= 0) ? (a + b - 1) / b : -(-a / b);
+    }
+}
+
+//! @param  path    Path of the image file
+//! @param  scale   Height of the highest value (255)
+//!
+//! @returns    true, if the image was loaded
+//!
+//! @note   Run-length encoded images are not supported.
+
+bool HeightMap::load(char const * path, float scale)
+{
+    std::FILE * file = std::fopen(path, "rb");
+    if (!file)
+        return false;
+    std::vector<uint8_t> data;
+    uint8_t buffer[4096];
+    for (size_t n; (n = std::fread(buffer, 1, sizeof(buffer), file)) > 0;)
+    {
+        data.insert(data.end(), buffer, buffer + n);
+    }
+    std::fclose(file);
+
+    if (data.size() < 18)
+        return false;
+
+    auto u16 = [&data] (size_t offset) { return (int)data[offset] | ((int)data[offset + 1] << 8); };
+    int const idLength     = data[0];
+    int const colorMapType = data[1];
+    int const imageType    = data[2];
+    int const mapFirst     = u16(3);
+    int const mapLength    = u16(5);
+    int const mapBits      = data[7];
+    int const w            = u16(12);
+    int const h            = u16(14);
+    int const pixelBits    = data[16];
+    int const descriptor   = data[17];
+
+    // Find the size of each pixel and the palette, if any
+    size_t const mapOffset  = 18 + (size_t)idLength;
+    size_t const mapBytes   = (colorMapType == 1) ? (size_t)mapLength * ((mapBits + 7) / 8) : 0;
+    size_t const dataOffset = mapOffset + mapBytes;
+    int const pixelBytes    = pixelBits / 8;
+
+    bool supported = false;
+    switch (imageType)
+    {
+    case 1:     // Color-mapped
+        supported = colorMapType == 1 && pixelBits == 8 && (mapBits == 24 || mapBits == 32);
+        break;
+    case 2:     // True-color
+        supported = pixelBits == 24 || pixelBits == 32;
+        break;
+    case 3:     // Grayscale
+        supported = pixelBits == 8;
+        break;
+    }
+    if (!supported || w <= 0 || h <= 0 || data.size() < dataOffset + (size_t)w * h * pixelBytes)
+        return false;
+
+    // Returns the average of the components of a color stored as BGR or BGRA
+    auto average = [] (uint8_t const * bgr) { return ((float)bgr[0] + (float)bgr[1] + (float)bgr[2]) / 3.0f; };
+
+    width  = w;
+    height = h;
+    heights.resize((size_t)w * h);
+    float const factor = scale / 255.0f;
+    bool const topDown     = (descriptor & 0x20) != 0;
+    bool const rightToLeft = (descriptor & 0x10) != 0;
+    for (int y = 0; y < h; ++y)
+    {
+        uint8_t const * row = data.data() + dataOffset + (size_t)y * w * pixelBytes;
+        float * out = heights.data() + (size_t)(topDown ? h - 1 - y : y) * w;
+        for (int x = 0; x < w; ++x)
+        {
+            uint8_t const * pixel = row + (size_t)x * pixelBytes;
+            float value;
+            if (imageType == 1)
+            {
+                int const entry = std::min(std::max((int)pixel[0] - mapFirst, 0), mapLength - 1);
+                value = average(data.data() + mapOffset + (size_t)entry * (mapBits / 8));
+            }
+            else if (imageType == 2)
+            {
+                value = average(pixel);
+            }
+            else
+            {
+                value = pixel[0];
+            }
+            out[rightToLeft ? w - 1 - x : x] = value * factor;
+        }
+    }
+    return true;
+}
+
+//! @param  heights     Height field, row by row
+//! @param  width       Number of heights in each row
+//! @param  height      Number of rows
+//! @param  settings    How the graph is built
+//!
+//! @note   The graph must be built by build() before it is used.
+
+HeightFieldBuilder::HeightFieldBuilder(float const * heights, int width, int height, Settings const & settings)
+    : field_(heights)
+    , fieldWidth_(width)
+    , fieldHeight_(height)
+{
+    assert(heights && width > 0 && height > 0);
+    setSettings(settings);
+}
+
+//! @param  settings    How the graph is built
+
+void HeightFieldBuilder::setSettings(Settings const & settings)
+{
+    assert(settings.stride > 0 && settings.margin >= 0);
+    settings_ = settings;
+    width_    = (fieldWidth_ - 1) / settings.stride + 1 - 2 * settings.margin;
+    height_   = (fieldHeight_ - 1) / settings.stride + 1 - 2 * settings.margin;
+    assert(width_ > 0 && height_ > 0);
+
+    size_t const size = (size_t)width_ * height_;
+    heights_.resize(size);
+    penalties_.resize(size);
+    passable_.resize(size);
+    costs_.resize(size * HeightFieldGraph::DIRECTIONS);
+}
+
+//! @param  pool    Threads that build the rows (optional)
+
+void HeightFieldBuilder::build(ThreadPool * pool)
+{
+    update(0, 0, fieldWidth_, fieldHeight_, pool);
+}
+
+//! @param  x0, y0  Lower corner of the area that changed, in the height field
+//! @param  x1, y1  Upper corner of the area that changed (exclusive)
+//! @param  pool    Threads that rebuild the rows (optional)
+//!
+//! @note   The costs of the steps from the cells next to the changed cells are rebuilt too, because the steps into the
+//!         changed cells and the diagonal steps across them depend on their heights.
+
+void HeightFieldBuilder::update(int x0, int y0, int x1, int y1, ThreadPool * pool)
+{
+    // Find the cells that sample the area
+    int const cx0 = std::max(divideUp(x0, settings_.stride) - settings_.margin, 0);
+    int const cy0 = std::max(divideUp(y0, settings_.stride) - settings_.margin, 0);
+    int const cx1 = std::min(divideUp(x1, settings_.stride) - settings_.margin, width_);
+    int const cy1 = std::min(divideUp(y1, settings_.stride) - settings_.margin, height_);
+    if (cx0 >= cx1 || cy0 >= cy1)
+        return;
+
+    forEachRow(cy0, cy1, pool, [&] (int y, unsigned) { sampleRow(y, cx0, cx1); });
+
+    // Rebuild the steps from those cells and their neighbors
+    int const bx0 = std::max(cx0 - 1, 0);
+    int const by0 = std::max(cy0 - 1, 0);
+    int const bx1 = std::min(cx1 + 1, width_);
+    int const by1 = std::min(cy1 + 1, height_);
+
+    unsigned const workers = pool ? pool->size() : 1;
+    if (scratch_.size() < workers)
+        scratch_.resize(workers);
+    for (auto & scratch : scratch_)
+    {
+        scratch.resize((size_t)width_ * HeightFieldGraph::DIRECTIONS);
+    }
+
+    forEachRow(by0, by1, pool, [&] (int y, unsigned worker) { buildRow(y, bx0, bx1, scratch_[worker].data()); });
+}
+
+HeightFieldGraph HeightFieldBuilder::graph() const
+{
+    // A step across level ground costs its length, unless one of the factors is negative
+    float const scale = (settings_.uphill < 0.0f || settings_.downhill < 0.0f) ? 0.0f : 1.0f;
+    return HeightFieldGraph(width_, height_, costs_.data(), passable_.data(), scale);
+}
+
+void HeightFieldBuilder::sampleRow(int y, int x0, int x1)
+{
+    size_t const row = (size_t)y * width_;
+    float const * source = field_ + (size_t)fieldY(y) * fieldWidth_;
+    for (int x = x0; x < x1; ++x)
+    {
+        heights_[row + x] = source[fieldX(x)];
+    }
+    maskKernel(&heights_[row + x0], x1 - x0, settings_.seaLevel, &penalties_[row + x0], &passable_[row + x0]);
+}
+
+void HeightFieldBuilder::buildRow(int y, int x0, int x1, float * scratch)
+{
+    size_t const row = (size_t)y * width_;
+    for (int d = 0; d < HeightFieldGraph::DIRECTIONS; ++d)
+    {
+        int const dx = HeightFieldGraph::DX[d];
+        int const dy = HeightFieldGraph::DY[d];
+        float * out  = scratch + (size_t)d * width_;
+
+        // The steps that would leave the grid are not allowed
+        int const ny = y + dy;
+        int const xa = (ny >= 0 && ny < height_) ? std::max(x0, -dx) : x1;
+        int const xb = std::max(xa, std::min(x1, width_ - dx));
+        std::fill(out + x0, out + xa, INFINITY);
+        std::fill(out + xb, out + x1, INFINITY);
+        if (xa >= xb)
+            continue;
+
+        size_t const next = (size_t)ny * width_;
+        float const * z0 = &heights_[row + xa];
+        float const * z1 = &heights_[next + xa + dx];
+        float const * p0 = &penalties_[row + xa];
+        float const * p1 = &penalties_[next + xa + dx];
+        bool const diagonal = dx != 0 && dy != 0;
+        float const length  = diagonal ? SQRT2 : 1.0f;
+        if (diagonal && !settings_.cutCorners)
+        {
+            float const * p2 = &penalties_[row + xa + dx];
+            float const * p3 = &penalties_[next + xa];
+            slopeKernel<true>(z0, z1, p0, p1, p2, p3, xb - xa, length, settings_.uphill, settings_.downhill, out + xa);
+        }
+        else
+        {
+            slopeKernel<false>(z0, z1, p0, p1, nullptr, nullptr, xb - xa, length, settings_.uphill, settings_.downhill,
+                               out + xa);
+        }
+    }
+
+    interleaveKernel(scratch, width_, x0, x1, &costs_[row * HeightFieldGraph::DIRECTIONS]);
+}
+
+template <typename Pass>
+void HeightFieldBuilder::forEachRow(int y0, int y1, ThreadPool * pool, Pass && pass)
+{
+    if (!pool || pool->size() == 1)
+    {
+        for (int y = y0; y < y1; ++y)
+        {
+            pass(y, 0);
+        }
+        return;
+    }
+
+    uint32_t const tasks = (uint32_t)divideUp(y1 - y0, ROWS_PER_TASK);
+    pool->run(tasks, [&] (uint32_t task, unsigned worker) {
+        int const begin = y0 + (int)task * ROWS_PER_TASK;
+        int const end   = std::min(begin + ROWS_PER_TASK, y1);
+        for (int y = begin; y < end; ++y)
+        {
+            pass(y, worker);
+        }
+    });
+}
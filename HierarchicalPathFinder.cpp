@@ -0,0 +1,474 @@
+#include "HierarchicalPathFinder.h"
+
+#include "OpenList.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+    // Entrances at least this long get an abstract node at each end instead of one in the middle
+    int constexpr LONG_ENTRANCE = 6;
+
+    // Searches a rectangle of the grid from a cell with Dijkstra's algorithm, calling settled(cell, cost) for each cell
+    // in order of increasing cost until it returns false. If reverse is true, the costs are the costs to the cell
+    // instead.
+    template <typename Settled>
+    void searchRegion(GridGraph const & grid,
+                      SearchContext &   context,
+                      int x0, int y0, int x1, int y1,
+                      uint32_t          source,
+                      bool              reverse,
+                      Settled &&        settled)
+    {
+        IndexedHeapOpenList<uint32_t, SearchContextAccess> open(SearchContextAccess{ &context });
+
+        context.begin(grid.size());
+        context.open(source, 0.f, 0.f, SearchContext::NONE);
+        open.push(source);
+
+        while (!open.empty())
+        {
+            uint32_t current = open.top();
+            context.expand(current);
+            open.pop();
+
+            float const g = context.g(current);
+            if (!settled(current, g))
+                return;
+
+            // The grid's neighbors are symmetric, so the edges entering a cell come from its neighbors
+            grid.forEachEdge(current, [&] (uint32_t neighbor, float cost) {
+                int x = grid.x(neighbor);
+                int y = grid.y(neighbor);
+                if (x < x0 || x > x1 || y < y0 || y > y1 || context.isClosed(neighbor))
+                    return;
+
+                if (reverse)
+                    cost = grid.stepCost(neighbor, current, x != grid.x(current) && y != grid.y(current));
+
+                if (!context.isOpen(neighbor))
+                {
+                    context.open(neighbor, g + cost, 0.f, current);
+                    open.push(neighbor);
+                }
+                else if (g + cost < context.g(neighbor))
+                {
+                    context.update(neighbor, g + cost, current);
+                    open.decrease(neighbor);
+                }
+            });
+        }
+    }
+}
+
+// The abstract graph plus the start and the goal of a query. The start is node n and the goal is node n + 1.
+struct HierarchicalPathFinder::QueryGraph
+{
+    using Vertex = uint32_t;
+
+    uint32_t size() const { return n + 2; }
+    uint32_t index(uint32_t i) const { return i; }
+    uint32_t vertex(uint32_t i) const { return i; }
+
+    uint32_t cell(uint32_t i) const { return (i < n) ? (*cells)[i] : (i == n) ? start : goal; }
+    int x(uint32_t i) const { return grid->x(cell(i)); }
+    int y(uint32_t i) const { return grid->y(cell(i)); }
+
+    template <typename Visitor>
+    void forEachEdge(uint32_t i, Visitor && visit) const
+    {
+        if (i == n)
+        {
+            for (auto const & link : *fromStart)
+            {
+                visit(link.node, link.cost);
+            }
+        }
+        else if (i < n)
+        {
+            abstract->forEachEdge(i, visit);
+            for (auto const & link : *toGoal)
+            {
+                if (link.node == i)
+                    visit(n + 1, link.cost);
+            }
+        }
+    }
+
+    GridGraph const * grid;
+    CompactGraph const * abstract;
+    std::vector<uint32_t> const * cells;
+    std::vector<Link> const * fromStart;
+    std::vector<Link> const * toGoal;
+    uint32_t n;
+    uint32_t start;
+    uint32_t goal;
+};
+
+//! @param  grid            Grid to search
+//! @param  clusterSize     Width and height of a cluster
+//! @param  policy          Configuration options for the searches of the grid and the abstract graph
+//!
+//! @note   All of the clusters are built here.
+
+HierarchicalPathFinder::HierarchicalPathFinder(GridGraph const & grid, int clusterSize, Policy const & policy)
+    : grid_(grid)
+    , clusterSize_(clusterSize)
+    , clustersX_((grid.width() + clusterSize - 1) / clusterSize)
+    , clustersY_((grid.height() + clusterSize - 1) / clusterSize)
+    , scale_(grid.minimumCostScale())
+    , clusters_((size_t)clustersX_ * clustersY_)
+    , borders_(clusters_.size() * 2)
+    , refiner_(grid, policy)
+{
+    assert(clusterSize > 1);
+    rebuild();
+}
+
+//! @param  grid    New grid, with the same dimensions as the old one
+
+void HierarchicalPathFinder::setGraph(GridGraph const & grid)
+{
+    assert(grid.width() == grid_.width() && grid.height() == grid_.height());
+    Policy policy = refiner_.policy();
+    grid_    = grid;
+    scale_   = grid.minimumCostScale();
+    refiner_ = GridPathFinder(grid, policy);
+}
+
+//! @param  x0, y0  First corner of the region
+//! @param  x1, y1  Opposite corner of the region
+//!
+//! @note   The clusters are rebuilt if they contain the region or are adjacent to it, because the costs of steps into
+//!         the region change too. A neighboring cluster that shares an entrance with a rebuilt cluster is also rebuilt
+//!         if the entrance changes.
+
+void HierarchicalPathFinder::update(int x0, int y0, int x1, int y1)
+{
+    if (x0 > x1)
+        std::swap(x0, x1);
+    if (y0 > y1)
+        std::swap(y0, y1);
+    x0 = std::max(x0 - 1, 0);
+    y0 = std::max(y0 - 1, 0);
+    x1 = std::min(x1 + 1, grid_.width() - 1);
+    y1 = std::min(y1 + 1, grid_.height() - 1);
+
+    int const cx0 = x0 / clusterSize_;
+    int const cy0 = y0 / clusterSize_;
+    int const cx1 = x1 / clusterSize_;
+    int const cy1 = y1 / clusterSize_;
+
+    // Rebuild the borders of the affected clusters, noting which clusters' entrances changed
+
+    std::vector<bool> dirty(clusters_.size(), false);
+    auto rebuildBorder = [&] (int cx, int cy, Border border) {
+        uint32_t c = (uint32_t)(cy * clustersX_ + cx);
+        std::vector<Transition> old = std::move(borders_[c * 2 + border]);
+        buildBorder(c, border);
+        if (borders_[c * 2 + border] != old)
+        {
+            dirty[c] = true;
+            dirty[(border == EAST) ? c + 1 : c + clustersX_] = true;
+        }
+    };
+
+    for (int cy = cy0; cy <= cy1; ++cy)
+    {
+        for (int cx = cx0; cx <= cx1; ++cx)
+        {
+            dirty[cy * clustersX_ + cx] = true;
+            rebuildBorder(cx, cy, EAST);
+            rebuildBorder(cx, cy, NORTH);
+            if (cx == cx0 && cx > 0)
+                rebuildBorder(cx - 1, cy, EAST);
+            if (cy == cy0 && cy > 0)
+                rebuildBorder(cx, cy - 1, NORTH);
+        }
+    }
+
+    for (uint32_t c = 0; c < clusters_.size(); ++c)
+    {
+        if (dirty[c])
+            buildCluster(c);
+    }
+    assemble();
+}
+
+void HierarchicalPathFinder::rebuild()
+{
+    for (uint32_t c = 0; c < clusters_.size(); ++c)
+    {
+        buildBorder(c, EAST);
+        buildBorder(c, NORTH);
+    }
+    for (uint32_t c = 0; c < clusters_.size(); ++c)
+    {
+        buildCluster(c);
+    }
+    assemble();
+}
+
+//! @param    start     Start cell
+//! @param    end       End cell
+//! @param    path      Resulting path
+//!
+//! @returns    true, if a path is found
+//!
+//! @note   The path is found in the abstract graph, and then each segment is refined. To refine the segments only as
+//!         they are needed, use findAbstractPath() and refine() instead.
+
+bool HierarchicalPathFinder::findPath(Vertex start, Vertex end, Path * path)
+{
+    assert(path);
+
+    Path waypoints;
+    if (!findAbstractPath(start, end, &waypoints))
+        return false;
+
+    path->clear();
+    path->push_back(start);
+
+    Path segment;
+    for (size_t i = 1; i < waypoints.size(); ++i)
+    {
+        if (!refine(waypoints[i - 1], waypoints[i], &segment))
+            return false;
+        path->insert(path->end(), segment.begin() + 1, segment.end());
+    }
+    return true;
+}
+
+//! @param    start     Start cell
+//! @param    end       End cell
+//! @param    waypoints Cells to pass through, starting with the start and ending with the end
+//!
+//! @returns    true, if a path is found
+//!
+//! @note   If the start and end are in the same cluster, the waypoints are just the start and end, and the result is
+//!         true. Whether there is a path is not known until the segment is refined.
+
+bool HierarchicalPathFinder::findAbstractPath(Vertex start, Vertex end, Path * waypoints)
+{
+    assert(waypoints);
+    assert(start < grid_.size() && end < grid_.size());
+
+    waypoints->clear();
+
+    uint32_t const startCluster = clusterOf(grid_.x(start), grid_.y(start));
+    uint32_t const endCluster   = clusterOf(grid_.x(end), grid_.y(end));
+    if (startCluster == endCluster)
+    {
+        waypoints->push_back(start);
+        waypoints->push_back(end);
+        return true;
+    }
+
+    link(startCluster, start, false, &fromStart_);
+    link(endCluster, end, true, &toGoal_);
+
+    uint32_t const n = abstract_.size();
+    QueryGraph query{ &grid_, &abstract_, &cells_, &fromStart_, &toGoal_, n, start, end };
+
+    Policy policy = refiner_.policy();
+    policy.bidirectional = false;
+    BasicPathFinder<QueryGraph, OctileHeuristic> search(query, policy, OctileHeuristic{ scale_ });
+
+    std::vector<uint32_t> nodes;
+    if (!search.findPath(context_, n, n + 1, &nodes))
+        return false;
+
+    for (uint32_t node : nodes)
+    {
+        uint32_t cell = query.cell(node);
+        if (waypoints->empty() || waypoints->back() != cell)
+            waypoints->push_back(cell);
+    }
+    return true;
+}
+
+//! @param    from      A cell of an abstract path
+//! @param    to        The next cell of the abstract path
+//! @param    path      Path from one to the other, including both
+//!
+//! @returns    true, if a path is found
+
+bool HierarchicalPathFinder::refine(Vertex from, Vertex to, Path * path)
+{
+    return refiner_.findPath(from, to, path);
+}
+
+void HierarchicalPathFinder::buildBorder(uint32_t cluster, Border border)
+{
+    std::vector<Transition> & transitions = borders_[cluster * 2 + border];
+    transitions.clear();
+
+    int const cx = (int)(cluster % (uint32_t)clustersX_);
+    int const cy = (int)(cluster / (uint32_t)clustersX_);
+    if ((border == EAST && cx + 1 >= clustersX_) || (border == NORTH && cy + 1 >= clustersY_))
+        return;
+
+    // The border is the last column or row of the cluster. (x, y) walks along it and (dx, dy) steps across it.
+
+    int const dx    = (border == EAST) ? 1 : 0;
+    int const dy    = (border == NORTH) ? 1 : 0;
+    int const first = (border == EAST) ? cy * clusterSize_ : cx * clusterSize_;
+    int const last  = std::min(first + clusterSize_, (border == EAST) ? grid_.height() : grid_.width()) - 1;
+    int const fixed = (border == EAST) ? (cx + 1) * clusterSize_ - 1 : (cy + 1) * clusterSize_ - 1;
+
+    auto cell = [&] (int i, int across) {
+        return (border == EAST) ? grid_.cell(fixed + across, i) : grid_.cell(i, fixed + across);
+    };
+    auto open = [&] (int i) {
+        return (border == EAST) ? grid_.passable(fixed, i) && grid_.passable(fixed + dx, i)
+                                : grid_.passable(i, fixed) && grid_.passable(i, fixed + dy);
+    };
+
+    // Find each run of cells that are passable on both sides, and place the transitions
+
+    for (int i = first; i <= last; ++i)
+    {
+        if (!open(i))
+            continue;
+
+        int begin = i;
+        while (i < last && open(i + 1))
+        {
+            ++i;
+        }
+        int end = i;
+
+        if (end - begin + 1 >= LONG_ENTRANCE)
+        {
+            transitions.push_back({ cell(begin, 0), cell(begin, 1) });
+            transitions.push_back({ cell(end, 0), cell(end, 1) });
+        }
+        else
+        {
+            int middle = (begin + end) / 2;
+            transitions.push_back({ cell(middle, 0), cell(middle, 1) });
+        }
+    }
+}
+
+void HierarchicalPathFinder::buildCluster(uint32_t cluster)
+{
+    Cluster & c = clusters_[cluster];
+    c.cells.clear();
+    c.edges.clear();
+
+    // The abstract nodes are the cells of the transitions across all four borders
+
+    int const cx = (int)(cluster % (uint32_t)clustersX_);
+    int const cy = (int)(cluster / (uint32_t)clustersX_);
+    for (auto const & t : borders_[cluster * 2 + EAST])
+    {
+        c.cells.push_back(t.inside);
+    }
+    for (auto const & t : borders_[cluster * 2 + NORTH])
+    {
+        c.cells.push_back(t.inside);
+    }
+    if (cx > 0)
+    {
+        for (auto const & t : borders_[(cluster - 1) * 2 + EAST])
+        {
+            c.cells.push_back(t.outside);
+        }
+    }
+    if (cy > 0)
+    {
+        for (auto const & t : borders_[(cluster - clustersX_) * 2 + NORTH])
+        {
+            c.cells.push_back(t.outside);
+        }
+    }
+    std::sort(c.cells.begin(), c.cells.end());
+    c.cells.erase(std::unique(c.cells.begin(), c.cells.end()), c.cells.end());
+
+    // Find the cost of the shortest path within the cluster from each abstract node to the others
+
+    int const x0 = cx * clusterSize_;
+    int const y0 = cy * clusterSize_;
+    int const x1 = std::min(x0 + clusterSize_, grid_.width()) - 1;
+    int const y1 = std::min(y0 + clusterSize_, grid_.height()) - 1;
+
+    for (uint32_t from : c.cells)
+    {
+        size_t remaining = c.cells.size();
+        searchRegion(grid_, context_, x0, y0, x1, y1, from, false, [&] (uint32_t cell, float cost) {
+            if (std::binary_search(c.cells.begin(), c.cells.end(), cell))
+            {
+                if (cell != from)
+                    c.edges.push_back({ from, cell, cost });
+                --remaining;
+            }
+            return remaining > 0;
+        });
+    }
+}
+
+void HierarchicalPathFinder::assemble()
+{
+    cells_.clear();
+    ids_.clear();
+    for (auto const & c : clusters_)
+    {
+        for (uint32_t cell : c.cells)
+        {
+            ids_.emplace(cell, (uint32_t)cells_.size());
+            cells_.push_back(cell);
+        }
+    }
+
+    // Edges within the clusters, plus the steps across the borders in both directions
+
+    std::vector<CompactGraph::Edge> edges;
+    for (auto const & c : clusters_)
+    {
+        for (auto const & e : c.edges)
+        {
+            edges.push_back({ ids_[e.from], ids_[e.to], e.cost });
+        }
+    }
+    for (auto const & transitions : borders_)
+    {
+        for (auto const & t : transitions)
+        {
+            uint32_t inside  = ids_[t.inside];
+            uint32_t outside = ids_[t.outside];
+            edges.push_back({ inside, outside, grid_.stepCost(t.inside, t.outside, false) });
+            edges.push_back({ outside, inside, grid_.stepCost(t.outside, t.inside, false) });
+        }
+    }
+
+    abstract_ = CompactGraph((uint32_t)cells_.size(), edges);
+}
+
+void HierarchicalPathFinder::link(uint32_t cluster, uint32_t cell, bool reverse, std::vector<Link> * links)
+{
+    links->clear();
+
+    Cluster const & c = clusters_[cluster];
+    int const cx = (int)(cluster % (uint32_t)clustersX_);
+    int const cy = (int)(cluster / (uint32_t)clustersX_);
+    int const x0 = cx * clusterSize_;
+    int const y0 = cy * clusterSize_;
+    int const x1 = std::min(x0 + clusterSize_, grid_.width()) - 1;
+    int const y1 = std::min(y0 + clusterSize_, grid_.height()) - 1;
+
+    size_t remaining = c.cells.size();
+    if (remaining == 0)
+        return;
+
+    searchRegion(grid_, context_, x0, y0, x1, y1, cell, reverse, [&] (uint32_t settled, float cost) {
+        if (std::binary_search(c.cells.begin(), c.cells.end(), settled))
+        {
+            links->push_back({ ids_[settled], cost });
+            --remaining;
+        }
+        return remaining > 0;
+    });
+}
@@ -0,0 +1,3 @@
+#include "IncrementalPathFinder.h"
+
+template class BasicIncrementalPathFinder<NodeGraph, NodeHeuristic, EdgeCost>;
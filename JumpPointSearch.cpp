@@ -0,0 +1,396 @@
+#include "JumpPointSearch.h"
+
+#include "OpenList.h"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstdlib>
+
+// Directions 0-3 are straight (east, west, north, south) and 4-7 are diagonal
+int const JumpPointSearch::DX[8] = { 1, -1, 0, 0, 1, -1, 1, -1 };
+int const JumpPointSearch::DY[8] = { 0, 0, 1, -1, 1, 1, -1, -1 };
+
+namespace
+{
+    // Returns the cost of a straight or diagonal run of steps from (x0, y0) to (x1, y1). It is also the heuristic.
+    float octile(int x0, int y0, int x1, int y1)
+    {
+        int dx = std::abs(x1 - x0);
+        int dy = std::abs(y1 - y0);
+        return float(std::max(dx, dy)) + (GridGraph::SQRT2 - 1.0f) * float(std::min(dx, dy));
+    }
+
+    int sign(int x) { return (x > 0) - (x < 0); }
+}
+
+//! @param  grid    Grid to search. It must have uniform costs and must not allow diagonal steps to cut corners.
+//! @param  mode    JPS or JPS+
+//!
+//! @note   In JPS+ mode, the jump distances are computed here.
+
+JumpPointSearch::JumpPointSearch(GridGraph const & grid, Mode mode)
+    : grid_(grid)
+    , mode_(mode)
+{
+    assert(grid_.uniform() && !grid_.cutCorners());
+    if (mode_ == Mode::JPS_PLUS)
+        precompute();
+}
+
+//! For each passable cell and each direction, the table holds the distance to the next cell at which a search moving
+//! in that direction would stop, ignoring the goal. If there is no such cell, it holds the negated number of steps that
+//! can be taken before reaching a wall. Each entry depends only on the entry of the next cell in the same direction, so
+//! the whole table is built in 8 sweeps.
+
+void JumpPointSearch::precompute()
+{
+    assert(grid_.width() <= SHRT_MAX && grid_.height() <= SHRT_MAX);
+
+    int const width  = grid_.width();
+    int const height = grid_.height();
+    distances_.assign((size_t)grid_.size() * 8, 0);
+
+    auto distance = [&] (int x, int y, int d) -> int16_t & { return distances_[(size_t)grid_.cell(x, y) * 8 + d]; };
+
+    // The straight directions must be done first, because the diagonal directions depend on them.
+    for (int d = 0; d < 8; ++d)
+    {
+        int const dx = DX[d];
+        int const dy = DY[d];
+
+        // Visit the cells so that the next cell in the direction has already been visited
+        int const x0 = (dx > 0) ? width - 1 : 0;
+        int const y0 = (dy > 0) ? height - 1 : 0;
+        int const sx = (dx > 0) ? -1 : 1;
+        int const sy = (dy > 0) ? -1 : 1;
+
+        for (int y = y0; y >= 0 && y < height; y += sy)
+        {
+            for (int x = x0; x >= 0 && x < width; x += sx)
+            {
+                int const nx = x + dx;
+                int const ny = y + dy;
+
+                bool stop;
+                if (d < 4)
+                {
+                    if (!passable(nx, ny))
+                        continue;
+                    stop = forced(nx, ny, dx, dy);
+                }
+                else
+                {
+                    if (!passable(nx, ny) || !passable(nx, y) || !passable(x, ny))
+                        continue;
+                    stop = distance(nx, ny, direction(dx, 0)) > 0 || distance(nx, ny, direction(0, dy)) > 0;
+                }
+
+                int16_t next = distance(nx, ny, d);
+                distance(x, y, d) = stop ? 1 : (next > 0) ? next + 1 : next - 1;
+            }
+        }
+    }
+}
+
+//! @param    x0, y0    Start cell
+//! @param    x1, y1    End cell
+//! @param    path      Resulting path
+//!
+//! @returns    true, if a path is found
+//!
+//! @note   This function uses a context owned by the pathfinder, so it cannot be called concurrently.
+//! @note   A cell outside the grid is an error, asserted in debug builds. In release builds, no path is found.
+
+bool JumpPointSearch::findPath(int x0, int y0, int x1, int y1, Path * path)
+{
+    assert(grid_.contains(x0, y0) && grid_.contains(x1, y1));
+    if (!grid_.contains(x0, y0) || !grid_.contains(x1, y1))
+    {
+        context_.begin(grid_.size());
+        return false;
+    }
+    return findPath(context_, grid_.cell(x0, y0), grid_.cell(x1, y1), path);
+}
+
+//! @param    start     Start cell
+//! @param    end       End cell
+//! @param    path      Resulting path
+//!
+//! @returns    true, if a path is found
+//!
+//! @note   This function uses a context owned by the pathfinder, so it cannot be called concurrently.
+
+bool JumpPointSearch::findPath(Vertex start, Vertex end, Path * path)
+{
+    return findPath(context_, start, end, path);
+}
+
+//! @param    context   State of the search
+//! @param    start     Start cell
+//! @param    end       End cell
+//! @param    path      Resulting path. It contains every cell, not just the jump points.
+//!
+//! @returns    true, if a path is found
+//!
+//! @note   Only the jump points are visited, so the cost of the path is context.g(end), the same as A*. This function
+//!         can be called concurrently as long as each call uses a different context.
+//! @note   A cell outside the grid is an error, asserted in debug builds. In release builds, no path is found.
+
+bool JumpPointSearch::findPath(Context & context, Vertex start, Vertex end, Path * path) const
+{
+    assert(path);
+    assert(start < grid_.size() && end < grid_.size());
+    assert(mode_ != Mode::JPS_PLUS || distances_.size() == (size_t)grid_.size() * 8);
+
+    // A cell that is not in the grid cannot be reached
+    if (start >= grid_.size() || end >= grid_.size())
+    {
+        context.begin(grid_.size());
+        return false;
+    }
+
+    int const gx = grid_.x(end);
+    int const gy = grid_.y(end);
+
+    IndexedHeapOpenList<uint32_t, SearchContextAccess> open(SearchContextAccess{ &context });
+
+    context.begin(grid_.size());
+    context.open(start, 0.f, octile(grid_.x(start), grid_.y(start), gx, gy), SearchContext::NONE);
+    open.push(start);
+
+    while (!open.empty())
+    {
+        uint32_t current = open.top();
+
+        context.expand(current);
+        open.pop();
+
+        if (current == end)
+        {
+            constructPath(context, end, path);
+            return true;
+        }
+
+        int const x = grid_.x(current);
+        int const y = grid_.y(current);
+        float const g = context.g(current);
+
+        // The direction of travel is the direction from the predecessor, which may be several cells away
+        uint32_t predecessor = context.predecessor(current);
+        int dx = 0;
+        int dy = 0;
+        if (predecessor != SearchContext::NONE)
+        {
+            dx = sign(x - grid_.x(predecessor));
+            dy = sign(y - grid_.y(predecessor));
+        }
+
+        unsigned directions = successors(x, y, dx, dy);
+        for (int d = 0; d < 8; ++d)
+        {
+            if ((directions & (1u << d)) == 0)
+                continue;
+
+            uint32_t neighbor = (mode_ == Mode::JPS_PLUS) ? jumpPlus(x, y, d, gx, gy) : jump(x, y, d, gx, gy);
+            if (neighbor == SearchContext::NONE || context.isClosed(neighbor))
+                continue;
+
+            int const nx = grid_.x(neighbor);
+            int const ny = grid_.y(neighbor);
+            float cost = g + octile(x, y, nx, ny);
+
+            if (!context.isOpen(neighbor))
+            {
+                context.open(neighbor, cost, octile(nx, ny, gx, gy), current);
+                open.push(neighbor);
+            }
+            else if (cost < context.g(neighbor))
+            {
+                context.update(neighbor, cost, current);
+                open.decrease(neighbor);
+            }
+        }
+    }
+
+    return false;
+}
+
+int JumpPointSearch::direction(int dx, int dy)
+{
+    if (dy == 0)
+        return (dx > 0) ? 0 : 1;
+    if (dx == 0)
+        return (dy > 0) ? 2 : 3;
+    return 4 + (dx < 0) + 2 * (dy < 0);
+}
+
+bool JumpPointSearch::forced(int x, int y, int dx, int dy) const
+{
+    // Because diagonal steps cannot cut corners, a neighbor is forced only when the cell beside the previous cell is
+    // blocked and the cell beside this one is not.
+    if (dx != 0)
+        return (passable(x, y - 1) && !passable(x - dx, y - 1)) || (passable(x, y + 1) && !passable(x - dx, y + 1));
+    else
+        return (passable(x - 1, y) && !passable(x - 1, y - dy)) || (passable(x + 1, y) && !passable(x + 1, y - dy));
+}
+
+unsigned JumpPointSearch::successors(int x, int y, int dx, int dy) const
+{
+    unsigned directions = 0;
+
+    // The start cell has no direction of travel, so every legal step is a successor
+    if (dx == 0 && dy == 0)
+    {
+        for (int d = 0; d < 8; ++d)
+        {
+            if (passable(x + DX[d], y + DY[d]) && passable(x + DX[d], y) && passable(x, y + DY[d]))
+                directions |= 1u << d;
+        }
+        return directions;
+    }
+
+    if (dx != 0 && dy != 0)
+    {
+        bool const h = passable(x + dx, y);
+        bool const v = passable(x, y + dy);
+        if (h)
+            directions |= 1u << direction(dx, 0);
+        if (v)
+            directions |= 1u << direction(0, dy);
+        if (h && v)
+            directions |= 1u << direction(dx, dy);
+    }
+    else
+    {
+        // Moving straight, the next cell is the natural neighbor. A cell to the side is a forced neighbor if the cell
+        // behind it is blocked (see forced()), and then so is the diagonal step past it.
+        bool const next = passable(x + dx, y + dy);
+        if (next)
+            directions |= 1u << direction(dx, dy);
+        for (int side : { -1, 1 })
+        {
+            int const sx = (dx != 0) ? 0 : side;
+            int const sy = (dx != 0) ? side : 0;
+            if (passable(x + sx, y + sy) && !passable(x + sx - dx, y + sy - dy))
+            {
+                directions |= 1u << direction(sx, sy);
+                if (next)
+                    directions |= 1u << direction(dx + sx, dy + sy);
+            }
+        }
+    }
+    return directions;
+}
+
+uint32_t JumpPointSearch::jump(int x, int y, int d, int gx, int gy) const
+{
+    int const dx = DX[d];
+    int const dy = DY[d];
+
+    for (;;)
+    {
+        // A diagonal step is legal only if both of the cells it cuts across are passable
+        if (d >= 4 && (!passable(x + dx, y) || !passable(x, y + dy)))
+            return SearchContext::NONE;
+
+        x += dx;
+        y += dy;
+        if (!passable(x, y))
+            return SearchContext::NONE;
+
+        if (x == gx && y == gy)
+            return grid_.cell(x, y);
+
+        if (d < 4)
+        {
+            if (forced(x, y, dx, dy))
+                return grid_.cell(x, y);
+        }
+        else
+        {
+            // Stop if a jump point can be reached by moving straight in either component of the direction
+            if (jump(x, y, direction(dx, 0), gx, gy) != SearchContext::NONE ||
+                jump(x, y, direction(0, dy), gx, gy) != SearchContext::NONE)
+            {
+                return grid_.cell(x, y);
+            }
+        }
+    }
+}
+
+uint32_t JumpPointSearch::jumpPlus(int x, int y, int d, int gx, int gy) const
+{
+    int const dx = DX[d];
+    int const dy = DY[d];
+    int const distance = distances_[(size_t)grid_.cell(x, y) * 8 + d];
+    int const reach    = std::abs(distance);
+
+    // Number of steps in each axis to the goal's column and row
+    int const kx = (gx - x) * dx;
+    int const ky = (gy - y) * dy;
+
+    if (d < 4)
+    {
+        // Stop at the goal if it is on the way
+        int k = (dx != 0) ? ((gy == y) ? kx : 0) : ((gx == x) ? ky : 0);
+        if (k > 0 && k <= reach)
+            return grid_.cell(gx, gy);
+        return (distance > 0) ? grid_.cell(x + distance * dx, y + distance * dy) : SearchContext::NONE;
+    }
+
+    // Moving diagonally, the search also stops at the goal, and at a cell from which the goal can be reached by moving
+    // straight. Of the candidate stops, the nearest is the jump point.
+
+    int best = (distance > 0) ? distance : INT_MAX;
+
+    if (kx == ky && kx > 0 && kx <= reach)
+        best = std::min(best, kx);
+
+    if (ky > 0 && ky <= reach && ky < best)
+    {
+        int rx = x + ky * dx;
+        int ry = y + ky * dy;
+        int k  = (gx - rx) * dx;
+        if (k > 0 && k <= std::abs(distances_[(size_t)grid_.cell(rx, ry) * 8 + direction(dx, 0)]))
+            best = ky;
+    }
+
+    if (kx > 0 && kx <= reach && kx < best)
+    {
+        int rx = x + kx * dx;
+        int ry = y + kx * dy;
+        int k  = (gy - ry) * dy;
+        if (k > 0 && k <= std::abs(distances_[(size_t)grid_.cell(rx, ry) * 8 + direction(0, dy)]))
+            best = kx;
+    }
+
+    return (best != INT_MAX) ? grid_.cell(x + best * dx, y + best * dy) : SearchContext::NONE;
+}
+
+void JumpPointSearch::constructPath(Context const & context, uint32_t to, Path * path) const
+{
+    path->clear();
+
+    // The jump points are linked from end to start. Fill in the cells between each one and its predecessor, and then
+    // reverse the path.
+
+    uint32_t i = to;
+    for (uint32_t predecessor = context.predecessor(i); predecessor != SearchContext::NONE; predecessor = context.predecessor(i))
+    {
+        int x  = grid_.x(i);
+        int y  = grid_.y(i);
+        int dx = sign(grid_.x(predecessor) - x);
+        int dy = sign(grid_.y(predecessor) - y);
+        for (uint32_t cell = i; cell != predecessor; cell = grid_.cell(x, y))
+        {
+            path->push_back(cell);
+            x += dx;
+            y += dy;
+        }
+        i = predecessor;
+    }
+    path->push_back(i);
+
+    std::reverse(path->begin(), path->end());
+}
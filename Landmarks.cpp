@@ -0,0 +1,101 @@
+#include "Landmarks.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+template class BasicPathFinder<NodeGraph, LandmarkHeuristic, EdgeCost>;
+
+//! @returns    the node whose shortest round trip to its nearest landmark is the longest
+//!
+//! @note   Nodes that cannot reach and cannot be reached from any landmark are ignored, so that isolated nodes are not
+//!         chosen.
+
+uint32_t Landmarks::selectFarthest() const
+{
+    uint32_t farthest = landmarks_.front();
+    float farthestDistance = 0.0f;
+    for (uint32_t i = 0; i < size_; ++i)
+    {
+        float const * d = &distances_[(size_t)i * stride_];
+        float nearest = INFINITY;
+        for (uint32_t k = 0; k < 2 * count(); k += 2)
+        {
+            float round = (std::isfinite(d[k]) ? d[k] : 0.0f) + (std::isfinite(d[k + 1]) ? d[k + 1] : 0.0f);
+            if (std::isfinite(d[k]) || std::isfinite(d[k + 1]))
+                nearest = std::min(nearest, round);
+        }
+        if (std::isfinite(nearest) && nearest > farthestDistance)
+        {
+            farthest = i;
+            farthestDistance = nearest;
+        }
+    }
+    return farthest;
+}
+
+//! @param  tree    Search from a random root
+//!
+//! @returns    the leaf reached by descending from the root into the subtree with the largest total error in the lower
+//!             bounds, among the subtrees without a landmark
+//!
+//! @note   If every subtree has a landmark, the farthest node is chosen instead.
+
+uint32_t Landmarks::selectAvoid(Search const & tree) const
+{
+    uint32_t const root = tree.order.front();
+
+    std::vector<bool> covered(size_, false);    // True if the subtree contains a landmark
+    for (uint32_t landmark : landmarks_)
+    {
+        covered[landmark] = true;
+    }
+
+    // Accumulate each subtree's error, from the leaves up. A node follows its predecessor in the settle order, so the
+    // subtrees are complete when they are added to their parents.
+
+    std::vector<double> error(size_, 0.0);
+    std::vector<uint32_t> best(size_, SearchContext::NONE); // Child with the largest subtree error
+    for (auto v = tree.order.rbegin(); v != tree.order.rend(); ++v)
+    {
+        uint32_t const i = *v;
+        error[i] = covered[i] ? 0.0 : error[i] + (tree.costs[i] - lowerBound(root, i));
+
+        uint32_t p = tree.predecessors[i];
+        if (p != SearchContext::NONE)
+        {
+            error[p] += error[i];
+            if (covered[i])
+                covered[p] = true;
+            if (best[p] == SearchContext::NONE || error[i] > error[best[p]])
+                best[p] = i;
+        }
+    }
+
+    // The root's own subtree always contains a landmark, so the descent starts at its children
+
+    uint32_t leaf = root;
+    while (best[leaf] != SearchContext::NONE && error[best[leaf]] > 0.0)
+    {
+        leaf = best[leaf];
+    }
+    return (leaf != root) ? leaf : selectFarthest();
+}
+
+//! @param  landmark    Node of the new landmark
+//! @param  from        Cost from the landmark to each node
+//! @param  to          Cost from each node to the landmark
+
+void Landmarks::add(uint32_t landmark, std::vector<float> const & from, std::vector<float> const & to)
+{
+    assert(landmarks_.size() < stride_ / 2);
+    assert(from.size() == size_ && to.size() == size_);
+
+    size_t const k = 2 * landmarks_.size();
+    for (uint32_t i = 0; i < size_; ++i)
+    {
+        distances_[(size_t)i * stride_ + k]     = from[i];
+        distances_[(size_t)i * stride_ + k + 1] = to[i];
+    }
+    landmarks_.push_back(landmark);
+}
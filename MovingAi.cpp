@@ -0,0 +1,111 @@
+#include "MovingAi.h"
+
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+namespace
+{
+    // Returns true if a map cell can be entered
+    bool isPassable(int c)
+    {
+        return c == '.' || c == 'G' || c == 'S';
+    }
+}
+
+//! @param  path    Path of the map file
+//!
+//! @returns    true, if the map was loaded
+
+bool MovingAiMap::load(char const * path)
+{
+    std::FILE * file = std::fopen(path, "r");
+    if (!file)
+        return false;
+
+    // The header is a list of "key value" pairs ending with the keyword "map"
+    char key[32];
+    char type[32] = "";
+    int w = 0;
+    int h = 0;
+    bool ok = false;
+    while (std::fscanf(file, "%31s", key) == 1)
+    {
+        if (std::strcmp(key, "map") == 0)
+        {
+            ok = true;
+            break;
+        }
+        bool const read = (std::strcmp(key, "type") == 0)   ? std::fscanf(file, "%31s", type) == 1
+                        : (std::strcmp(key, "height") == 0) ? std::fscanf(file, "%d", &h) == 1
+                        : (std::strcmp(key, "width") == 0)  ? std::fscanf(file, "%d", &w) == 1
+                                                            : false;
+        if (!read)
+            break;
+    }
+    if (!ok || std::strcmp(type, "octile") != 0 || w <= 0 || h <= 0)
+    {
+        std::fclose(file);
+        return false;
+    }
+
+    // The rows follow, one per line
+    std::vector<uint8_t> cells((size_t)w * h);
+    size_t n = 0;
+    for (int c; n < cells.size() && (c = std::fgetc(file)) != EOF;)
+    {
+        if (c != '\n' && c != '\r')
+            cells[n++] = isPassable(c) ? 1 : 0;
+    }
+    std::fclose(file);
+    if (n < cells.size())
+        return false;
+
+    width    = w;
+    height   = h;
+    passable = std::move(cells);
+    return true;
+}
+
+//! @param  path    Path of the scenario file
+//!
+//! @returns    true, if the scenario was loaded
+//!
+//! @note   Map names containing spaces are not supported.
+
+bool MovingAiScenario::load(char const * path)
+{
+    std::FILE * file = std::fopen(path, "r");
+    if (!file)
+        return false;
+
+    std::vector<Experiment> loaded;
+    char line[4096];
+    char map[4096];
+    bool ok = true;
+    for (int number = 0; std::fgets(line, sizeof(line), file); ++number)
+    {
+        float version;
+        if (number == 0 && std::sscanf(line, " version %f", &version) == 1)
+            continue;
+        char end;
+        if (std::sscanf(line, " %c", &end) != 1)
+            continue;   // Blank line
+
+        Experiment e;
+        if (std::sscanf(line, "%d %4095s %d %d %d %d %d %d %lf", &e.bucket, map, &e.mapWidth, &e.mapHeight, &e.startX,
+                        &e.startY, &e.goalX, &e.goalY, &e.optimal) != 9)
+        {
+            ok = false;
+            break;
+        }
+        e.map = map;
+        loaded.push_back(std::move(e));
+    }
+    std::fclose(file);
+    if (!ok)
+        return false;
+
+    experiments = std::move(loaded);
+    return true;
+}
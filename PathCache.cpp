@@ -0,0 +1,209 @@
+#include "PathCache.h"
+
+#include <algorithm>
+#include <cassert>
+
+// A cached path
+struct PathCache::Entry
+{
+    uint32_t goal;
+    uint64_t version;
+    size_t bytes;                   // Memory counted for the path
+    std::vector<uint32_t> path;
+};
+
+// Where a node appears in a cached path to a goal
+struct PathCache::Location
+{
+    std::list<Entry>::iterator entry;
+    uint32_t position;
+};
+
+// The paths to a subset of the goals
+struct PathCache::Shard
+{
+    std::mutex mutex;                                   // Guards the following
+    std::list<Entry> entries;                           // Most recently used first
+    std::unordered_map<uint64_t, Location> locations;   // Location of each (node, goal) pair
+    size_t bytes = 0;                                   // Memory counted for the entries
+};
+
+namespace
+{
+    uint64_t key(uint32_t node, uint32_t goal)
+    {
+        return ((uint64_t)node << 32) | goal;
+    }
+}
+
+//! @param  maxBytes    Memory budget
+//! @param  shards      Number of independently locked shards. More shards reduce contention, but each one gets a
+//!                     smaller part of the budget, which limits the length of the paths it can hold.
+
+PathCache::PathCache(size_t maxBytes, unsigned shards)
+    : shards_(new Shard[std::max(1u, shards)])
+    , shardCount_(std::max(1u, shards))
+    , maxShardBytes_(maxBytes / std::max(1u, shards))
+{
+}
+
+PathCache::~PathCache() = default;
+
+//! @param  start       Start node index
+//! @param  goal        Goal node index
+//! @param  version     Version of the graph
+//! @param  path        Path from start to goal, including both, if it is cached
+//!
+//! @returns    true, if the path is cached
+//!
+//! @note   A path found for another version of the graph is removed.
+
+bool PathCache::find(uint32_t start, uint32_t goal, uint64_t version, std::vector<uint32_t> * path)
+{
+    assert(path);
+
+    Shard & shard = shardOf(goal);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto location = shard.locations.find(key(start, goal));
+    if (location == shard.locations.end())
+    {
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    auto const entry = location->second.entry;
+    uint32_t const position = location->second.position;
+    if (entry->version != version)
+    {
+        erase(shard, entry);
+        stale_.fetch_add(1, std::memory_order_relaxed);
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    shard.entries.splice(shard.entries.begin(), shard.entries, entry);
+    path->assign(entry->path.begin() + position, entry->path.end());
+    (position == 0 ? hits_ : suffixHits_).fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+//! @param  path        Path of node indexes, from the start to the goal. It must be a shortest path, or its suffixes
+//!                     could be returned for other starts when they are not the shortest.
+//! @param  version     Version of the graph the path was found in
+//!
+//! @note   A path too long to fit in a shard's share of the budget is not added.
+
+void PathCache::insert(Span<uint32_t const> path, uint64_t version)
+{
+    assert(path.size() > 0);
+
+    uint32_t const goal  = path[path.size() - 1];
+    size_t const   bytes = estimateBytes(path.size());
+    if (bytes > maxShardBytes_)
+        return;
+
+    Shard & shard = shardOf(goal);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // If the path from the start is already cached for this version, just mark it as used. A path for another version
+    // is replaced.
+    auto existing = shard.locations.find(key(path[0], goal));
+    if (existing != shard.locations.end())
+    {
+        auto const entry = existing->second.entry;
+        if (entry->version == version)
+        {
+            shard.entries.splice(shard.entries.begin(), shard.entries, entry);
+            return;
+        }
+        erase(shard, entry);
+        stale_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    shard.entries.push_front(Entry{ goal, version, bytes, std::vector<uint32_t>(path.begin(), path.end()) });
+    auto const entry = shard.entries.begin();
+    shard.bytes += bytes;
+    insertions_.fetch_add(1, std::memory_order_relaxed);
+
+    // Index each node of the path, unless it is already on another current path to the same goal
+    for (uint32_t i = 0; i < (uint32_t)path.size(); ++i)
+    {
+        auto result = shard.locations.try_emplace(key(path[i], goal), Location{ entry, i });
+        if (!result.second && result.first->second.entry->version != version)
+            result.first->second = Location{ entry, i };
+    }
+
+    while (shard.bytes > maxShardBytes_)
+    {
+        erase(shard, std::prev(shard.entries.end()));
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void PathCache::clear()
+{
+    for (unsigned s = 0; s < shardCount_; ++s)
+    {
+        Shard & shard = shards_[s];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.locations.clear();
+        shard.entries.clear();
+        shard.bytes = 0;
+    }
+}
+
+//! @note   The counters are read individually, so they may be slightly inconsistent with each other while other threads
+//!         use the cache.
+
+PathCache::Stats PathCache::stats() const
+{
+    Stats stats{};
+    stats.hits       = hits_.load(std::memory_order_relaxed);
+    stats.suffixHits = suffixHits_.load(std::memory_order_relaxed);
+    stats.misses     = misses_.load(std::memory_order_relaxed);
+    stats.stale      = stale_.load(std::memory_order_relaxed);
+    stats.insertions = insertions_.load(std::memory_order_relaxed);
+    stats.evictions  = evictions_.load(std::memory_order_relaxed);
+    for (unsigned s = 0; s < shardCount_; ++s)
+    {
+        Shard & shard = shards_[s];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        stats.paths += shard.entries.size();
+        stats.bytes += shard.bytes;
+    }
+    return stats;
+}
+
+//! @param  length  Number of nodes in the path
+//!
+//! @returns    the memory counted for a path, including the list node holding it and an index entry for each of its
+//!             nodes
+
+size_t PathCache::estimateBytes(size_t length)
+{
+    // Each list and hash table node is assumed to carry two pointers of overhead
+    size_t const entryBytes = sizeof(Entry) + 2 * sizeof(void *);
+    size_t const nodeBytes  = sizeof(uint32_t) + sizeof(std::pair<uint64_t const, Location>) + 2 * sizeof(void *);
+    return entryBytes + length * nodeBytes;
+}
+
+PathCache::Shard & PathCache::shardOf(uint32_t goal) const
+{
+    // Mix the bits so that goals on a regular pattern are spread over the shards
+    uint32_t const hash = goal * 0x9E3779B1u;
+    return shards_[(hash >> 16) % shardCount_];
+}
+
+void PathCache::erase(Shard & shard, std::list<Entry>::iterator entry)
+{
+    // Remove only the index entries that refer to this path. The others belong to other paths through the same nodes.
+    for (uint32_t node : entry->path)
+    {
+        auto location = shard.locations.find(key(node, entry->goal));
+        if (location != shard.locations.end() && location->second.entry == entry)
+            shard.locations.erase(location);
+    }
+    shard.bytes -= entry->bytes;
+    shard.entries.erase(entry);
+}
@@ -0,0 +1,4 @@
+#include "SlicedSearch.h"
+
+template class BasicSlicedSearch<NodeGraph, NodeHeuristic, EdgeCost>;
+template class SearchScheduler<SlicedSearch>;
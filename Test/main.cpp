@@ -15,6 +15,7 @@
 #include <cstdlib>
 #include <sstream>
 #include <cmath>
+#include <vector>
 
 #define WIN32_LEAN_AND_MEAN
 #define NOMINMAX
@@ -42,7 +43,9 @@
 #include "HeightField/HeightField.h"
 #include "Water/Water.h"
 
-#include "../PathFinder.h"
+#include "PathFinder/GridPathFinder.h"
+#include "PathFinder/HeightFieldGraph.h"
+#include "PathFinder/ThreadPool.h"
 
 int const	WATER_TO_LAND_RATIO	= 4;
 int const	PATH_TO_LAND_RATIO	= 4;
@@ -64,9 +67,7 @@ static void DrawTerrain();
 static Vector3f ComputeNormal( HeightField const & hf, int x, int y );
 static void ComputeNormals( HeightField const & hf, Vector3f * paNormals );
 
-static float ComputeTerrainCost( int fx, int fy, int tx, int ty );
 static void ComputePath( int fx, int fy, int tx, int ty );
-static void InitializeEdge( PathFinder::Edge * pEdge, int x0, int y0, int x1, int y1, int sx, int sy );
 static void Drawpath();
 
 static char						s_aAppName[]	= "Path Finder";
@@ -95,7 +96,7 @@ static float					s_DownhillCost				= .5f;
 static float					s_UphillCost				= 1.f;
 
 static Random					s_Random( timeGetTime() );
-static PathFinder::Path			s_Path;
+static GridPathFinder::Path		s_Path;
 
 static inline int PSizeX()
 {
@@ -756,37 +757,9 @@ static Vector3f ComputeNormal( HeightField const & hf, int x, int y )
 /*																													*/
 /********************************************************************************************************************/
 
-class TerrainPathFindingNode : public PathFinder::Node
-{
-public:
-		// Return the estimated cost from this node to the goal. This value
-		// is assumed to be constant.
-	virtual float	h( PathFinder::Node const & goal ) const { return m_DistanceToGoal; }
-	
-	//	// Update pathfinding values for the node
-	//	void Update( float predCost, float edgeCost, Node * pPred );
-	//
-	//	// Anticipate being added to the open queue
-	//	void Open( float predCost, float edgeCost, Node * pPred, Node const & goal );
-	//
-	//	// Returns true if the node is open.
-	//	bool IsOpen() const		{ return m_Status == NS_OPEN; }
-	//
-	//	// Anticipate being closed.
-	//	void Close();
-	//
-	//	// Returns true if the node is closed
-	//	bool IsClosed() const	{ return m_Status == NS_CLOSED; }
-	//
-	//	// Reset the node's status to not visited
-	//	void ResetNodeStatus();
-
-	float m_DistanceToGoal;
-};
-
-
-static TerrainPathFindingNode *	s_pNodeData	= 0;
-static PathFinder::Edge *		s_pEdgeData	= 0;
+static std::vector< float >		s_TerrainHeights;
+static ThreadPool *				s_pThreadPool;
+static HeightFieldBuilder *		s_pPathBuilder;
 
 
 /********************************************************************************************************************/
@@ -796,117 +769,52 @@ static PathFinder::Edge *		s_pEdgeData	= 0;
 
 static void ComputePath( int fx, int fy, int tx, int ty )
 {
-	int const	sx				= PSizeX();
-	int const	sy				= PSizeY();
-	int const	nNodes			= sx * sy;
-
-	PathFinder	pf( nNodes );
-	delete[] s_pNodeData;
-	delete[] s_pEdgeData;
+	HeightFieldBuilder::Settings	settings;
 
-	s_pNodeData = new TerrainPathFindingNode[ nNodes ];
-	s_pEdgeData = new PathFinder::Edge[ nNodes * 8 ];
+	settings.stride		= PATH_TO_LAND_RATIO;
+	settings.margin		= 1;
+	settings.seaLevel	= float( s_SeaLevel );
+	settings.uphill		= s_UphillCost;
+	settings.downhill	= s_DownhillCost;
+	settings.cutCorners	= true;
 
-	int			x, y;
+	// The terrain does not change, so its heights are copied once and the graph is built from them. Cells below sea
+	// level are impassable.
 
-	// Build the pathfinder graph edge data
-
-	for ( y = 0; y < sy; y++ )
+	if ( !s_pPathBuilder )
 	{
-		for ( x = 0; x < sx; x++ )
-		{
-			PathFinder::Edge * const	pEL	= &s_pEdgeData[ ( y * sx + x ) * 8 ];
-
-			InitializeEdge( pEL + 0, x, y, x-1, y+1, sx, sy );
-			InitializeEdge( pEL + 1, x, y, x  , y+1, sx, sy );
-			InitializeEdge( pEL + 2, x, y, x+1, y+1, sx, sy );
-			InitializeEdge( pEL + 3, x, y, x-1, y  , sx, sy );
-			InitializeEdge( pEL + 4, x, y, x+1, y  , sx, sy );
-			InitializeEdge( pEL + 5, x, y, x-1, y-1, sx, sy );
-			InitializeEdge( pEL + 6, x, y, x  , y-1, sx, sy );
-			InitializeEdge( pEL + 7, x, y, x+1, y-1, sx, sy );
+		int const	sx	= s_pTerrain->GetSizeX();
+		int const	sy	= s_pTerrain->GetSizeY();
 
-		}
-	}
-
-	// Build the pathfinding graph node data
-
-	for ( y = 0; y < sy; y++ )
-	{
-		for ( x = 0; x < sx; x++ )
+		s_TerrainHeights.resize( sx * sy );
+		for ( int y = 0; y < sy; y++ )
 		{
-			// Add the edges to the node
-
-			PathFinder::Edge * const		pEL	= &s_pEdgeData[ ( y * sx + x ) * 8 ];
-			TerrainPathFindingNode * const	pN	= &s_pNodeData[ y * sx + x ];
-
-			pN->m_DistanceToGoal = ( Vector2f( tx, ty ) - Vector2f( x, y ) ).Length();
-			pN->m_AdjacencyList.reserve( 8 );
-
-			for ( int i = 0; i < 8; i++ )
+			for ( int x = 0; x < sx; x++ )
 			{
-				if ( pEL[ i ].m_pTo != 0 )
-				{
-					pN->m_AdjacencyList.push_back( &pEL[ i ] );
-				}
+				s_TerrainHeights[ y * sx + x ] = s_pTerrain->GetZ( x, y );
 			}
-
-			// Add the node to the graph
-
-			pf.m_ConnectivityGraph[ y * sx + x ] = pN;
 		}
-	}
-
-	pf.FindPath( &s_pNodeData[ T2P( fy ) * sx + T2P( fx ) ],
-				 &s_pNodeData[ T2P( ty ) * sx + T2P( tx ) ],
-				 &s_Path );
-}
 
+		s_pThreadPool	= new ThreadPool;
+		s_pPathBuilder	= new HeightFieldBuilder( &s_TerrainHeights[ 0 ], sx, sy, settings );
+		s_pPathBuilder->build( s_pThreadPool );
+	}
 
-/********************************************************************************************************************/
-/*																													*/
-/*																													*/
-/********************************************************************************************************************/
+	// The graph is rebuilt only if the sea level or the costs have changed
 
-void InitializeEdge( PathFinder::Edge * pEdge, int x0, int y0, int x1, int y1, int sx, int sy )
-{
-	int const	wx		= P2T( x1 );
-	int const	wy		= P2T( y1 );
+	HeightFieldBuilder::Settings const &	current	= s_pPathBuilder->settings();
 
-	if ( x1 >= 0 && x1 < sx &&
-		 y1 >= 0 && y1 < sy &&
-		 s_pTerrain->GetZ( wx, wy ) >= s_SeaLevel )
-	{
-		pEdge->m_pTo = &s_pNodeData[ y1 * sx + x1 ];
-		pEdge->m_Cost = ComputeTerrainCost( x0, y0, x1 , y1 );
-	}
-	else
+	if ( current.seaLevel != settings.seaLevel || current.uphill != settings.uphill || current.downhill != settings.downhill )
 	{
-		pEdge->m_pTo = 0;
+		s_pPathBuilder->setSettings( settings );
+		s_pPathBuilder->build( s_pThreadPool );
 	}
-}
-
 
-/********************************************************************************************************************/
-/*																													*/
-/*																													*/
-/********************************************************************************************************************/
-
-static float ComputeTerrainCost( int fx, int fy, int tx, int ty )
-{
-	float const	fz	= s_pTerrain->GetZ( P2T( fx ), P2T( fy ) );
-	float const	tz	= s_pTerrain->GetZ( P2T( tx ), P2T( ty ) );
+	HeightFieldGraph const	graph	= s_pPathBuilder->graph();
 
-	float const	dxy	= ( Vector2f( tx, ty ) - Vector2f( fx, fy ) ).Length();
+	BasicPathFinder< HeightFieldGraph, OctileHeuristic >	pf( graph, SearchPolicy{ 0 }, OctileHeuristic{ graph.minimumCostScale() } );
 
-	if ( fz < tz )
-	{
-		return dxy * ( 1.f + ( tz - fz ) * s_UphillCost );
-	}
-	else
-	{
-		return dxy * ( 1.f + ( fz - tz ) * s_DownhillCost );
-	}
+	pf.findPath( graph.cell( T2P( fx ), T2P( fy ) ), graph.cell( T2P( tx ), T2P( ty ) ), &s_Path );
 }
 
 
@@ -925,13 +833,12 @@ static void DrawPath()
 
 	glTranslatef( -( s_pTerrain->GetSizeX() - 1 ) * XY_SCALE * .5f, -( s_pTerrain->GetSizeY() - 1 ) * XY_SCALE * .5f, 0.f );
 
-	for ( PathFinder::Path::reverse_iterator p = s_Path.rbegin(); p != s_Path.rend(); ++p )
+	for ( GridPathFinder::Path::reverse_iterator p = s_Path.rbegin(); p != s_Path.rend(); ++p )
 	{
 		glPushMatrix();
 
-		TerrainPathFindingNode * const pN	= static_cast< TerrainPathFindingNode * >( *p );
-		int const	y	= P2T( ( pN - s_pNodeData ) / PSizeX() ); 
-		int const	x	= P2T( ( pN - s_pNodeData ) % PSizeX() ); 
+		int const	y	= P2T( *p / PSizeX() ); 
+		int const	x	= P2T( *p % PSizeX() ); 
 		
 		glTranslatef( x * XY_SCALE, y * XY_SCALE, s_pTerrain->GetZ( x, y ) );
 		auxSolidSphere( XY_SCALE );
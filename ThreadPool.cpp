@@ -0,0 +1,150 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+
+//! @param  workers     Number of workers, including the thread that calls run() (or 0 for one per hardware thread)
+
+ThreadPool::ThreadPool(unsigned workers)
+    : size_(workers > 0 ? workers : std::max(1u, std::thread::hardware_concurrency()))
+    , queues_(new Queue[size_])
+{
+    threads_.reserve(size_ - 1);
+    for (unsigned worker = 1; worker < size_; ++worker)
+    {
+        threads_.emplace_back(&ThreadPool::loop, this, worker);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    started_.notify_all();
+    for (auto & thread : threads_)
+    {
+        thread.join();
+    }
+}
+
+//! @param  count   Number of tasks
+//! @param  call    Calls the task
+//! @param  task    Task to run for each index
+//!
+//! @note   Only one batch can run at a time, so run() must not be called concurrently or from within a task.
+
+void ThreadPool::execute(uint32_t count, Call call, void * task)
+{
+    if (count == 0)
+        return;
+
+    // Split the tasks evenly between the workers
+
+    for (unsigned worker = 0; worker < size_; ++worker)
+    {
+        Queue & queue = queues_[worker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.begin = (uint32_t)((uint64_t)count * worker / size_);
+        queue.end   = (uint32_t)((uint64_t)count * (worker + 1) / size_);
+    }
+
+    // Start the worker threads, and then work alongside them
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        call_ = call;
+        task_ = task;
+        busy_ = size_ - 1;
+        ++batch_;
+    }
+    started_.notify_all();
+
+    work(0);
+
+    // The batch is done when every worker thread has run out of tasks
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    finished_.wait(lock, [this] { return busy_ == 0; });
+    call_ = nullptr;
+    task_ = nullptr;
+}
+
+void ThreadPool::loop(unsigned worker)
+{
+    uint64_t batch = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            started_.wait(lock, [&] { return stop_ || batch_ != batch; });
+            if (stop_)
+                return;
+            batch = batch_;
+        }
+
+        work(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --busy_;
+        }
+        finished_.notify_one();
+    }
+}
+
+void ThreadPool::work(unsigned worker)
+{
+    uint32_t index;
+    while (next(worker, &index))
+    {
+        call_(task_, index, worker);
+    }
+}
+
+bool ThreadPool::next(unsigned worker, uint32_t * index)
+{
+    // Take the next task from the front of this worker's range
+
+    Queue & own = queues_[worker];
+    {
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (own.begin < own.end)
+        {
+            *index = own.begin++;
+            return true;
+        }
+    }
+
+    // Otherwise, steal the back half of another worker's range. No tasks are added during a batch, so if every range
+    // is empty, then there is nothing left to do.
+
+    for (unsigned i = 1; i < size_; ++i)
+    {
+        Queue & victim = queues_[(worker + i) % size_];
+        uint32_t begin;
+        uint32_t end;
+        {
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            uint32_t remaining = victim.end - victim.begin;
+            if (remaining == 0)
+                continue;
+            end        = victim.end;
+            begin      = end - (remaining + 1) / 2;
+            victim.end = begin;
+        }
+
+        // Run the first stolen task now and keep the rest
+
+        *index = begin;
+        {
+            std::lock_guard<std::mutex> lock(own.mutex);
+            own.begin = begin + 1;
+            own.end   = end;
+        }
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,356 @@
+#if !defined(PATHFINDER_ANYTIMEPATHFINDER_H_INCLUDED)
+#define PATHFINDER_ANYTIMEPATHFINDER_H_INCLUDED
+
+#pragma once
+
+#include "Heuristics.h"
+#include "OpenList.h"
+#include "PathFinder.h"
+#include "SearchContext.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+//! Anytime pathfinder that finds a path quickly and improves it until a budget runs out (ARA*).
+//!
+//! The search runs in passes. Each pass is a weighted A* search, which orders the open list by f = g + w * h, so it
+//! heads for the goal and finds a path after expanding few nodes, at the price of a path that may cost up to w times
+//! the shortest. The first pass uses the policy's initial weight, and each pass lowers it until it reaches 1 or the
+//! budget runs out. A pass does not start over: it continues from the nodes left by the previous one.
+//!
+//! - Within a pass, a node is expanded at most once. A closed node that is reached along a cheaper path is set aside
+//!   as inconsistent instead of being opened again.
+//! - When a pass ends, the inconsistent nodes join the open list, and the open list is reordered for the new weight.
+//!   Only the nodes whose costs were improved are expanded again.
+//! - After each pass, the bound on the path's cost is recomputed as the lower of w and the path's cost divided by the
+//!   lowest g + h of the open and inconsistent nodes, which is a lower bound on the cost of the shortest path. The
+//!   bound can reach 1, which proves the path is the shortest, before w does.
+//!
+//! The budget is a deadline, a number of expansions, or both. When it runs out, the best path found so far is returned
+//! with its bound. If it runs out before the first pass is completed, any path found has no bound. The clock is read
+//! every few expansions, so the search may run a few expansions past the deadline.
+//!
+//! The state of the search is kept in a SearchContext, as for BasicPathFinder, so any number of threads can search the
+//! same graph at the same time with their own contexts. The graph, heuristic and cost policy have the same
+//! requirements as for BasicPathFinder. The heuristic must be consistent.
+template <typename Graph, typename Heuristic = ZeroHeuristic, typename CostPolicy = EdgeCost>
+class BasicAnytimePathFinder
+{
+public:
+
+    using Vertex  = typename Graph::Vertex;     //!< A node as identified by users of the graph.
+    using Path    = std::vector<Vertex>;        //!< A path.
+    using Context = SearchContext;              //!< The state of a search.
+    using Clock   = std::chrono::steady_clock;  //!< Clock measuring the deadline.
+
+    //! How the weight of the heuristic is lowered.
+    struct Policy
+    {
+        float initialWeight = 3.0f; //!< Weight of the heuristic in the first pass (at least 1)
+        float weightStep    = 0.5f; //!< Amount by which the weight is lowered after each pass (more than 0)
+    };
+
+    //! Limits on the work done by a search. The search stops at whichever comes first.
+    struct Budget
+    {
+        Clock::time_point deadline = Clock::time_point::max(); //!< Time at which the search stops
+        uint32_t maxExpansions     = 0;                         //!< Number of expansions allowed (or 0 for unlimited)
+    };
+
+    //! Details of the path returned by a search.
+    struct Result
+    {
+        float cost      = INFINITY; //!< Cost of the path, or INFINITY if there is none
+        float bound     = INFINITY; //!< The path costs at most this many times the shortest (1 if it is the shortest)
+        float weight    = 0.0f;     //!< Weight of the heuristic in the last pass completed (or 0 if none was)
+        uint32_t passes = 0;        //!< Number of passes completed
+        bool exhausted  = false;    //!< True if the budget ran out before the path was proven the shortest
+    };
+
+    BasicAnytimePathFinder(Graph              graph,
+                           Policy const &     policy     = Policy(),
+                           Heuristic const &  heuristic  = Heuristic(),
+                           CostPolicy const & costPolicy = CostPolicy());
+
+    //! Finds a path, improving it until the budget runs out. Returns true if a path was found.
+    bool findPath(Context & context, Vertex start, Vertex end, Budget const & budget, Path * path,
+                  Result * result = nullptr) const;
+
+    //! Returns the graph.
+    Graph const & graph() const { return graph_; }
+
+    //! Returns the policy.
+    Policy const & policy() const { return policy_; }
+
+private:
+
+    using Open = IndexedHeapOpenList<uint32_t, SearchContextAccess>;
+
+    // Nodes that a pass leaves to the next one
+    struct Pass
+    {
+        std::vector<uint32_t> closed;       // Nodes expanded by the pass
+        std::vector<uint32_t> inconsistent; // Closed nodes whose costs were lowered after they were expanded
+    };
+
+    // Runs a pass until no open node could lead to a cheaper path, or the budget runs out. Returns false if the budget
+    // ran out.
+    bool improvePath(Context & context, Open & open, Pass & pass, uint32_t end, Budget const & budget) const;
+
+    // Starts the next pass with a new weight. Returns the lowest g + h of the open and inconsistent nodes.
+    float beginPass(Context & context, Open & open, Pass & pass, float weight) const;
+
+    // Constructs the path
+    void constructPath(Context const & context, uint32_t to, Path * path) const;
+
+    Graph graph_;
+    Policy policy_;
+    Heuristic heuristic_;
+    CostPolicy costPolicy_;
+};
+
+//! @param  graph       Graph to search
+//! @param  policy      How the weight of the heuristic is lowered
+//! @param  heuristic   Estimates the cost from a node to the goal
+//! @param  costPolicy  Computes the cost of traversing an edge
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+BasicAnytimePathFinder<Graph, Heuristic, CostPolicy>::BasicAnytimePathFinder(Graph              graph,
+                                                                             Policy const &     policy,
+                                                                             Heuristic const &  heuristic,
+                                                                             CostPolicy const & costPolicy)
+    : graph_(std::move(graph))
+    , policy_(policy)
+    , heuristic_(heuristic)
+    , costPolicy_(costPolicy)
+{
+    assert(policy_.initialWeight >= 1.0f);
+    assert(policy_.weightStep > 0.0f);
+}
+
+//! @param  context     State of the search
+//! @param  start       Start node
+//! @param  end         End node
+//! @param  budget      Limits on the work done
+//! @param  path        Best path found, from the start to the end, including both
+//! @param  result      Details of the path (optional)
+//!
+//! @returns    true, if a path was found
+//!
+//! @note   If the budget runs out during a pass, nodes on the path may have been reached along cheaper paths since the
+//!         end was, so the path can cost less than result->cost.
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+bool BasicAnytimePathFinder<Graph, Heuristic, CostPolicy>::findPath(Context &      context,
+                                                                    Vertex         start,
+                                                                    Vertex         end,
+                                                                    Budget const & budget,
+                                                                    Path *         path,
+                                                                    Result *       result) const
+{
+    assert(path);
+
+    uint32_t const from = graph_.index(start);
+    uint32_t const to   = graph_.index(end);
+    assert(from < graph_.size() && to < graph_.size());
+
+    Result r;
+    Open open(SearchContextAccess{ &context });
+    Pass pass;
+
+    context.begin(graph_.size());
+    context.setWeight(policy_.initialWeight);
+    context.open(from, 0.0f, heuristic_(graph_, from, to), SearchContext::NONE);
+    open.push(from);
+
+    float weight = policy_.initialWeight;
+    float lowerBound = 0.0f;    // Lower bound on the cost of the shortest path, from the last pass completed
+    for (;;)
+    {
+        if (!improvePath(context, open, pass, to, budget))
+        {
+            r.exhausted = true;
+            break;
+        }
+
+        r.passes += 1;
+        r.weight = weight;
+
+        // If the open list ran out, the pass searched every reachable node
+        if (context.status(to) == SearchContext::Status::NOT_VISITED)
+            break;
+
+        // Lower the weight for the next pass, unless the path is already proven the shortest
+        float const next = std::max(1.0f, weight - policy_.weightStep);
+        lowerBound = beginPass(context, open, pass, next);
+        r.bound = (context.g(to) <= lowerBound) ? 1.0f : std::min(weight, context.g(to) / lowerBound);
+        if (weight <= 1.0f || r.bound <= 1.0f)
+        {
+            r.bound = 1.0f;
+            break;
+        }
+        weight = next;
+    }
+
+    path->clear();
+    bool const found = (context.status(to) != SearchContext::Status::NOT_VISITED);
+    if (found)
+    {
+        constructPath(context, to, path);
+        r.cost = context.g(to);
+
+        // The path may have been improved by an unfinished pass. The lower bound on the shortest path still holds.
+        if (r.exhausted && lowerBound > 0.0f)
+            r.bound = std::min(r.bound, std::max(1.0f, r.cost / lowerBound));
+    }
+
+    if (result)
+        *result = r;
+    return found;
+}
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+bool BasicAnytimePathFinder<Graph, Heuristic, CostPolicy>::improvePath(Context &      context,
+                                                                       Open &         open,
+                                                                       Pass &         pass,
+                                                                       uint32_t       end,
+                                                                       Budget const & budget) const
+{
+    // The clock is read once every this many expansions
+    uint32_t constexpr CLOCK_INTERVAL = 64;
+
+    // The pass stops when no open node's estimate is lower than the cost of the path found. The end is never
+    // expanded, because its estimate is its cost.
+    auto pathCost = [&] {
+        return (context.status(end) == SearchContext::Status::NOT_VISITED) ? INFINITY : context.g(end);
+    };
+    while (!open.empty() && context.f(open.top()) < pathCost())
+    {
+        uint32_t const expansions = context.expansions();
+        if (budget.maxExpansions > 0 && expansions >= budget.maxExpansions)
+            return false;
+        if (expansions % CLOCK_INTERVAL == 0 && Clock::now() >= budget.deadline)
+            return false;
+
+        uint32_t const current = open.top();
+        context.expand(current);
+        open.pop();
+        pass.closed.push_back(current);
+
+        float const g = context.g(current);
+        graph_.forEachEdge(current, [&] (uint32_t neighbor, float edgeCost) {
+            float const cost = g + costPolicy_(graph_, current, neighbor, edgeCost);
+            switch (context.status(neighbor))
+            {
+            case SearchContext::Status::NOT_VISITED:
+                context.open(neighbor, cost, heuristic_(graph_, neighbor, end), current);
+                open.push(neighbor);
+                break;
+            case SearchContext::Status::OPEN:
+                if (cost < context.g(neighbor))
+                {
+                    context.update(neighbor, cost, current);
+                    open.decrease(neighbor);
+                }
+                break;
+            case SearchContext::Status::CLOSED:
+                // Closed in this pass, so it is left for the next one
+                if (cost < context.g(neighbor))
+                {
+                    context.update(neighbor, cost, current);
+                    pass.inconsistent.push_back(neighbor);
+                }
+                break;
+            default:
+                // Closed in an earlier pass, so it is opened again
+                if (cost < context.g(neighbor))
+                {
+                    context.reopen(neighbor, cost, current);
+                    open.push(neighbor);
+                }
+                break;
+            }
+        });
+    }
+    return true;
+}
+
+//! @param  context     State of the search
+//! @param  open        Open list
+//! @param  pass        Nodes left by the pass that has just been completed. They are cleared.
+//! @param  weight      Weight of the heuristic in the next pass
+//!
+//! @returns    the lowest g + h of the open and inconsistent nodes, or INFINITY if there are none
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+float BasicAnytimePathFinder<Graph, Heuristic, CostPolicy>::beginPass(Context & context,
+                                                                      Open &    open,
+                                                                      Pass &    pass,
+                                                                      float     weight) const
+{
+    context.setWeight(weight);
+
+    // Reorder the open nodes for the new weight. Their estimates change by different amounts, so the open list is
+    // rebuilt.
+
+    std::vector<uint32_t> frontier;
+    frontier.reserve(open.size() + pass.inconsistent.size());
+    while (!open.empty())
+    {
+        frontier.push_back(open.top());
+        open.pop();
+    }
+
+    // Add the inconsistent nodes. A node may have been set aside more than once.
+
+    for (uint32_t i : pass.inconsistent)
+    {
+        if (context.isClosed(i))
+        {
+            context.reopen(i, context.g(i), context.predecessor(i));
+            frontier.push_back(i);
+        }
+    }
+
+    float lowerBound = INFINITY;
+    for (uint32_t i : frontier)
+    {
+        lowerBound = std::min(lowerBound, context.g(i) + context.h(i));
+        context.update(i, context.g(i), context.predecessor(i));
+        open.push(i);
+    }
+
+    // The nodes closed by this pass may be opened again by the next one
+    for (uint32_t i : pass.closed)
+    {
+        if (context.isClosed(i))
+            context.expire(i);
+    }
+
+    pass.closed.clear();
+    pass.inconsistent.clear();
+    return lowerBound;
+}
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+void BasicAnytimePathFinder<Graph, Heuristic, CostPolicy>::constructPath(Context const & context,
+                                                                         uint32_t        to,
+                                                                         Path *          path) const
+{
+    for (uint32_t i = to; i != SearchContext::NONE; i = context.predecessor(i))
+    {
+        path->push_back(graph_.vertex(i));
+    }
+    std::reverse(path->begin(), path->end());
+}
+
+extern template class BasicAnytimePathFinder<NodeGraph, NodeHeuristic, EdgeCost>;
+
+//! Anytime pathfinder over a graph of user-defined nodes, with the costs of their edges and the nodes' heuristic.
+using AnytimePathFinder = BasicAnytimePathFinder<NodeGraph, NodeHeuristic, EdgeCost>;
+
+#endif // !defined(PATHFINDER_ANYTIMEPATHFINDER_H_INCLUDED)
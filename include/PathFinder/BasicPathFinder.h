@@ -0,0 +1,958 @@
+#if !defined(PATHFINDER_BASICPATHFINDER_H_INCLUDED)
+#define PATHFINDER_BASICPATHFINDER_H_INCLUDED
+
+#pragma once
+
+#include "Heuristics.h"
+#include "OpenList.h"
+#include "ReverseAdjacency.h"
+#include "SearchContext.h"
+#include "SearchWorkspace.h"
+#include "Span.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//! Pathfinding parameters.
+struct SearchPolicy
+{
+    //! Open list implementations.
+    enum class OpenList
+    {
+        BINARY_HEAP,    //!< std::vector managed by push_heap/pop_heap. Updating a node rebuilds the heap.
+        INDEXED_HEAP,   //!< 4-ary heap that tracks the location of each node. Updating a node is a sift-up.
+        PAIRING_HEAP,   //!< Pairing heap. Updating a node is a cut and a meld.
+        BUCKET_QUEUE    //!< Buckets of equal cost (Dial's algorithm). Costs are quantized (see BasicPathFinder).
+    };
+
+    int maxNodes;                               //!< Maximum number of nodes in the open list (or <= 0 for unlimited)
+    OpenList openList = OpenList::INDEXED_HEAP; //!< Open list implementation
+    bool bidirectional = false;                 //!< If true, search from both ends at once (see BasicPathFinder)
+    float bucketResolution = 1.0f;              //!< Costs are quantized to multiples of this for BUCKET_QUEUE
+};
+
+//! General A* pathfinder, specialized at compile time for a graph representation, a heuristic and a cost policy.
+//!
+//! The graph is a class with this interface:
+//!
+//!     using Vertex = ...;                                         // How a node is identified by users
+//!     uint32_t size() const;                                      // Number of nodes
+//!     uint32_t index(Vertex v) const;                             // Index of a node, in [0, size())
+//!     Vertex vertex(uint32_t i) const;                            // Node with the given index
+//!     template <typename Visitor>
+//!     void forEachEdge(uint32_t i, Visitor && visit) const;       // Calls visit(to, cost) for each edge leaving i
+//!
+//! The graph is stored by value, so it should be a view (such as NodeGraph) or be moved in. See Heuristics.h for the
+//! requirements of the heuristic and the cost policy. Because they are template parameters, the calls to them in the
+//! search loop are resolved at compile time and can be inlined.
+//!
+//! The pathfinder does not modify the graph. All of the state of a search is kept in a Context, so any number of
+//! threads can search the same graph at the same time, as long as each one uses its own context.
+//!
+//! A search given a context creates its open list, which allocates as it grows. A search given a Workspace reuses
+//! the workspace's open lists and context instead, so once a workspace has grown to the size needed by the queries,
+//! the queries do not allocate. For that, the path must be returned in a Path whose capacity is large enough, or in a
+//! buffer provided by the caller.
+//!
+//! If the policy selects a bidirectional search, then a forward search from the start and a backward search from the
+//! goal run in alternation, each expanding the side with the smaller frontier, and the path is found where they meet.
+//! The searches use the average of the forward and backward heuristics, which keeps the path optimal as long as the
+//! heuristic is consistent, and they stop as soon as the sum of the lowest priorities of the two open lists reaches
+//! the cost of the best path found. The backward search follows edges in reverse, so the pathfinder keeps a
+//! ReverseAdjacency of the graph, which must be rebuilt by updateReverseAdjacency() if the graph's edges change.
+//! The number of nodes expanded by each direction is given by context.expansions() and
+//! context.backward().expansions().
+//!
+//! If statistics are enabled (see SearchStats), each query leaves its statistics in the context, including the length
+//! and cost of the path and the time taken, and adds them to the pathfinder's counters(), which any number of threads
+//! may update at once. Otherwise, the statistics are not collected at all.
+//!
+//! findPaths() runs a batch of queries on a ThreadPool. Each worker has its own workspace, which is kept for the next
+//! batch.
+//!
+//! If the policy limits the number of nodes (maxNodes), then the search keeps its open list within the limit in the
+//! manner of SMA*, and the open list is always a min-max heap, whatever the policy selects:
+//!
+//! - When the open list exceeds the limit, the node with the highest f is forgotten. Ties are broken by node index,
+//!   so the result does not depend on the order in which the nodes were added.
+//! - The forgotten node's f is always backed up to its predecessor (or to the nearest ancestor that is not itself
+//!   forgotten), which returns to the open list with that f if it is closed, or takes the lower of the two f if it
+//!   is open. When the ancestor is expanded again, it regenerates the node. The forgotten nodes in between keep the
+//!   f too. If the start node has been forgotten, it keeps the f, and it is regenerated as soon as its f is the
+//!   lowest.
+//! - A forgotten node keeps its cost, its predecessor and its f. It is added back if it is reached along a cheaper
+//!   path, or with the f it was forgotten with if it is regenerated along the same one.
+//! - A node added to the open list gets at least the f of the node being expanded, and the f backed up is always
+//!   higher than that, if only by the smallest step a float can take. Each node is then expanded again at a higher
+//!   f than before, so the search cannot cycle through the same nodes with the same f forever.
+//!
+//! Nothing is lost by forgetting a node, so the search finds a path whenever there is one, whatever the limit. It
+//! remains optimal (up to the steps taken by the backed up f) as long as the heuristic is consistent, but it expands
+//! more nodes as the limit shrinks, because it expands nodes again to regenerate their successors. The limit bounds the open list only: the context still holds the state of every
+//! node visited.
+//!
+//! If the policy selects the BUCKET_QUEUE open list, then the search is quantized, so that every priority is a multiple
+//! of the policy's bucketResolution r and the buckets can be removed in order without comparing priorities:
+//!
+//! - Each edge cost is rounded up to a multiple of r, and each heuristic value is rounded down to one, which keeps
+//!   the heuristic admissible and consistent with respect to the rounded costs.
+//! - The path found is the shortest for the rounded costs, and its g values are rounded costs.
+//! - If every edge cost is a multiple of r (such as integer costs with r = 1), the path is the shortest.
+//! - Otherwise, each edge's cost rises by less than r, so the true cost of the path found is at most C* + r * n, where
+//!   C* is the cost of the shortest path and n is the number of its edges.
+//!
+//! The rounding allows for floating point error of 0.01% of r, so that a cost that is meant to be a multiple of r
+//! stays one.
+template <typename Graph, typename Heuristic = ZeroHeuristic, typename CostPolicy = EdgeCost>
+class BasicPathFinder
+{
+public:
+
+    using Vertex   = typename Graph::Vertex;    //!< A node as identified by users of the graph.
+    using Path     = std::vector<Vertex>;       //!< A path.
+    using Context  = SearchContext;             //!< The state of a search.
+    using Workspace = SearchWorkspace;          //!< Memory reused by searches.
+    using Policy   = SearchPolicy;              //!< Pathfinding parameters.
+    using OpenList = SearchPolicy::OpenList;    //!< Open list implementations.
+
+    //! A query in a batch.
+    struct Query
+    {
+        Vertex start;   //!< Start node
+        Vertex end;     //!< End node
+    };
+
+    //! The result of a query in a batch.
+    struct Result
+    {
+        Path path;          //!< Path found, or empty if there is none
+        float cost = 0.0f;  //!< Cost of the path
+        bool found = false; //!< True if a path was found
+    };
+
+    BasicPathFinder(Graph              graph,
+                    Policy const &     policy,
+                    Heuristic const &  heuristic  = Heuristic(),
+                    CostPolicy const & costPolicy = CostPolicy());
+
+    //! Finds the shortest path. Returns true if a path was found.
+    bool findPath(Vertex start, Vertex end, Path * path);
+
+    //! Finds the shortest path using the given context. Returns true if a path was found.
+    bool findPath(Context & context, Vertex start, Vertex end, Path * path) const;
+
+    //! Finds the shortest path using the given workspace. Returns true if a path was found.
+    bool findPath(Workspace & workspace, Vertex start, Vertex end, Path * path) const;
+
+    //! Finds the shortest path using the given workspace, and writes it from start to end into a buffer. Returns the
+    //! number of nodes in the path, or 0 if no path was found. Nothing is written if the path does not fit.
+    size_t findPath(Workspace & workspace, Vertex start, Vertex end, Span<Vertex> path) const;
+
+    //! Finds the shortest paths for a batch of queries using the threads of a pool.
+    void findPaths(ThreadPool & pool, Span<Query const> queries, Span<Result> results);
+
+    //! Rebuilds the reverse adjacency used by bidirectional searches. Call this after the graph's edges change.
+    void updateReverseAdjacency();
+
+    //! Returns the graph.
+    Graph const & graph() const { return graph_; }
+
+    //! Returns the policy.
+    Policy const & policy() const { return policy_; }
+
+    //! Returns the heuristic.
+    Heuristic const & heuristic() const { return heuristic_; }
+
+    //! Returns the cost policy.
+    CostPolicy const & costPolicy() const { return costPolicy_; }
+
+    //! Returns the totals of the statistics of the queries. They are all 0 unless statistics are enabled.
+    SearchCounters const & counters() const
+    {
+#if PATHFINDER_ENABLE_STATS
+        return counters_;
+#else
+        return noCounters();
+#endif
+    }
+
+    //! Returns the totals of the statistics of the queries, which can be reset. They are all 0 unless statistics are
+    //! enabled.
+    SearchCounters & counters()
+    {
+#if PATHFINDER_ENABLE_STATS
+        return counters_;
+#else
+        return noCounters();
+#endif
+    }
+
+private:
+
+    // Returns true if the open list requires the search to be quantized
+    template <typename Open>
+    static bool constexpr isQuantized()
+    {
+        return std::is_same<Open, BucketOpenList<uint32_t, SearchContextAccess>>::value;
+    }
+
+    // Returns the cost of an edge, rounded up to a multiple of the bucket resolution if the search is quantized
+    template <bool Quantized>
+    float stepCost(uint32_t from, uint32_t to, float edgeCost) const
+    {
+        float c = costPolicy_(graph_, from, to, edgeCost);
+        if (!Quantized)
+            return c;
+        float const r = policy_.bucketResolution;
+        return std::ceil(c / r - 1e-4f) * r;
+    }
+
+    // Returns the heuristic, rounded down to a multiple of the bucket resolution if the search is quantized
+    template <bool Quantized>
+    float estimate(uint32_t from, uint32_t goal) const
+    {
+        float h = heuristic_(graph_, from, goal);
+        if (!Quantized)
+            return h;
+        float const r = policy_.bucketResolution;
+        return std::floor(h / r + 1e-4f) * r;
+    }
+
+    // Finds the shortest path using the open list implementation selected by the policy. The open lists are taken
+    // from the workspace if there is one, in which case the context must be the workspace's.
+    bool search(Context & context, Workspace * workspace, uint32_t start, uint32_t end) const;
+
+    // Finds the shortest path using the given open list implementation, in the direction or directions selected by
+    // the policy
+    template <typename Open>
+    bool searchWith(Context & context, Workspace * workspace, uint32_t start, uint32_t end) const;
+
+    // Adds a node to the open list, and forgets the worst nodes if the list is over the limit
+    template <typename Open>
+    void admit(Context & context, Open & open, uint32_t i, float floor) const;
+
+    // Forgets a node evicted from the open list, backing up its f so that it can be regenerated
+    template <typename Open>
+    void forget(Context & context, Open & open, uint32_t i, float floor) const;
+
+    // Adds a forgotten node back to the open list with the given cost of the path to it
+    template <typename Open>
+    void readmit(Context & context, Open & open, uint32_t i, float g, uint32_t predecessor, float floor) const;
+
+    // Adds the start node of a search back to the open list if it has been forgotten and nothing in the open list is
+    // better. Returns true if it was added.
+    template <typename Open>
+    bool restart(Context & context, Open & open, uint32_t start) const;
+
+    // Finds the shortest path using the given open list implementation
+    template <typename Open>
+    bool searchUsing(Context & context, Open & open, uint32_t start, uint32_t end) const;
+
+    // Finds the shortest path by searching from both ends using the given open list implementation
+    template <typename Open>
+    bool searchBidirectionalUsing(Context & forward, Open & forwardOpen, Open & backwardOpen, uint32_t start,
+                                  uint32_t end) const;
+
+    // Constructs the path
+    void constructPath(Context const & context, uint32_t from, uint32_t to, Path * path) const;
+
+    // Completes the statistics of a query in its context and adds them to the counters, if statistics are enabled
+    void record(Context & context, uint32_t to, size_t length, SearchStats::Clock::time_point t0) const;
+
+#if !PATHFINDER_ENABLE_STATS
+    // Returns the counters of every pathfinder when statistics are disabled. Nothing is ever added to them.
+    static SearchCounters & noCounters()
+    {
+        static SearchCounters none;
+        return none;
+    }
+#endif
+
+    // Returns the number of nodes in the path to a node
+    size_t pathLength(Context const & context, uint32_t to) const;
+
+    // Writes the nodes of the path from start to end, given its length
+    void writePath(Context const & context, uint32_t from, uint32_t to, Vertex * path, size_t length) const;
+
+#if defined(_DEBUG)
+    void validateNode(Vertex node) const;
+#endif
+
+    Graph graph_;
+    Policy policy_;
+    Heuristic heuristic_;
+    CostPolicy costPolicy_;
+    ReverseAdjacency reverse_;  // Edges entering each node, for bidirectional searches
+    Workspace workspace_;       // Workspace used by findPath when a context is not provided
+    std::vector<Workspace> workerWorkspaces_;   // Workspaces used by the workers in findPaths
+    mutable std::conditional_t<SearchStats::ENABLED, SearchCounters, NoSearchStats> counters_;  // Totals of the queries
+};
+
+//! @param  graph       Graph to search
+//! @param  policy      Configuration options
+//! @param  heuristic   Estimates the cost from a node to the goal
+//! @param  costPolicy  Computes the cost of traversing an edge
+//!
+//! @note   If the policy selects a bidirectional search, the graph's reverse adjacency is built here.
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+BasicPathFinder<Graph, Heuristic, CostPolicy>::BasicPathFinder(Graph              graph,
+                                                               Policy const &     policy,
+                                                               Heuristic const &  heuristic,
+                                                               CostPolicy const & costPolicy)
+    : graph_(std::move(graph))
+    , policy_(policy)
+    , heuristic_(heuristic)
+    , costPolicy_(costPolicy)
+{
+    if (policy_.bidirectional)
+        updateReverseAdjacency();
+}
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+void BasicPathFinder<Graph, Heuristic, CostPolicy>::updateReverseAdjacency()
+{
+    reverse_ = ReverseAdjacency(graph_);
+}
+
+//! @param    start     Start node
+//! @param    end       End node
+//! @param    path      Resulting path
+//!
+//! @returns    true, if a path is found
+//!
+//! @note   This function uses a workspace owned by the pathfinder, so it cannot be called concurrently.
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+bool BasicPathFinder<Graph, Heuristic, CostPolicy>::findPath(Vertex start, Vertex end, Path * path)
+{
+    return findPath(workspace_, start, end, path);
+}
+
+//! @param    context   State of the search
+//! @param    start     Start node
+//! @param    end       End node
+//! @param    path      Resulting path
+//!
+//! @returns    true, if a path is found
+//!
+//! @note   The graph is not modified, so this function can be called concurrently as long as each call uses a
+//!         different context. The state of the search remains in the context until it is used again.
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+bool BasicPathFinder<Graph, Heuristic, CostPolicy>::findPath(Context & context, Vertex start, Vertex end, Path * path) const
+{
+    assert(path);
+
+#if defined(_DEBUG)
+    validateNode(start);
+    validateNode(end);
+#endif
+
+    auto const t0 = SearchStats::start();
+    uint32_t from = graph_.index(start);
+    uint32_t to   = graph_.index(end);
+    bool found    = search(context, nullptr, from, to);
+    if (found)
+        constructPath(context, from, to, path);
+
+    record(context, to, found ? path->size() : 0, t0);
+    return found;
+}
+
+//! @param    workspace Memory used by the search, which holds its state afterward
+//! @param    start     Start node
+//! @param    end       End node
+//! @param    path      Resulting path
+//!
+//! @returns    true, if a path is found
+//!
+//! @note   The path is resized rather than reallocated, so it does not allocate if its capacity is large enough.
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+bool BasicPathFinder<Graph, Heuristic, CostPolicy>::findPath(Workspace & workspace,
+                                                             Vertex      start,
+                                                             Vertex      end,
+                                                             Path *      path) const
+{
+    assert(path);
+
+#if defined(_DEBUG)
+    validateNode(start);
+    validateNode(end);
+#endif
+
+    auto const t0 = SearchStats::start();
+    Context & context = workspace.context();
+    uint32_t from = graph_.index(start);
+    uint32_t to   = graph_.index(end);
+    bool found    = search(context, &workspace, from, to);
+    if (found)
+        constructPath(context, from, to, path);
+
+    record(context, to, found ? path->size() : 0, t0);
+    return found;
+}
+
+//! @param    workspace Memory used by the search, which holds its state afterward
+//! @param    start     Start node
+//! @param    end       End node
+//! @param    path      Buffer receiving the path
+//!
+//! @returns    the number of nodes in the path, or 0 if no path is found
+//!
+//! @note   If the path is longer than the buffer, nothing is written. The search's state remains in the workspace, so
+//!         the length can be used to find a large enough buffer before searching again.
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+size_t BasicPathFinder<Graph, Heuristic, CostPolicy>::findPath(Workspace &  workspace,
+                                                               Vertex       start,
+                                                               Vertex       end,
+                                                               Span<Vertex> path) const
+{
+#if defined(_DEBUG)
+    validateNode(start);
+    validateNode(end);
+#endif
+
+    auto const t0 = SearchStats::start();
+    Context & context = workspace.context();
+    uint32_t from = graph_.index(start);
+    uint32_t to   = graph_.index(end);
+    size_t length = search(context, &workspace, from, to) ? pathLength(context, to) : 0;
+    if (length > 0 && length <= path.size())
+        writePath(context, from, to, path.data(), length);
+
+    record(context, to, length, t0);
+    return length;
+}
+
+//! @param    pool      Threads that run the queries
+//! @param    queries   Queries to run
+//! @param    results   Results of the queries, in the same order. There must be at least one for each query.
+//!
+//! @note   The results' paths are reused, so the same results can be passed for each batch to avoid reallocating them.
+//! @note   This function uses workspaces owned by the pathfinder, so it cannot be called concurrently.
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+void BasicPathFinder<Graph, Heuristic, CostPolicy>::findPaths(ThreadPool &      pool,
+                                                              Span<Query const> queries,
+                                                              Span<Result>      results)
+{
+    assert(results.size() >= queries.size());
+
+    if (workerWorkspaces_.size() < pool.size())
+        workerWorkspaces_.resize(pool.size());
+
+    pool.run((uint32_t)queries.size(), [&] (uint32_t i, unsigned worker) {
+        Workspace & workspace = workerWorkspaces_[worker];
+        Query const & query   = queries[i];
+        Result & result       = results[i];
+
+        result.found = findPath(workspace, query.start, query.end, &result.path);
+        if (result.found)
+        {
+            result.cost = workspace.context().g(graph_.index(query.end));
+        }
+        else
+        {
+            result.path.clear();
+            result.cost = INFINITY;
+        }
+    });
+}
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+bool BasicPathFinder<Graph, Heuristic, CostPolicy>::search(Context &   context,
+                                                           Workspace * workspace,
+                                                           uint32_t    start,
+                                                           uint32_t    end) const
+{
+    assert(!workspace || &workspace->context() == &context);
+
+    // A node that is not in the graph (such as a node of another list) cannot be reached
+    if (start >= graph_.size() || end >= graph_.size())
+    {
+        context.begin(graph_.size());
+        if (policy_.bidirectional)
+            context.backward().begin(graph_.size());
+        return false;
+    }
+
+    // Only a min-max heap can evict the worst node
+    if (policy_.maxNodes > 0)
+        return searchWith<MinMaxHeapOpenList<uint32_t, SearchContextAccess>>(context, workspace, start, end);
+
+    switch (policy_.openList)
+    {
+    case OpenList::BINARY_HEAP:
+        return searchWith<BinaryHeapOpenList<uint32_t, SearchContextAccess>>(context, workspace, start, end);
+    case OpenList::PAIRING_HEAP:
+        return searchWith<PairingHeapOpenList<uint32_t, SearchContextAccess>>(context, workspace, start, end);
+    case OpenList::BUCKET_QUEUE:
+        return searchWith<BucketOpenList<uint32_t, SearchContextAccess>>(context, workspace, start, end);
+    case OpenList::INDEXED_HEAP:
+    default:
+        return searchWith<IndexedHeapOpenList<uint32_t, SearchContextAccess>>(context, workspace, start, end);
+    }
+}
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+template <typename Open>
+bool BasicPathFinder<Graph, Heuristic, CostPolicy>::searchWith(Context &   context,
+                                                               Workspace * workspace,
+                                                               uint32_t    start,
+                                                               uint32_t    end) const
+{
+    // The potentials of a bidirectional search are multiples of half of the resolution when the search is quantized,
+    // and so are the priorities
+
+    float const bucketWidth = policy_.bidirectional ? 0.5f * policy_.bucketResolution : policy_.bucketResolution;
+
+    if (workspace)
+    {
+        Open & open = workspace->openList<Open>(bucketWidth);
+        if (policy_.bidirectional)
+            return searchBidirectionalUsing(context, open, workspace->openList<Open>(bucketWidth, true), start, end);
+        return searchUsing(context, open, start, end);
+    }
+
+    Open open(SearchContextAccess{ &context, bucketWidth });
+    if (policy_.bidirectional)
+    {
+        Open backwardOpen(SearchContextAccess{ &context.backward(), bucketWidth });
+        return searchBidirectionalUsing(context, open, backwardOpen, start, end);
+    }
+    return searchUsing(context, open, start, end);
+}
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+template <typename Open>
+bool BasicPathFinder<Graph, Heuristic, CostPolicy>::searchUsing(Context & context,
+                                                                Open &    open,
+                                                                uint32_t  start,
+                                                                uint32_t  end) const
+{
+    bool constexpr QUANTIZED = isQuantized<Open>();
+
+    if (policy_.maxNodes > 0)
+        open.reserve(policy_.maxNodes + 1);
+
+    // Start a new search. This implicitly resets the status of all nodes.
+
+    context.begin(graph_.size());
+
+    // Add the start node to the open queue.
+
+    context.open(start, 0.f, estimate<QUANTIZED>(start, end), SearchContext::NONE);
+    open.push(start);
+    context.recordOpenListSize(open.size());
+
+    // Until the open queue is empty or a path is found...
+
+    while (restart(context, open, start) || !open.empty())
+    {
+        // Get the lowest cost node as the next one to check (and close it)
+
+        uint32_t current = open.top();
+
+        context.expand(current);
+        open.pop();
+
+        // If this is the goal, then we are done
+
+        if (current == end)
+            return true;
+
+        // Go to each neighbor and set/update its cost and make sure it is in the open queue (unless it is closed)
+
+        float const g = context.g(current);
+
+        graph_.forEachEdge(current, [&] (uint32_t neighbor, float edgeCost) {
+            // If the node is closed, then its minimum cost has been determined and there is no reason to revisit
+            // it.
+
+            if (context.isClosed(neighbor))
+                return;
+
+            // Compute the cost to the neighbor through this node
+            float cost = g + stepCost<QUANTIZED>(current, neighbor, edgeCost);
+
+            // If the neighbor has not been visited, then add it to the open queue
+
+            SearchContext::Status const status = context.status(neighbor);
+            if (status == SearchContext::Status::NOT_VISITED)
+            {
+                context.open(neighbor, cost, estimate<QUANTIZED>(neighbor, end), current);
+                admit(context, open, neighbor, context.f(current));
+            }
+
+            // If it was forgotten to save memory, then add it back if this path is cheaper or is the one it was
+            // forgotten on
+
+            else if (status == SearchContext::Status::FORGOTTEN)
+            {
+                if (cost < context.g(neighbor) || current == context.predecessor(neighbor))
+                    readmit(context, open, neighbor, cost, current, context.f(current));
+            }
+
+            // Otherwise, perhaps this is a lower-cost path to it. If so, update it to reflect the new path.
+
+            else if (cost < context.g(neighbor))
+            {
+                context.update(neighbor, cost, current);
+                open.decrease(neighbor);
+            }
+        });
+    }
+
+    return false;
+}
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+template <typename Open>
+bool BasicPathFinder<Graph, Heuristic, CostPolicy>::searchBidirectionalUsing(Context & forward,
+                                                                             Open &    forwardOpen,
+                                                                             Open &    backwardOpen,
+                                                                             uint32_t  start,
+                                                                             uint32_t  end) const
+{
+    assert(reverse_.size() == graph_.size());
+
+    bool constexpr QUANTIZED = isQuantized<Open>();
+
+    Context & backward = forward.backward();
+    if (policy_.maxNodes > 0)
+    {
+        forwardOpen.reserve(policy_.maxNodes + 1);
+        backwardOpen.reserve(policy_.maxNodes + 1);
+    }
+
+    forward.begin(graph_.size());
+    backward.begin(graph_.size());
+
+    // Each direction uses half of the difference between the heuristic toward its goal and the heuristic back toward
+    // its start. With these potentials, the two searches agree on the reduced cost of every edge, so the first time
+    // the frontiers can no longer improve on the best path found, it is optimal. The potential is stored as the
+    // node's h, so its f is its priority.
+
+    auto potential = [&] (uint32_t i) {
+        return 0.5f * (estimate<QUANTIZED>(i, end) - estimate<QUANTIZED>(start, i));
+    };
+
+    forward.open(start, 0.f, potential(start), SearchContext::NONE);
+    forwardOpen.push(start);
+    forward.recordOpenListSize(forwardOpen.size());
+    backward.open(end, 0.f, -potential(end), SearchContext::NONE);
+    backwardOpen.push(end);
+    backward.recordOpenListSize(backwardOpen.size());
+
+    // The best path found so far passes through the meeting node
+
+    float best       = (start == end) ? 0.f : INFINITY;
+    uint32_t meeting = (start == end) ? start : SearchContext::NONE;
+
+    // Sets or updates the cost to a neighbor in one direction, and checks for a better path through it using the cost
+    // found by the other direction
+
+    auto relax = [&] (Context & self, Open & open, Context const & other, uint32_t current, uint32_t neighbor, float cost, float sign) {
+        SearchContext::Status const status = self.status(neighbor);
+        if (status == SearchContext::Status::CLOSED)
+            return;
+
+        if (status == SearchContext::Status::NOT_VISITED)
+        {
+            self.open(neighbor, cost, sign * potential(neighbor), current);
+            admit(self, open, neighbor, self.f(current));
+        }
+        else if (status == SearchContext::Status::FORGOTTEN)
+        {
+            if (cost >= self.g(neighbor) && current != self.predecessor(neighbor))
+                return;
+            readmit(self, open, neighbor, cost, current, self.f(current));
+        }
+        else if (cost < self.g(neighbor))
+        {
+            self.update(neighbor, cost, current);
+            open.decrease(neighbor);
+        }
+        else
+        {
+            return;
+        }
+
+        if (other.status(neighbor) != SearchContext::Status::NOT_VISITED && cost + other.g(neighbor) < best)
+        {
+            best    = cost + other.g(neighbor);
+            meeting = neighbor;
+        }
+    };
+
+    while ((restart(forward, forwardOpen, start) || !forwardOpen.empty()) &&
+           (restart(backward, backwardOpen, end) || !backwardOpen.empty()))
+    {
+        // Stop when no path through the frontiers can be cheaper than the best path found
+
+        if (forward.f(forwardOpen.top()) + backward.f(backwardOpen.top()) >= best)
+            break;
+
+        // Expand a node in the direction with the smaller frontier
+
+        if (forwardOpen.size() <= backwardOpen.size())
+        {
+            uint32_t current = forwardOpen.top();
+            forward.expand(current);
+            forwardOpen.pop();
+
+            float const g = forward.g(current);
+            graph_.forEachEdge(current, [&] (uint32_t neighbor, float edgeCost) {
+                relax(forward, forwardOpen, backward, current, neighbor, g + stepCost<QUANTIZED>(current, neighbor, edgeCost), 1.0f);
+            });
+        }
+        else
+        {
+            uint32_t current = backwardOpen.top();
+            backward.expand(current);
+            backwardOpen.pop();
+
+            float const g = backward.g(current);
+            reverse_.forEachEdge(current, [&] (uint32_t neighbor, float edgeCost) {
+                relax(backward, backwardOpen, forward, current, neighbor, g + stepCost<QUANTIZED>(neighbor, current, edgeCost), -1.0f);
+            });
+        }
+    }
+
+    if (meeting == SearchContext::NONE)
+        return false;
+
+    // Link the backward half of the path into the forward context, so that the path can be constructed from the end
+    // and the cost of the path is the g of the end node, just like a unidirectional search.
+
+    for (uint32_t i = meeting, next = backward.predecessor(i); next != SearchContext::NONE; i = next, next = backward.predecessor(i))
+    {
+        forward.link(next, forward.g(i) + (backward.g(i) - backward.g(next)), i);
+    }
+
+    return true;
+}
+
+//! @param  context     State of the search
+//! @param  open        Open list
+//! @param  i           Node to add
+//! @param  floor       f of the node being expanded
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+template <typename Open>
+void BasicPathFinder<Graph, Heuristic, CostPolicy>::admit(Context & context, Open & open, uint32_t i, float floor) const
+{
+    // Once nodes are forgotten, a node can be expanded with an f higher than its cost and heuristic. Its successors
+    // are no better, so that the lowest f in the open list never drops.
+    if (policy_.maxNodes > 0 && context.f(i) < floor)
+        context.backUp(i, floor);
+
+    open.push(i);
+    while (policy_.maxNodes > 0 && open.size() > (size_t)policy_.maxNodes)
+    {
+        forget(context, open, open.evict(), floor);
+    }
+    context.recordOpenListSize(open.size());
+}
+
+//! @param  context     State of the search
+//! @param  open        Open list
+//! @param  i           Node evicted from the open list
+//! @param  floor       f of the node being expanded
+//!
+//! @note   The ancestor that receives the backed up f may be a closed node, which is opened again. That can take the
+//!         open list over the limit again, which admit() handles.
+//! @note   The f backed up is raised above floor if it is not already higher, and above the f a closed ancestor was
+//!         expanded with. Since the lowest f in the open list never drops, every node is expanded again at a higher f
+//!         than before, and the search ends.
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+template <typename Open>
+void BasicPathFinder<Graph, Heuristic, CostPolicy>::forget(Context & context, Open & open, uint32_t i, float floor) const
+{
+    context.forget(i);
+
+    // No path passes through a node with an infinite f, so there is nothing to regenerate
+    float f = std::max(context.f(i), std::nextafter(floor, INFINITY));
+    if (std::isinf(f))
+        return;
+
+    // The forgotten ancestors keep the f too, so that they are regenerated with it. If every ancestor has been
+    // forgotten, the start node keeps it until it is regenerated (see restart()).
+    uint32_t ancestor = context.predecessor(i);
+    while (ancestor != SearchContext::NONE && context.status(ancestor) == SearchContext::Status::FORGOTTEN)
+    {
+        if (f < context.f(ancestor))
+            context.backUp(ancestor, f);
+        ancestor = context.predecessor(ancestor);
+    }
+    if (ancestor == SearchContext::NONE)
+        return;
+
+    if (context.isOpen(ancestor))
+    {
+        if (f < context.f(ancestor))
+        {
+            context.backUp(ancestor, f);
+            open.decrease(ancestor);
+        }
+    }
+    else
+    {
+        f = std::max(f, std::nextafter(context.f(ancestor), INFINITY));
+        context.reopen(ancestor, context.g(ancestor), context.predecessor(ancestor));
+        context.backUp(ancestor, f);
+        open.push(ancestor);
+    }
+}
+
+//! @param  context     State of the search
+//! @param  open        Open list
+//! @param  i           Forgotten node
+//! @param  g           Cost of the path to the node
+//! @param  predecessor Node being expanded, which is the previous node in the path
+//! @param  floor       f of the node being expanded
+//!
+//! @note   If the node is regenerated along the path it was forgotten on, then it keeps the f it was forgotten with,
+//!         which may have been backed up from its own forgotten successors. Otherwise, it would be expanded again at
+//!         a lower f than before.
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+template <typename Open>
+void BasicPathFinder<Graph, Heuristic, CostPolicy>::readmit(Context & context,
+                                                            Open &    open,
+                                                            uint32_t  i,
+                                                            float     g,
+                                                            uint32_t  predecessor,
+                                                            float     floor) const
+{
+    assert(context.status(i) == SearchContext::Status::FORGOTTEN);
+
+    bool const regenerated = !(g < context.g(i));
+    float const f          = context.f(i);
+    context.reopen(i, g, predecessor);
+    if (regenerated && f > context.f(i))
+        context.backUp(i, f);
+    admit(context, open, i, floor);
+}
+
+//! @param  context     State of the search
+//! @param  open        Open list
+//! @param  start       Start node of the search (or the end node of a backward search)
+//!
+//! @returns    true if the start node was forgotten and has been added back
+//!
+//! @note   The start node is added back only if its f is lower than every f in the open list, so that it is not
+//!         forgotten again at once.
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+template <typename Open>
+bool BasicPathFinder<Graph, Heuristic, CostPolicy>::restart(Context & context, Open & open, uint32_t start) const
+{
+    if (context.status(start) != SearchContext::Status::FORGOTTEN)
+        return false;
+    if (!open.empty() && context.f(start) >= context.f(open.top()))
+        return false;
+    readmit(context, open, start, context.g(start), SearchContext::NONE, context.f(start));
+    return true;
+}
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+void BasicPathFinder<Graph, Heuristic, CostPolicy>::constructPath(Context const & context,
+                                                                  uint32_t        from,
+                                                                  uint32_t        to,
+                                                                  Path *          path) const
+{
+    // Size the path first, so that it is not reallocated if its capacity is large enough
+
+    path->resize(pathLength(context, to));
+    writePath(context, from, to, path->data(), path->size());
+}
+
+//! @param  context     State of the search
+//! @param  to          Index of the end node
+//! @param  length      Number of nodes in the path, or 0 if none was found
+//! @param  t0          Time at which the query started
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+void BasicPathFinder<Graph, Heuristic, CostPolicy>::record(Context &                      context,
+                                                           uint32_t                       to,
+                                                           size_t                         length,
+                                                           SearchStats::Clock::time_point t0) const
+{
+#if PATHFINDER_ENABLE_STATS
+    SearchStats & stats = context.stats();
+    if (policy_.bidirectional)
+        stats.merge(context.backward().stats());
+    stats.pathLength = (uint32_t)length;
+    stats.cost       = (length > 0) ? context.g(to) : INFINITY;
+    stats.seconds    = SearchStats::elapsed(t0);
+    counters_.add(stats);
+#endif
+    (void)context;
+    (void)to;
+    (void)length;
+    (void)t0;
+}
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+size_t BasicPathFinder<Graph, Heuristic, CostPolicy>::pathLength(Context const & context, uint32_t to) const
+{
+    size_t length = 0;
+    for (uint32_t i = to; i != SearchContext::NONE; i = context.predecessor(i))
+    {
+        ++length;
+    }
+    return length;
+}
+
+//! @param  context     State of the search
+//! @param  from        Index of the start node
+//! @param  to          Index of the end node
+//! @param  path        Receives the nodes of the path
+//! @param  length      Number of nodes in the path
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+void BasicPathFinder<Graph, Heuristic, CostPolicy>::writePath(Context const & context,
+                                                              uint32_t        from,
+                                                              uint32_t        to,
+                                                              Vertex *        path,
+                                                              size_t          length) const
+{
+    // The nodes are linked from end to start, so the path is filled from its last element to its first
+
+    uint32_t i = to;
+    for (size_t n = length; n > 0; --n)
+    {
+        assert(i != SearchContext::NONE);
+        path[n - 1] = graph_.vertex(i);
+        i = context.predecessor(i);
+    }
+
+    assert(i == SearchContext::NONE && (length == 0 || graph_.index(path[0]) == from));
+    (void)from;
+}
+
+#if defined(_DEBUG)
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+void BasicPathFinder<Graph, Heuristic, CostPolicy>::validateNode(Vertex node) const
+{
+    // Assert that the node is in the graph
+    uint32_t i = graph_.index(node);
+    assert(i < graph_.size() && graph_.vertex(i) == node);
+    (void)i;
+}
+
+#endif // defined( _DEBUG )
+
+#endif // !defined(PATHFINDER_BASICPATHFINDER_H_INCLUDED)
@@ -0,0 +1,177 @@
+#if !defined(PATHFINDER_COMPACTGRAPH_H_INCLUDED)
+#define PATHFINDER_COMPACTGRAPH_H_INCLUDED
+
+#pragma once
+
+#include "PathFinder.h"
+
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+//! View of the arrays of a graph in compressed sparse row (CSR) form, such as those of a CompactGraph or a GraphFile.
+//!
+//! The view does not own the arrays, so it is cheap to copy, and the arrays must outlive it. It has the same interface
+//! as CompactGraph, except that the costs cannot be changed, and it can be searched by BasicPathFinder.
+class CompactGraphView
+{
+public:
+
+    using Vertex = uint32_t;    //!< A node is identified by its index.
+
+    //! Constructs a view of an empty graph.
+    CompactGraphView() = default;
+
+    //! Constructor. There are size + 1 offsets, and offsets[size] targets and costs.
+    CompactGraphView(uint32_t size, uint32_t const * offsets, uint32_t const * targets, float const * costs)
+        : size_(size)
+        , offsets_(offsets)
+        , targets_(targets)
+        , costs_(costs)
+    {
+        assert(offsets && offsets[0] == 0);
+        assert(offsets[size] == 0 || (targets && costs));
+    }
+
+    //! Returns the number of nodes.
+    uint32_t size() const { return size_; }
+
+    //! Returns the number of edges.
+    uint32_t edgeCount() const { return offsets_ ? offsets_[size_] : 0; }
+
+    //! Returns the index of the first edge leaving a node.
+    uint32_t begin(uint32_t node) const { return offsets_[node]; }
+
+    //! Returns the index following the last edge leaving a node.
+    uint32_t end(uint32_t node) const { return offsets_[node + 1]; }
+
+    //! Returns the index of an edge's destination node.
+    uint32_t target(uint32_t edge) const { return targets_[edge]; }
+
+    //! Returns the cost of traversing an edge.
+    float cost(uint32_t edge) const { return costs_[edge]; }
+
+    //! Returns the index of a node.
+    uint32_t index(uint32_t node) const { return node; }
+
+    //! Returns the node with the given index.
+    uint32_t vertex(uint32_t i) const { return i; }
+
+    //! Calls visit(to, cost) for each edge leaving a node.
+    template <typename Visitor>
+    void forEachEdge(uint32_t node, Visitor && visit) const
+    {
+        for (uint32_t e = offsets_[node], end = offsets_[node + 1]; e != end; ++e)
+        {
+            visit(targets_[e], costs_[e]);
+        }
+    }
+
+    //! Returns the offsets: the index of the first edge of each node, followed by the number of edges.
+    uint32_t const * offsets() const { return offsets_; }
+
+    //! Returns the destination of each edge.
+    uint32_t const * targets() const { return targets_; }
+
+    //! Returns the cost of each edge.
+    float const * costs() const { return costs_; }
+
+private:
+
+    uint32_t size_ = 0;
+    uint32_t const * offsets_ = nullptr;
+    uint32_t const * targets_ = nullptr;
+    float const * costs_      = nullptr;
+};
+
+//! Graph stored in compressed sparse row (CSR) form.
+//!
+//! The edges leaving node i are the edges in the range [begin(i), end(i)). The targets and costs of the edges are
+//! stored in two parallel arrays, so an edge takes 8 bytes and a node takes 4 bytes, and the edges leaving a node are
+//! contiguous in memory. Compare that to a PathFinder::Node, which has a pointer to a separately allocated
+//! PathFinder::Edge for each edge.
+//!
+//! CompactGraph can be searched by BasicPathFinder, and so can a view of it (see CompactGraphView).
+class CompactGraph
+{
+public:
+
+    using Vertex = uint32_t;    //!< A node is identified by its index.
+
+    //! An edge used to construct a graph.
+    struct Edge
+    {
+        uint32_t from;  //!< Index of the source node
+        uint32_t to;    //!< Index of the destination node
+        float cost;     //!< Cost of traversing the edge
+    };
+
+    //! Constructs an empty graph.
+    CompactGraph() = default;
+
+    //! Constructs a graph from a list of PathFinder nodes.
+    explicit CompactGraph(PathFinder::NodeList const & nodes);
+
+    //! Constructs a graph from a list of edges.
+    CompactGraph(uint32_t size, std::vector<Edge> const & edges);
+
+    //! Constructs a graph from CSR arrays.
+    CompactGraph(std::vector<uint32_t> offsets, std::vector<uint32_t> targets, std::vector<float> costs);
+
+    //! Returns the number of nodes.
+    uint32_t size() const { return offsets_.empty() ? 0 : (uint32_t)offsets_.size() - 1; }
+
+    //! Returns the number of edges.
+    uint32_t edgeCount() const { return view().edgeCount(); }
+
+    //! Returns the index of the first edge leaving a node.
+    uint32_t begin(uint32_t node) const { return view().begin(node); }
+
+    //! Returns the index following the last edge leaving a node.
+    uint32_t end(uint32_t node) const { return view().end(node); }
+
+    //! Returns the index of an edge's destination node.
+    uint32_t target(uint32_t edge) const { return view().target(edge); }
+
+    //! Returns the cost of traversing an edge.
+    float cost(uint32_t edge) const { return view().cost(edge); }
+
+    //! Sets the cost of traversing an edge.
+    void setCost(uint32_t edge, float cost) { costs_[edge] = cost; }
+
+    //! Returns the index of a node.
+    uint32_t index(uint32_t node) const { return view().index(node); }
+
+    //! Returns the node with the given index.
+    uint32_t vertex(uint32_t i) const { return view().vertex(i); }
+
+    //! Calls visit(to, cost) for each edge leaving a node.
+    template <typename Visitor>
+    void forEachEdge(uint32_t node, Visitor && visit) const
+    {
+        view().forEachEdge(node, std::forward<Visitor>(visit));
+    }
+
+    //! Returns a view of the graph's arrays. It remains valid until the graph is changed or destroyed. The other
+    //! accessors forward to it, so the graph and its view are searched the same way.
+    CompactGraphView view() const
+    {
+        static uint32_t const EMPTY = 0;
+        return CompactGraphView(size(), offsets_.empty() ? &EMPTY : offsets_.data(), targets_.data(), costs_.data());
+    }
+
+    //! Returns the number of bytes used by the graph's arrays.
+    size_t memoryUsage() const
+    {
+        return offsets_.size() * sizeof(uint32_t) + targets_.size() * sizeof(uint32_t) + costs_.size() * sizeof(float);
+    }
+
+private:
+
+    std::vector<uint32_t> offsets_; // Index of the first edge of each node, plus the total number of edges
+    std::vector<uint32_t> targets_; // Destination of each edge
+    std::vector<float> costs_;      // Cost of each edge
+};
+
+#endif // !defined(PATHFINDER_COMPACTGRAPH_H_INCLUDED)
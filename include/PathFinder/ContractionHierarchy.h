@@ -0,0 +1,116 @@
+#if !defined(PATHFINDER_CONTRACTIONHIERARCHY_H_INCLUDED)
+#define PATHFINDER_CONTRACTIONHIERARCHY_H_INCLUDED
+
+#pragma once
+
+#include "CompactGraph.h"
+#include "PathFinder.h"
+#include "SearchContext.h"
+#include "Span.h"
+
+#include <cstdint>
+#include <vector>
+
+//! Contraction hierarchy of a static graph, for very fast shortest path queries.
+//!
+//! Preprocessing contracts the nodes one at a time, from least to most important. When a node is contracted, a
+//! shortcut edge is added between each pair of its remaining neighbors whose shortest path runs through it, unless a
+//! search finds another path that is no longer (a witness). The order in which nodes are contracted is their rank.
+//!
+//! A query runs a bidirectional Dijkstra search in which each direction only follows edges toward higher-ranked nodes,
+//! so both searches climb quickly to the few important nodes, where they meet. The shortcuts in the path are then
+//! unpacked recursively into the edges of the original graph, using the node that each shortcut bypasses.
+//!
+//! Preprocessing is done once, when the hierarchy is constructed. The hierarchy is not modified by a query, so any
+//! number of threads can query it at the same time, as long as each one uses its own context.
+//!
+//! A hierarchy can also be constructed from a View of arrays that it does not own, such as those of a GraphFile, in
+//! which case they are used in place.
+class ContractionHierarchy
+{
+public:
+
+    using Context   = SearchContext;            //!< The state of a query.
+    using IndexPath = std::vector<uint32_t>;    //!< A path of node indexes.
+
+    //! An edge between a node and a higher-ranked node.
+    struct Edge
+    {
+        uint32_t node;      //!< The other node
+        float cost;         //!< Cost of the edge
+        uint32_t middle;    //!< Node bypassed by a shortcut, or NONE for an edge of the original graph
+    };
+
+    //! The arrays of a hierarchy.
+    struct View
+    {
+        Span<uint32_t const> ranks;         //!< Rank of each node
+        Span<uint32_t const> upOffsets;     //!< Index of the first upward edge of each node, then the number of them
+        Span<Edge const> up;                //!< Edges leaving each node toward higher-ranked nodes
+        Span<uint32_t const> downOffsets;   //!< Index of the first downward edge of each node, then the number of them
+        Span<Edge const> down;              //!< Edges entering each node from higher-ranked nodes
+        uint32_t shortcuts = 0;             //!< Number of shortcuts among the edges
+    };
+
+    //! Builds the hierarchy of a compact graph.
+    explicit ContractionHierarchy(CompactGraph const & graph);
+
+    //! Builds the hierarchy of a graph of PathFinder nodes. The nodes are assigned their indexes in the list.
+    explicit ContractionHierarchy(PathFinder::NodeList * domain);
+
+    //! Constructs a hierarchy that uses the arrays of another one in place. The arrays must outlive it.
+    explicit ContractionHierarchy(View const & view);
+
+    //! Finds the shortest path. Returns true if a path was found.
+    bool findPath(uint32_t start, uint32_t end, IndexPath * path);
+
+    //! Finds the shortest path using the given context. Returns true if a path was found.
+    bool findPath(Context & context, uint32_t start, uint32_t end, IndexPath * path) const;
+
+    //! Finds the shortest path between two PathFinder nodes using the given context. Returns true if a path was found.
+    bool findPath(Context & context, PathFinder::Node * start, PathFinder::Node * end, PathFinder::Path * path) const;
+
+    //! Returns the cost of the shortest path, or INFINITY if there is none, without unpacking the path.
+    float findCost(Context & context, uint32_t start, uint32_t end) const;
+
+    //! Returns the number of nodes.
+    uint32_t size() const { return (uint32_t)view_.ranks.size(); }
+
+    //! Returns a node's rank. Nodes with higher ranks were contracted later.
+    uint32_t rank(uint32_t node) const { return view_.ranks[node]; }
+
+    //! Returns the number of shortcuts added by preprocessing.
+    uint32_t shortcutCount() const { return view_.shortcuts; }
+
+    //! Returns the hierarchy's arrays. They remain valid until the hierarchy is destroyed.
+    View const & view() const { return view_; }
+
+    //! Returns the number of bytes used by the hierarchy's arrays.
+    size_t memoryUsage() const;
+
+private:
+
+    // Contracts the graph's nodes and builds the upward and downward edges
+    void build(CompactGraph const & graph);
+
+    // Runs the bidirectional upward search. Returns the node where the best path meets, or NONE.
+    uint32_t search(Context & forward, uint32_t start, uint32_t end, float * cost) const;
+
+    // Appends the nodes of the original path represented by an edge, not including the first node. Returns false if
+    // an edge is missing.
+    bool unpack(uint32_t from, uint32_t to, IndexPath * path) const;
+
+    // Returns the edge from one node to another, or nullptr if there is none
+    Edge const * edge(uint32_t from, uint32_t to) const;
+
+    std::vector<uint32_t> rank_;        // Arrays built by preprocessing, if the hierarchy owns them
+    std::vector<uint32_t> upOffsets_;
+    std::vector<Edge> up_;
+    std::vector<uint32_t> downOffsets_;
+    std::vector<Edge> down_;
+    View view_;                         // The arrays used by queries
+    NodeGraph nodes_{ nullptr };        // The list of nodes, if the hierarchy was built from one
+    Context context_;                   // Context used by findPath when one is not provided
+};
+
+#endif // !defined(PATHFINDER_CONTRACTIONHIERARCHY_H_INCLUDED)
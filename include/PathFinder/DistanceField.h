@@ -0,0 +1,306 @@
+#if !defined(PATHFINDER_DISTANCEFIELD_H_INCLUDED)
+#define PATHFINDER_DISTANCEFIELD_H_INCLUDED
+
+#pragma once
+
+#include "Heuristics.h"
+#include "OpenList.h"
+#include "PathFinder.h"
+#include "ReverseAdjacency.h"
+#include "SearchContext.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+//! The cost from every node to a single goal, and the next step toward it (a "flow field").
+//!
+//! The field is computed by one Dijkstra search from the goal that follows edges in reverse, so any number of agents
+//! heading for the same goal can read their paths from it in O(path length), without searching. The graph and cost
+//! policy have the same requirements as for BasicPathFinder.
+//!
+//! When the goal moves, moveGoal() reuses the nodes whose shortest path to the old goal passes through the new goal.
+//! Their costs simply drop by the old cost of the new goal, and their next steps do not change, so only the rest of
+//! the nodes are searched again. The closer the new goal is to the old one, the more nodes are reused.
+//!
+//! The field is not modified by reading it, so any number of threads can read it at the same time.
+template <typename Graph, typename CostPolicy = EdgeCost>
+class BasicDistanceField
+{
+public:
+
+    using Vertex = typename Graph::Vertex;  //!< A node as identified by users of the graph.
+    using Path   = std::vector<Vertex>;     //!< A path.
+
+    static uint32_t constexpr NONE = SearchContext::NONE;   //!< Index denoting no node
+
+    BasicDistanceField(Graph graph, CostPolicy const & costPolicy = CostPolicy());
+
+    //! Computes the field for a goal.
+    void compute(Vertex goal);
+
+    //! Updates the field for a new goal, reusing as much of the current field as possible.
+    void moveGoal(Vertex goal);
+
+    //! Rebuilds the reverse adjacency. Call this after the graph's edges change, and then recompute the field.
+    void updateReverseAdjacency() { reverse_ = ReverseAdjacency(graph_); }
+
+    //! Returns the goal.
+    Vertex goal() const { return graph_.vertex(goal_); }
+
+    //! Returns true if the goal can be reached from a node. It cannot be reached from a node that is not in the field,
+    //! such as any node before the field is computed.
+    bool reachable(Vertex node) const
+    {
+        uint32_t i = find(node);
+        return i != NONE && std::isfinite(costs_[i]);
+    }
+
+    //! Returns the cost from a node to the goal, or INFINITY if the goal cannot be reached.
+    float cost(Vertex node) const
+    {
+        uint32_t i = find(node);
+        return (i != NONE) ? costs_[i] : INFINITY;
+    }
+
+    //! Returns the next node on the way from a node to the goal, or the node itself if it is the goal or the goal
+    //! cannot be reached from it.
+    Vertex next(Vertex node) const
+    {
+        uint32_t i = find(node);
+        uint32_t n = (i != NONE) ? next_[i] : NONE;
+        return (n != NONE) ? graph_.vertex(n) : node;
+    }
+
+    //! Gets the path from a node to the goal. Returns false if the goal cannot be reached.
+    bool path(Vertex from, Path * path) const;
+
+    //! Returns the cost from each node to the goal, indexed by node index.
+    std::vector<float> const & costs() const { return costs_; }
+
+    //! Returns the index of the next node toward the goal for each node, indexed by node index. The entry is NONE for
+    //! the goal and for nodes from which it cannot be reached.
+    std::vector<uint32_t> const & nextHops() const { return next_; }
+
+    //! Returns the number of nodes settled by the last call to compute() or moveGoal().
+    uint32_t settled() const { return settled_; }
+
+    //! Returns the graph.
+    Graph const & graph() const { return graph_; }
+
+private:
+
+    enum State : uint8_t
+    {
+        UNVISITED,
+        OPEN,
+        SETTLED
+    };
+
+    // Connects the open list to the field
+    struct OpenListAccess
+    {
+        float priority(uint32_t i) const { return field->costs_[i]; }
+        uint32_t handle(uint32_t i) const { return field->handle_[i]; }
+        void setHandle(uint32_t i, uint32_t handle) const { field->handle_[i] = handle; }
+
+        BasicDistanceField * field;
+    };
+
+    using Open = IndexedHeapOpenList<uint32_t, OpenListAccess>;
+
+    // Returns the index of a node, or NONE if it is not in the field
+    uint32_t find(Vertex node) const
+    {
+        uint32_t i = graph_.index(node);
+        return (i < costs_.size()) ? i : NONE;
+    }
+
+    // Settles the open nodes and everything that can reach them, appending them to the settle order
+    void sweep(Open & open);
+
+    // Relaxes the edges entering a settled node
+    void relax(Open & open, uint32_t node);
+
+    Graph graph_;
+    CostPolicy costPolicy_;
+    ReverseAdjacency reverse_;
+    uint32_t goal_ = NONE;
+    uint32_t settled_ = 0;
+    std::vector<float> costs_;      // Cost to the goal
+    std::vector<uint32_t> next_;    // Next node toward the goal
+    std::vector<uint32_t> order_;   // Nodes in the order they were settled. A node always follows its next node.
+    std::vector<uint32_t> handle_;  // Location of each open node in the open list
+    std::vector<State> state_;      // State of each node in the current sweep
+};
+
+//! @param  graph       Graph. Its reverse adjacency is built here.
+//! @param  costPolicy  Computes the cost of traversing an edge
+
+template <typename Graph, typename CostPolicy>
+BasicDistanceField<Graph, CostPolicy>::BasicDistanceField(Graph graph, CostPolicy const & costPolicy)
+    : graph_(std::move(graph))
+    , costPolicy_(costPolicy)
+    , reverse_(graph_)
+{
+}
+
+//! @param  goal    Node that every path leads to
+
+template <typename Graph, typename CostPolicy>
+void BasicDistanceField<Graph, CostPolicy>::compute(Vertex goal)
+{
+    uint32_t const size = graph_.size();
+    assert(reverse_.size() == size);
+
+    goal_ = graph_.index(goal);
+    assert(goal_ < size);
+
+    costs_.assign(size, INFINITY);
+    next_.assign(size, NONE);
+    handle_.resize(size);
+    state_.assign(size, UNVISITED);
+    order_.clear();
+    order_.reserve(size);
+
+    Open open(OpenListAccess{ this });
+    costs_[goal_] = 0.0f;
+    state_[goal_] = OPEN;
+    open.push(goal_);
+    sweep(open);
+}
+
+//! @param  goal    New goal
+//!
+//! @note   If the new goal could not reach the old goal, then nothing can be reused and the field is recomputed.
+
+template <typename Graph, typename CostPolicy>
+void BasicDistanceField<Graph, CostPolicy>::moveGoal(Vertex goal)
+{
+    uint32_t const g = find(goal);
+    if (goal_ == NONE || g == NONE || !std::isfinite(costs_[g]))
+    {
+        compute(goal);
+        return;
+    }
+    if (g == goal_)
+    {
+        settled_ = 0;
+        return;
+    }
+
+    // The nodes whose paths pass through the new goal form its subtree in the shortest path tree. Because each node
+    // follows its next node in the settle order, the subtree can be found in a single pass. Those nodes' paths are
+    // still the shortest and they keep them. The other nodes are reset.
+
+    float const offset = costs_[g];
+    std::fill(state_.begin(), state_.end(), UNVISITED);
+    state_[g] = SETTLED;
+
+    std::vector<uint32_t> const old = std::move(order_);
+    order_.clear();
+    order_.reserve(old.size());
+    for (uint32_t i : old)
+    {
+        if (i == g || (next_[i] != NONE && state_[next_[i]] == SETTLED))
+        {
+            state_[i] = SETTLED;
+            costs_[i] -= offset;
+            order_.push_back(i);
+        }
+    }
+    next_[g] = NONE;
+    costs_[g] = 0.0f;
+
+    for (uint32_t i : old)
+    {
+        if (state_[i] != SETTLED)
+        {
+            costs_[i] = INFINITY;
+            next_[i]  = NONE;
+        }
+    }
+
+    // Search the rest of the graph from the edge of the subtree
+
+    goal_ = g;
+    Open open(OpenListAccess{ this });
+    uint32_t const reused = (uint32_t)order_.size();
+    for (uint32_t k = 0; k < reused; ++k)
+    {
+        relax(open, order_[k]);
+    }
+    sweep(open);
+}
+
+//! @param    from  Start node
+//! @param    path  Path from the start node to the goal
+//!
+//! @returns    true, if the goal can be reached
+
+template <typename Graph, typename CostPolicy>
+bool BasicDistanceField<Graph, CostPolicy>::path(Vertex from, Path * path) const
+{
+    assert(path);
+    path->clear();
+
+    uint32_t i = find(from);
+    if (i == NONE || !std::isfinite(costs_[i]))
+        return false;
+
+    for (; i != NONE; i = next_[i])
+    {
+        path->push_back(graph_.vertex(i));
+    }
+    return true;
+}
+
+template <typename Graph, typename CostPolicy>
+void BasicDistanceField<Graph, CostPolicy>::sweep(Open & open)
+{
+    settled_ = 0;
+    while (!open.empty())
+    {
+        uint32_t current = open.top();
+        open.pop();
+        state_[current] = SETTLED;
+        order_.push_back(current);
+        ++settled_;
+
+        relax(open, current);
+    }
+}
+
+template <typename Graph, typename CostPolicy>
+void BasicDistanceField<Graph, CostPolicy>::relax(Open & open, uint32_t node)
+{
+    float const cost = costs_[node];
+    reverse_.forEachEdge(node, [&] (uint32_t from, float edgeCost) {
+        if (state_[from] == SETTLED)
+            return;
+
+        float c = cost + costPolicy_(graph_, from, node, edgeCost);
+        if (c < costs_[from])
+        {
+            costs_[from] = c;
+            next_[from]  = node;
+            if (state_[from] == UNVISITED)
+            {
+                state_[from] = OPEN;
+                open.push(from);
+            }
+            else
+            {
+                open.decrease(from);
+            }
+        }
+    });
+}
+
+extern template class BasicDistanceField<NodeGraph, EdgeCost>;
+
+//! Distance field over a graph of user-defined nodes, with the costs of their edges.
+using DistanceField = BasicDistanceField<NodeGraph, EdgeCost>;
+
+#endif // !defined(PATHFINDER_DISTANCEFIELD_H_INCLUDED)
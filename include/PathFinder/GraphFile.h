@@ -0,0 +1,104 @@
+#if !defined(PATHFINDER_GRAPHFILE_H_INCLUDED)
+#define PATHFINDER_GRAPHFILE_H_INCLUDED
+
+#pragma once
+
+#include "CompactGraph.h"
+#include "ContractionHierarchy.h"
+#include "Landmarks.h"
+
+#include <cstddef>
+#include <cstdint>
+
+//! Binary file holding a graph and its preprocessing data, which is mapped into memory and used in place.
+//!
+//! The file holds the arrays of a CompactGraph, and optionally the tables of its landmarks and the arrays of its
+//! contraction hierarchy, laid out exactly as they are in memory. Each array is a section of the file, located by its
+//! offset from the start of the file, so the file contains no pointers and can be mapped at any address. Opening a
+//! file maps it and checks its header and the sizes of its sections, and then the views returned by graph(),
+//! landmarks() and hierarchy() point into the mapping, so nothing is parsed, copied or fixed up. The pages are read
+//! from disk when a search first touches them, and processes that map the same file share one copy in the page cache.
+//!
+//! The header records the version of the format and the byte order of the machine that wrote it. A file with another
+//! version or byte order is rejected rather than converted, so it must be written again. Each section starts on a
+//! 64-byte boundary.
+//!
+//! Since opening a file does not read its arrays, the file must be trusted: offsets that decrease, or indexes of nodes
+//! that are not in the graph, make searches read out of bounds. validate() reads every array and checks them, so a
+//! file from an untrusted source can be checked once after it is opened.
+//!
+//! Example:
+//!
+//!     GraphFile::write("world.graph", graph.view(), landmarks.table(), &hierarchy);
+//!     ...
+//!     GraphFile file;
+//!     if (file.open("world.graph"))
+//!     {
+//!         BasicPathFinder<CompactGraphView, LandmarkTableHeuristic> pathFinder(file.graph(), policy,
+//!                                                                              { file.landmarks() });
+//!         ContractionHierarchy hierarchy(file.hierarchy());
+//!     }
+class GraphFile
+{
+public:
+
+    static uint32_t constexpr VERSION = 1;  //!< Version of the format
+
+    GraphFile() = default;
+    ~GraphFile();
+    GraphFile(GraphFile && other) noexcept;
+    GraphFile & operator =(GraphFile && other) noexcept;
+    GraphFile(GraphFile const &) = delete;
+    GraphFile & operator =(GraphFile const &) = delete;
+
+    //! Writes a graph, and optionally its landmarks and contraction hierarchy, to a file. Returns false if the file
+    //! cannot be written.
+    static bool write(char const *                 path,
+                      CompactGraphView const &     graph,
+                      LandmarkTable const &        landmarks = LandmarkTable(),
+                      ContractionHierarchy const * hierarchy = nullptr);
+
+    //! Maps a file into memory. Returns false if it cannot be mapped or is not a graph file of this version.
+    bool open(char const * path);
+
+    //! Unmaps the file. The views of its contents are no longer valid.
+    void close();
+
+    //! Checks that every offset and node index in the open file is in range, reading the whole file. Returns false if
+    //! a search of the graph, the landmarks or the hierarchy could read out of bounds.
+    bool validate() const;
+
+    //! Returns true if a file is mapped.
+    bool isOpen() const { return data_ != nullptr; }
+
+    //! Returns the number of bytes in the file.
+    size_t size() const { return size_; }
+
+    //! Returns the graph.
+    CompactGraphView const & graph() const { return graph_; }
+
+    //! Returns true if the file holds landmarks.
+    bool hasLandmarks() const { return landmarks_.count() > 0; }
+
+    //! Returns the landmarks' tables.
+    LandmarkTable const & landmarks() const { return landmarks_; }
+
+    //! Returns true if the file holds a contraction hierarchy.
+    bool hasHierarchy() const { return !hierarchy_.ranks.empty(); }
+
+    //! Returns the contraction hierarchy's arrays, from which a ContractionHierarchy can be constructed.
+    ContractionHierarchy::View const & hierarchy() const { return hierarchy_; }
+
+private:
+
+    // Checks the header and the sections of the mapped file, and sets up the views of them
+    bool bind();
+
+    void const * data_ = nullptr;   // Mapped file
+    size_t size_ = 0;
+    CompactGraphView graph_;
+    LandmarkTable landmarks_;
+    ContractionHierarchy::View hierarchy_;
+};
+
+#endif // !defined(PATHFINDER_GRAPHFILE_H_INCLUDED)
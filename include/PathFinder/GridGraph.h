@@ -0,0 +1,186 @@
+#if !defined(PATHFINDER_GRIDGRAPH_H_INCLUDED)
+#define PATHFINDER_GRIDGRAPH_H_INCLUDED
+
+#pragma once
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+//! 8-connected grid graph whose edges are generated on the fly.
+//!
+//! The grid is a view of arrays owned by the user: a passability map with one byte per cell (non-zero is passable),
+//! and optionally either a cost array or a height array with one float per cell. No nodes or edges are stored, so the
+//! graph takes 1 to 5 bytes per cell and there is nothing to build before searching it.
+//!
+//! A cell is identified by its index, y * width + x. The cost of a step from one cell to a neighbor is the length of
+//! the step (1 or sqrt(2)) scaled according to the cost model:
+//!
+//!     uniform:    1
+//!     costs:      the average of the costs of the two cells
+//!     heights:    1 + the change in height times the uphill or downhill factor
+//!
+//! By default, a diagonal step is allowed only if both of the cells it cuts across are passable.
+class GridGraph
+{
+public:
+
+    using Vertex = uint32_t;    //!< A cell is identified by its index.
+
+    static float constexpr SQRT2 = 1.41421356f;
+
+    //! Constructor.
+    GridGraph(int width, int height, uint8_t const * passable)
+        : width_(width)
+        , height_(height)
+        , passable_(passable)
+    {
+        assert(width > 0 && height > 0 && passable);
+    }
+
+    //! Sets the cost array. The cost of a step is scaled by the average of the costs of the cells.
+    GridGraph & setCosts(float const * costs)
+    {
+        costs_   = costs;
+        heights_ = nullptr;
+        return *this;
+    }
+
+    //! Sets the height array. The cost of a step is scaled by 1 + the change in height times the uphill or downhill
+    //! factor.
+    GridGraph & setHeights(float const * heights, float uphill, float downhill)
+    {
+        heights_  = heights;
+        uphill_   = uphill;
+        downhill_ = downhill;
+        costs_    = nullptr;
+        return *this;
+    }
+
+    //! Sets whether a diagonal step may cut across the corner of an impassable cell.
+    GridGraph & setCutCorners(bool cutCorners)
+    {
+        cutCorners_ = cutCorners;
+        return *this;
+    }
+
+    //! Returns the width of the grid.
+    int width() const { return width_; }
+
+    //! Returns the height of the grid.
+    int height() const { return height_; }
+
+    //! Returns the number of cells.
+    uint32_t size() const { return (uint32_t)width_ * (uint32_t)height_; }
+
+    //! Returns the index of a cell.
+    uint32_t index(uint32_t cell) const { return cell; }
+
+    //! Returns the cell with the given index.
+    uint32_t vertex(uint32_t i) const { return i; }
+
+    //! Returns the index of the cell at (x, y).
+    uint32_t cell(int x, int y) const { return (uint32_t)y * (uint32_t)width_ + (uint32_t)x; }
+
+    //! Returns the x coordinate of a cell.
+    int x(uint32_t i) const { return (int)(i % (uint32_t)width_); }
+
+    //! Returns the y coordinate of a cell.
+    int y(uint32_t i) const { return (int)(i / (uint32_t)width_); }
+
+    //! Returns true if (x, y) is in the grid.
+    bool contains(int x, int y) const { return x >= 0 && x < width_ && y >= 0 && y < height_; }
+
+    //! Returns true if the cell at (x, y) is in the grid and is passable.
+    bool passable(int x, int y) const { return contains(x, y) && passable_[cell(x, y)] != 0; }
+
+    //! Returns true if the grid uses uniform costs.
+    bool uniform() const { return costs_ == nullptr && heights_ == nullptr; }
+
+    //! Returns true if diagonal steps may cut across corners.
+    bool cutCorners() const { return cutCorners_; }
+
+    //! Returns the lowest cost per unit of distance, which can be used to scale a geometric heuristic.
+    float minimumCostScale() const;
+
+    //! Returns the cost of a step from one cell to an adjacent cell.
+    float stepCost(uint32_t from, uint32_t to, bool diagonal) const
+    {
+        float length = diagonal ? SQRT2 : 1.0f;
+        if (costs_)
+        {
+            return length * 0.5f * (costs_[from] + costs_[to]);
+        }
+        else if (heights_)
+        {
+            float dz = heights_[to] - heights_[from];
+            return length * (1.0f + ((dz > 0.0f) ? dz * uphill_ : -dz * downhill_));
+        }
+        return length;
+    }
+
+    //! Calls visit(to, cost) for each step from a cell to a passable neighbor.
+    template <typename Visitor>
+    void forEachEdge(uint32_t i, Visitor && visit) const
+    {
+        int x0 = x(i);
+        int y0 = y(i);
+
+        // Straight steps
+        bool const w = passable(x0 - 1, y0);
+        bool const e = passable(x0 + 1, y0);
+        bool const s = passable(x0, y0 - 1);
+        bool const n = passable(x0, y0 + 1);
+        if (w)
+            visit(i - 1, stepCost(i, i - 1, false));
+        if (e)
+            visit(i + 1, stepCost(i, i + 1, false));
+        if (s)
+            visit(i - width_, stepCost(i, i - width_, false));
+        if (n)
+            visit(i + width_, stepCost(i, i + width_, false));
+
+        // Diagonal steps
+        if (passable(x0 - 1, y0 - 1) && (cutCorners_ || (w && s)))
+            visit(i - width_ - 1, stepCost(i, i - width_ - 1, true));
+        if (passable(x0 + 1, y0 - 1) && (cutCorners_ || (e && s)))
+            visit(i - width_ + 1, stepCost(i, i - width_ + 1, true));
+        if (passable(x0 - 1, y0 + 1) && (cutCorners_ || (w && n)))
+            visit(i + width_ - 1, stepCost(i, i + width_ - 1, true));
+        if (passable(x0 + 1, y0 + 1) && (cutCorners_ || (e && n)))
+            visit(i + width_ + 1, stepCost(i, i + width_ + 1, true));
+    }
+
+private:
+
+    int width_;
+    int height_;
+    uint8_t const * passable_;
+    float const * costs_   = nullptr;
+    float const * heights_ = nullptr;
+    float uphill_          = 0.0f;
+    float downhill_        = 0.0f;
+    bool cutCorners_       = false;
+};
+
+inline float GridGraph::minimumCostScale() const
+{
+    if (costs_)
+    {
+        float lowest = INFINITY;
+        for (uint32_t i = 0, n = size(); i < n; ++i)
+        {
+            if (passable_[i] && costs_[i] < lowest)
+                lowest = costs_[i];
+        }
+        return std::isfinite(lowest) ? lowest : 1.0f;
+    }
+    else if (heights_)
+    {
+        // A step across level ground costs its length, unless one of the factors is negative
+        return (uphill_ < 0.0f || downhill_ < 0.0f) ? 0.0f : 1.0f;
+    }
+    return 1.0f;
+}
+
+#endif // !defined(PATHFINDER_GRIDGRAPH_H_INCLUDED)
@@ -0,0 +1,32 @@
+#if !defined(PATHFINDER_GRIDPATHFINDER_H_INCLUDED)
+#define PATHFINDER_GRIDPATHFINDER_H_INCLUDED
+
+#pragma once
+
+#include "BasicPathFinder.h"
+#include "GridGraph.h"
+#include "Heuristics.h"
+
+extern template class BasicPathFinder<GridGraph, OctileHeuristic, EdgeCost>;
+
+//! A* pathfinder for 8-connected grids.
+//!
+//! This is the instantiation of BasicPathFinder for GridGraph, using the octile distance scaled by the grid's lowest
+//! cost per unit of distance as the heuristic. No nodes or edges are allocated, so a search can start as soon as the
+//! grid's arrays exist.
+class GridPathFinder : public BasicPathFinder<GridGraph, OctileHeuristic, EdgeCost>
+{
+public:
+
+    GridPathFinder(GridGraph const & grid, Policy const & policy);
+
+    using BasicPathFinder::findPath;
+
+    //! Finds the shortest path from (x0, y0) to (x1, y1). Returns true if a path was found.
+    bool findPath(int x0, int y0, int x1, int y1, Path * path);
+
+    //! Finds the shortest path from (x0, y0) to (x1, y1) using the given context. Returns true if a path was found.
+    bool findPath(Context & context, int x0, int y0, int x1, int y1, Path * path) const;
+};
+
+#endif // !defined(PATHFINDER_GRIDPATHFINDER_H_INCLUDED)
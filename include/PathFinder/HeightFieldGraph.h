@@ -0,0 +1,205 @@
+#if !defined(PATHFINDER_HEIGHTFIELDGRAPH_H_INCLUDED)
+#define PATHFINDER_HEIGHTFIELDGRAPH_H_INCLUDED
+
+#pragma once
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+//! Heights sampled on a regular grid, loaded from an image.
+struct HeightMap
+{
+    //! Loads an uncompressed TGA image (color-mapped, true-color or grayscale). The height of each pixel is the average
+    //! of its color components, scaled so that 255 is the given scale. The first row is the bottom of the image.
+    //! Returns false if the file cannot be read or is not a supported image.
+    bool load(char const * path, float scale);
+
+    //! Returns the height at (x, y).
+    float z(int x, int y) const { return heights[(size_t)y * width + x]; }
+
+    int width  = 0;             //!< Number of samples in each row
+    int height = 0;             //!< Number of rows
+    std::vector<float> heights; //!< Samples, row by row
+};
+
+//! 8-connected grid graph whose edge costs are computed in advance from a height field by HeightFieldBuilder.
+//!
+//! The graph is a view of the builder's arrays, so it is cheap to copy, and it reflects the builder's updates. The
+//! cells and steps are the same as GridGraph's, and the cost of a step is that of GridGraph's height model. Unlike
+//! GridGraph, the costs are not computed during the search, so each expansion reads the 8 costs of a cell from one
+//! cache line. A step that is not allowed costs INFINITY.
+class HeightFieldGraph
+{
+public:
+
+    using Vertex = uint32_t;    //!< A cell is identified by its index.
+
+    static int constexpr DIRECTIONS = 8;    //!< Number of steps from a cell
+    static int const DX[DIRECTIONS];        //!< Change in x of each step: W, E, S, N, SW, SE, NW, NE
+    static int const DY[DIRECTIONS];        //!< Change in y of each step
+
+    //! Constructor. The costs are DIRECTIONS floats per cell, in the order of DX and DY.
+    HeightFieldGraph(int width, int height, float const * costs, uint8_t const * passable, float minimumCostScale)
+        : width_(width)
+        , height_(height)
+        , costs_(costs)
+        , passable_(passable)
+        , minimumCostScale_(minimumCostScale)
+    {
+        assert(width > 0 && height > 0 && costs && passable);
+        for (int d = 0; d < DIRECTIONS; ++d)
+        {
+            offsets_[d] = DY[d] * width + DX[d];
+        }
+    }
+
+    //! Returns the width of the grid.
+    int width() const { return width_; }
+
+    //! Returns the height of the grid.
+    int height() const { return height_; }
+
+    //! Returns the number of cells.
+    uint32_t size() const { return (uint32_t)width_ * (uint32_t)height_; }
+
+    //! Returns the index of a cell.
+    uint32_t index(uint32_t cell) const { return cell; }
+
+    //! Returns the cell with the given index.
+    uint32_t vertex(uint32_t i) const { return i; }
+
+    //! Returns the index of the cell at (x, y).
+    uint32_t cell(int x, int y) const { return (uint32_t)y * (uint32_t)width_ + (uint32_t)x; }
+
+    //! Returns the x coordinate of a cell.
+    int x(uint32_t i) const { return (int)(i % (uint32_t)width_); }
+
+    //! Returns the y coordinate of a cell.
+    int y(uint32_t i) const { return (int)(i / (uint32_t)width_); }
+
+    //! Returns true if (x, y) is in the grid.
+    bool contains(int x, int y) const { return x >= 0 && x < width_ && y >= 0 && y < height_; }
+
+    //! Returns true if the cell at (x, y) is in the grid and is passable.
+    bool passable(int x, int y) const { return contains(x, y) && passable_[cell(x, y)] != 0; }
+
+    //! Returns the cost of a step from a cell in one of the directions, or INFINITY if the step is not allowed.
+    float cost(uint32_t i, int direction) const { return costs_[(size_t)i * DIRECTIONS + direction]; }
+
+    //! Returns the lowest cost per unit of distance, which can be used to scale a geometric heuristic.
+    float minimumCostScale() const { return minimumCostScale_; }
+
+    //! Calls visit(to, cost) for each allowed step from a cell.
+    template <typename Visitor>
+    void forEachEdge(uint32_t i, Visitor && visit) const
+    {
+        float const * costs = costs_ + (size_t)i * DIRECTIONS;
+        for (int d = 0; d < DIRECTIONS; ++d)
+        {
+            if (costs[d] < INFINITY)
+                visit(i + (uint32_t)offsets_[d], costs[d]);
+        }
+    }
+
+private:
+
+    int width_;
+    int height_;
+    float const * costs_;
+    uint8_t const * passable_;
+    float minimumCostScale_;
+    int offsets_[DIRECTIONS];   // Change in index of each step
+};
+
+//! Builds a HeightFieldGraph from a height field, and rebuilds the parts of it that change when the terrain is edited.
+//!
+//! The graph samples every stride-th height, leaving out a margin of samples at each edge. A cell is passable if its
+//! height is at or above sea level, and a passable cell has steps to its passable neighbors, with the same costs and
+//! corner rules as GridGraph's height model. An impassable cell has no steps.
+//!
+//! The build runs in two passes over the rows: the first samples the heights and computes the passability mask, and
+//! the second computes the costs of the 8 steps from each cell. Each pass splits the rows among the threads of a pool,
+//! if one is given. Within a row, the mask and the cost of each direction are computed by SSE2 kernels (where
+//! available) that treat impassable cells as an infinite penalty, so they have no branches. The costs of a row are
+//! computed direction by direction and then interleaved, so that the graph has the costs of each cell together.
+//!
+//! After heights in the field change, update() rebuilds only the cells that sample the changed area and their
+//! neighbors. The heights are read only by build() and update(), so the field may be edited between them.
+class HeightFieldBuilder
+{
+public:
+
+    //! How the graph is built.
+    struct Settings
+    {
+        int stride     = 1;     //!< Distance between samples, in the height field
+        int margin     = 0;     //!< Number of samples left out at each edge of the field
+        float seaLevel = 0.0f;  //!< Cells below this height are impassable
+        float uphill   = 1.0f;  //!< Cost of climbing per unit of height
+        float downhill = 0.0f;  //!< Cost of descending per unit of height
+        bool cutCorners = true; //!< If true, a diagonal step may cut across the corner of an impassable cell
+    };
+
+    //! Constructor. The heights are a view of width * height floats, row by row, which must outlive the builder.
+    HeightFieldBuilder(float const * heights, int width, int height, Settings const & settings);
+
+    //! Changes the settings. The graph is not valid until it is built again.
+    void setSettings(Settings const & settings);
+
+    //! Builds the whole graph, using the threads of the pool if one is given.
+    void build(ThreadPool * pool = nullptr);
+
+    //! Rebuilds the part of the graph that depends on the heights in [x0, x1) x [y0, y1) of the field.
+    void update(int x0, int y0, int x1, int y1, ThreadPool * pool = nullptr);
+
+    //! Returns the graph. It remains valid until the settings change or the builder is destroyed.
+    HeightFieldGraph graph() const;
+
+    //! Returns the settings.
+    Settings const & settings() const { return settings_; }
+
+    //! Returns the width of the graph.
+    int width() const { return width_; }
+
+    //! Returns the height of the graph.
+    int height() const { return height_; }
+
+    //! Returns the height of a cell.
+    float z(uint32_t i) const { return heights_[i]; }
+
+    //! Returns the field x coordinate sampled by a cell's x coordinate.
+    int fieldX(int x) const { return (x + settings_.margin) * settings_.stride; }
+
+    //! Returns the field y coordinate sampled by a cell's y coordinate.
+    int fieldY(int y) const { return (y + settings_.margin) * settings_.stride; }
+
+private:
+
+    // Samples the heights and computes the passability of the cells in [x0, x1) of a row
+    void sampleRow(int y, int x0, int x1);
+
+    // Computes the costs of the steps from the cells in [x0, x1) of a row, using a scratch buffer
+    void buildRow(int y, int x0, int x1, float * scratch);
+
+    // Runs a pass over the rows in [y0, y1), in parallel if there is a pool
+    template <typename Pass>
+    void forEachRow(int y0, int y1, ThreadPool * pool, Pass && pass);
+
+    float const * field_;           // Height field
+    int fieldWidth_;
+    int fieldHeight_;
+    Settings settings_;
+    int width_  = 0;                // Size of the graph
+    int height_ = 0;
+    std::vector<float> heights_;    // Height of each cell
+    std::vector<float> penalties_;  // 0 for each passable cell, and INFINITY for each impassable cell
+    std::vector<uint8_t> passable_; // 1 for each passable cell, and 0 for each impassable cell
+    std::vector<float> costs_;      // Cost of each step from each cell
+    std::vector<std::vector<float>> scratch_;   // Costs of a row by direction, for each worker
+};
+
+#endif // !defined(PATHFINDER_HEIGHTFIELDGRAPH_H_INCLUDED)
@@ -0,0 +1,82 @@
+#if !defined(PATHFINDER_HEURISTICS_H_INCLUDED)
+#define PATHFINDER_HEURISTICS_H_INCLUDED
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+//! @file
+//! Heuristic and cost policies for BasicPathFinder.
+//!
+//! A heuristic is a function object with this signature, returning the estimated cost from a node to the goal:
+//!
+//!     float operator ()(Graph const & graph, uint32_t from, uint32_t goal) const;
+//!
+//! A cost policy is a function object with this signature, returning the cost of traversing an edge:
+//!
+//!     float operator ()(Graph const & graph, uint32_t from, uint32_t to, float edgeCost) const;
+//!
+//! The geometric heuristics require the graph to provide the coordinates of its nodes through x(i) and y(i). They
+//! are admissible as long as no edge costs less than scale times the distance it spans.
+
+//! Heuristic that always returns 0, turning A* into Dijkstra's algorithm.
+struct ZeroHeuristic
+{
+    template <typename Graph>
+    float operator ()(Graph const &, uint32_t, uint32_t) const { return 0.0f; }
+};
+
+//! Manhattan distance. Suited to 4-connected grids.
+struct ManhattanHeuristic
+{
+    template <typename Graph>
+    float operator ()(Graph const & graph, uint32_t from, uint32_t goal) const
+    {
+        float dx = std::fabs(float(graph.x(goal)) - float(graph.x(from)));
+        float dy = std::fabs(float(graph.y(goal)) - float(graph.y(from)));
+        return scale * (dx + dy);
+    }
+
+    float scale = 1.0f; //!< Minimum cost per unit of distance
+};
+
+//! Euclidean distance. Suited to graphs with movement in any direction.
+struct EuclideanHeuristic
+{
+    template <typename Graph>
+    float operator ()(Graph const & graph, uint32_t from, uint32_t goal) const
+    {
+        float dx = float(graph.x(goal)) - float(graph.x(from));
+        float dy = float(graph.y(goal)) - float(graph.y(from));
+        return scale * std::sqrt(dx * dx + dy * dy);
+    }
+
+    float scale = 1.0f; //!< Minimum cost per unit of distance
+};
+
+//! Octile distance. Suited to 8-connected grids in which a diagonal step costs sqrt(2) times a straight step.
+struct OctileHeuristic
+{
+    template <typename Graph>
+    float operator ()(Graph const & graph, uint32_t from, uint32_t goal) const
+    {
+        float dx = std::fabs(float(graph.x(goal)) - float(graph.x(from)));
+        float dy = std::fabs(float(graph.y(goal)) - float(graph.y(from)));
+        return scale * (std::max(dx, dy) + (SQRT2 - 1.0f) * std::min(dx, dy));
+    }
+
+    static float constexpr SQRT2 = 1.41421356f;
+
+    float scale = 1.0f; //!< Minimum cost per unit of distance
+};
+
+//! Cost policy that uses the cost stored in the edge.
+struct EdgeCost
+{
+    template <typename Graph>
+    float operator ()(Graph const &, uint32_t, uint32_t, float edgeCost) const { return edgeCost; }
+};
+
+#endif // !defined(PATHFINDER_HEURISTICS_H_INCLUDED)
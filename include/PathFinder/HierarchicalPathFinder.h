@@ -0,0 +1,146 @@
+#if !defined(PATHFINDER_HIERARCHICALPATHFINDER_H_INCLUDED)
+#define PATHFINDER_HIERARCHICALPATHFINDER_H_INCLUDED
+
+#pragma once
+
+#include "CompactGraph.h"
+#include "GridGraph.h"
+#include "GridPathFinder.h"
+#include "SearchContext.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+//! Hierarchical pathfinder for large 8-connected grids (HPA*).
+//!
+//! The grid is divided into square clusters. Wherever the cells on both sides of the border between two clusters are
+//! passable, there is an entrance, and the cells at each end of it (or in the middle, if it is short) become nodes of
+//! an abstract graph. Within each cluster, the abstract nodes are linked by edges whose costs are the costs of the
+//! shortest paths between them that stay inside the cluster. These costs are computed in advance.
+//!
+//! A query connects the start and the goal to the abstract nodes of their clusters, searches the much smaller abstract
+//! graph, and then refines the segments between the abstract nodes into paths on the grid using a GridPathFinder.
+//! Each segment is a short search, and the segments can be refined one at a time as they are needed. Because paths
+//! cross between clusters only at the entrances, they are close to optimal but not always optimal. A start and goal
+//! in the same cluster are simply searched on the grid.
+//!
+//! When the grid changes, only the clusters in the changed region and the neighbors sharing their entrances are
+//! rebuilt.
+class HierarchicalPathFinder
+{
+public:
+
+    using Vertex  = uint32_t;               //!< A cell is identified by its index.
+    using Path    = std::vector<uint32_t>;  //!< A path.
+    using Policy  = SearchPolicy;           //!< Pathfinding parameters for searching the grid.
+
+    HierarchicalPathFinder(GridGraph const & grid, int clusterSize, Policy const & policy);
+
+    //! Replaces the grid with one of the same dimensions, without rebuilding anything. Call update() or rebuild().
+    void setGraph(GridGraph const & grid);
+
+    //! Rebuilds the clusters in a region of the grid whose passability or costs have changed. The region is inclusive.
+    void update(int x0, int y0, int x1, int y1);
+
+    //! Rebuilds all of the clusters, for example after a change in the cost model.
+    void rebuild();
+
+    //! Finds a path on the grid. Returns true if a path was found.
+    bool findPath(Vertex start, Vertex end, Path * path);
+
+    //! Finds a path through the abstract graph, as a list of cells to pass through. Returns true if a path was found.
+    bool findAbstractPath(Vertex start, Vertex end, Path * waypoints);
+
+    //! Finds the path on the grid between two consecutive cells of an abstract path. Returns true if a path was found.
+    bool refine(Vertex from, Vertex to, Path * path);
+
+    //! Returns the grid.
+    GridGraph const & graph() const { return grid_; }
+
+    //! Returns the width and height of a cluster.
+    int clusterSize() const { return clusterSize_; }
+
+    //! Returns the number of clusters.
+    uint32_t clusterCount() const { return (uint32_t)clusters_.size(); }
+
+    //! Returns the abstract graph. Node i of the abstract graph is the cell abstractCell(i).
+    CompactGraph const & abstractGraph() const { return abstract_; }
+
+    //! Returns the cell of an abstract node.
+    uint32_t abstractCell(uint32_t node) const { return cells_[node]; }
+
+private:
+
+    // A passage across a cluster's east or north border.
+    struct Transition
+    {
+        uint32_t inside;    // Cell in the cluster
+        uint32_t outside;   // Adjacent cell in the neighboring cluster
+
+        bool operator ==(Transition const & other) const { return inside == other.inside && outside == other.outside; }
+    };
+
+    // An edge between two cells.
+    struct CellEdge
+    {
+        uint32_t from;
+        uint32_t to;
+        float cost;
+    };
+
+    // A cluster's abstract nodes and the edges between them.
+    struct Cluster
+    {
+        std::vector<uint32_t> cells;    // Cells of the abstract nodes, sorted
+        std::vector<CellEdge> edges;    // Costs of the shortest paths between them within the cluster
+    };
+
+    // The cost from a cell to an abstract node, or from an abstract node to a cell
+    struct Link
+    {
+        uint32_t node;
+        float cost;
+    };
+
+    // The abstract graph plus the start and goal of a query
+    struct QueryGraph;
+
+    enum Border
+    {
+        EAST,
+        NORTH
+    };
+
+    // Returns the cluster containing a cell
+    uint32_t clusterOf(int x, int y) const { return (uint32_t)((y / clusterSize_) * clustersX_ + x / clusterSize_); }
+
+    // Finds the transitions across a border
+    void buildBorder(uint32_t cluster, Border border);
+
+    // Finds a cluster's abstract nodes and the costs between them
+    void buildCluster(uint32_t cluster);
+
+    // Assembles the abstract graph from the clusters
+    void assemble();
+
+    // Finds the costs within a cluster from a cell to the abstract nodes (or from the nodes to the cell)
+    void link(uint32_t cluster, uint32_t cell, bool reverse, std::vector<Link> * links);
+
+    GridGraph grid_;
+    int clusterSize_;
+    int clustersX_;
+    int clustersY_;
+    float scale_;                               // Minimum cost per unit of distance
+    std::vector<Cluster> clusters_;
+    std::vector<std::vector<Transition>> borders_;  // Transitions across the east and north borders of each cluster
+    CompactGraph abstract_;                     // Abstract graph
+    std::vector<uint32_t> cells_;               // Cell of each abstract node
+    std::unordered_map<uint32_t, uint32_t> ids_;    // Abstract node of each cell that has one
+    GridPathFinder refiner_;                    // Searches the grid
+    SearchContext context_;                     // Used for searches of the clusters and the abstract graph
+    std::vector<Link> fromStart_;               // Costs from the start to its cluster's abstract nodes
+    std::vector<Link> toGoal_;                  // Costs from the goal's cluster's abstract nodes to the goal
+};
+
+#endif // !defined(PATHFINDER_HIERARCHICALPATHFINDER_H_INCLUDED)
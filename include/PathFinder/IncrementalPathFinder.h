@@ -0,0 +1,359 @@
+#if !defined(PATHFINDER_INCREMENTALPATHFINDER_H_INCLUDED)
+#define PATHFINDER_INCREMENTALPATHFINDER_H_INCLUDED
+
+#pragma once
+
+#include "Heuristics.h"
+#include "OpenList.h"
+#include "PathFinder.h"
+#include "ReverseAdjacency.h"
+#include "SearchContext.h"
+#include "Span.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+//! Pathfinder that repairs its previous search when edge costs change or the start moves (D* Lite).
+//!
+//! The search runs backward from the goal, so each node's cost is its cost to the goal, and the start is free to move
+//! along the path without invalidating anything. Each node has two estimates of its cost: g, the cost from when it was
+//! last expanded, and rhs, the best cost through its successors' current values. A node whose estimates differ is
+//! inconsistent, and only inconsistent nodes are in the open list. When an edge's cost changes, only its source's rhs
+//! is recomputed, and the search expands just the nodes that the change affects, in order of their keys:
+//!
+//!     k = [ min(g, rhs) + h(start, node) + km, min(g, rhs) ]
+//!
+//! where km accumulates the heuristic distances moved by the start, so that the keys already in the open list remain
+//! lower bounds without being recomputed.
+//!
+//! To use it, call reset() with the start and goal, then findPath(). When edges change, apply the new costs to the
+//! graph, report the changed edges with updateEdges(), and call findPath() again. When the agent moves, call
+//! moveStart() before findPath(). The heuristic must be consistent. An edge cost may be INFINITY, which blocks the edge.
+//!
+//! The graph, heuristic and cost policy have the same requirements as for BasicPathFinder. The reverse adjacency is
+//! used only to find the nodes with an edge to a node, so it does not have to be rebuilt when the costs change.
+//!
+//! A node that is not in the graph (such as a node of another list) is an error, asserted in debug builds. In release
+//! builds, reset() with such a node leaves no search, so that findPath() finds no path, and moveStart() and
+//! updateEdges() ignore such a node. Without a search, cost() is INFINITY.
+template <typename Graph, typename Heuristic = ZeroHeuristic, typename CostPolicy = EdgeCost>
+class BasicIncrementalPathFinder
+{
+public:
+
+    using Vertex = typename Graph::Vertex;  //!< A node as identified by users of the graph.
+    using Path   = std::vector<Vertex>;     //!< A path.
+
+    //! An edge whose cost has changed.
+    struct EdgeChange
+    {
+        Vertex from;    //!< Source of the edge
+        Vertex to;      //!< Destination of the edge
+    };
+
+    BasicIncrementalPathFinder(Graph              graph,
+                               Heuristic const &  heuristic  = Heuristic(),
+                               CostPolicy const & costPolicy = CostPolicy());
+
+    // The open list refers to the pathfinder, so it cannot be copied or moved
+    BasicIncrementalPathFinder(BasicIncrementalPathFinder const &) = delete;
+    BasicIncrementalPathFinder & operator =(BasicIncrementalPathFinder const &) = delete;
+
+    //! Starts planning for a new start and goal, discarding the previous search.
+    void reset(Vertex start, Vertex goal);
+
+    //! Moves the start. The search is kept.
+    void moveStart(Vertex start);
+
+    //! Repairs the search after the costs of some edges have changed. The new costs must already be in the graph.
+    void updateEdges(Span<EdgeChange const> changes);
+
+    //! Completes the search and gets the path from the start to the goal. Returns true if a path was found.
+    bool findPath(Path * path);
+
+    //! Returns the cost of the path from the start to the goal after findPath(), or INFINITY if there is none.
+    float cost() const { return (start_ < rhs_.size()) ? rhs_[start_] : INFINITY; }
+
+    //! Returns the number of nodes expanded by the last call to findPath().
+    uint32_t expansions() const { return expansions_; }
+
+    //! Rebuilds the reverse adjacency. Call this after edges are added to or removed from the graph, then call reset().
+    void updateReverseAdjacency() { reverse_ = ReverseAdjacency(graph_); }
+
+    //! Returns the graph.
+    Graph const & graph() const { return graph_; }
+
+private:
+
+    // A key, compared lexicographically
+    struct Priority
+    {
+        float k1;
+        float k2;
+
+        bool operator <(Priority const & other) const { return k1 < other.k1 || (k1 == other.k1 && k2 < other.k2); }
+        bool operator <=(Priority const & other) const { return !(other < *this); }
+    };
+
+    // Connects the open list to the nodes' keys
+    struct OpenListAccess
+    {
+        Priority priority(uint32_t i) const { return finder->key_[i]; }
+        uint32_t handle(uint32_t i) const { return finder->handle_[i]; }
+        void setHandle(uint32_t i, uint32_t handle) const { finder->handle_[i] = handle; }
+
+        BasicIncrementalPathFinder * finder;
+    };
+
+    using Open = IndexedHeapOpenList<uint32_t, OpenListAccess>;
+
+    // Computes a node's key from its current estimates
+    Priority calculateKey(uint32_t i) const
+    {
+        float m = std::min(g_[i], rhs_[i]);
+        return { m + heuristic_(graph_, start_, i) + km_, m };
+    }
+
+    // Recomputes a node's rhs and updates its place in the open list
+    void updateNode(uint32_t i);
+
+    // Expands inconsistent nodes until the start is consistent and no node with a lower key remains
+    void computeShortestPath();
+
+    Graph graph_;
+    Heuristic heuristic_;
+    CostPolicy costPolicy_;
+    ReverseAdjacency reverse_;
+    Open open_;
+    uint32_t start_ = SearchContext::NONE;
+    uint32_t goal_  = SearchContext::NONE;
+    float km_ = 0.0f;
+    uint32_t expansions_ = 0;
+    std::vector<float> g_;          // Cost to the goal when the node was last expanded
+    std::vector<float> rhs_;        // Cost to the goal through the best successor
+    std::vector<Priority> key_;     // Key of each open node
+    std::vector<uint32_t> handle_;  // Location of each open node in the open list
+    std::vector<bool> inOpen_;      // True if the node is in the open list
+};
+
+//! @param  graph       Graph to search. Its reverse adjacency is built here.
+//! @param  heuristic   Estimates the cost from a node to another
+//! @param  costPolicy  Computes the cost of traversing an edge
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+BasicIncrementalPathFinder<Graph, Heuristic, CostPolicy>::BasicIncrementalPathFinder(Graph              graph,
+                                                                                     Heuristic const &  heuristic,
+                                                                                     CostPolicy const & costPolicy)
+    : graph_(std::move(graph))
+    , heuristic_(heuristic)
+    , costPolicy_(costPolicy)
+    , reverse_(graph_)
+    , open_(OpenListAccess{ this })
+{
+}
+
+//! @param  start   Start node
+//! @param  goal    Goal node
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+void BasicIncrementalPathFinder<Graph, Heuristic, CostPolicy>::reset(Vertex start, Vertex goal)
+{
+    uint32_t const size = graph_.size();
+    assert(reverse_.size() == size);
+
+    start_ = graph_.index(start);
+    goal_  = graph_.index(goal);
+    assert(start_ < size && goal_ < size);
+
+    km_ = 0.0f;
+    open_.clear();
+    if (start_ >= size || goal_ >= size)
+    {
+        start_ = SearchContext::NONE;
+        goal_  = SearchContext::NONE;
+        return;
+    }
+
+    g_.assign(size, INFINITY);
+    rhs_.assign(size, INFINITY);
+    key_.resize(size);
+    handle_.resize(size);
+    inOpen_.assign(size, false);
+
+    rhs_[goal_] = 0.0f;
+    key_[goal_] = calculateKey(goal_);
+    inOpen_[goal_] = true;
+    open_.push(goal_);
+}
+
+//! @param  start   New start node
+//!
+//! @note   The keys in the open list are not recomputed. Instead, the heuristic distance from the old start to the new
+//!         one is added to every future key, which keeps the old keys lower bounds, and each old key is updated when
+//!         its node reaches the top of the open list.
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+void BasicIncrementalPathFinder<Graph, Heuristic, CostPolicy>::moveStart(Vertex start)
+{
+    assert(start_ != SearchContext::NONE);
+    uint32_t const s = graph_.index(start);
+    assert(s < graph_.size());
+    if (start_ == SearchContext::NONE || s >= graph_.size())
+        return;
+
+    km_ += heuristic_(graph_, start_, s);
+    start_ = s;
+}
+
+//! @param  changes     Edges whose costs have changed, in any order. An edge may appear more than once.
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+void BasicIncrementalPathFinder<Graph, Heuristic, CostPolicy>::updateEdges(Span<EdgeChange const> changes)
+{
+    if (start_ == SearchContext::NONE)
+        return;
+
+    for (auto const & change : changes)
+    {
+        uint32_t const from = graph_.index(change.from);
+        assert(from < graph_.size());
+        if (from < graph_.size())
+            updateNode(from);
+    }
+}
+
+//! @param  path    Path from the start to the goal, including both
+//!
+//! @returns    true, if a path was found
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+bool BasicIncrementalPathFinder<Graph, Heuristic, CostPolicy>::findPath(Path * path)
+{
+    assert(path);
+    assert(start_ != SearchContext::NONE);
+
+    path->clear();
+    if (start_ == SearchContext::NONE)
+        return false;
+
+    computeShortestPath();
+    if (!std::isfinite(rhs_[start_]))
+        return false;
+
+    // The start's rhs is its cost, even if the search stopped before expanding it. Follow the cheapest successors from
+    // the start. Every node after the start is consistent, so the path is the shortest. A partial path is not returned.
+
+    uint32_t current = start_;
+    path->push_back(graph_.vertex(current));
+    for (uint32_t steps = 0; current != goal_; ++steps)
+    {
+        if (steps >= graph_.size())
+        {
+            path->clear();
+            return false;
+        }
+
+        uint32_t next = SearchContext::NONE;
+        float best = INFINITY;
+        graph_.forEachEdge(current, [&] (uint32_t to, float edgeCost) {
+            float c = costPolicy_(graph_, current, to, edgeCost) + g_[to];
+            if (c < best)
+            {
+                best = c;
+                next = to;
+            }
+        });
+        if (next == SearchContext::NONE)
+        {
+            path->clear();
+            return false;
+        }
+
+        current = next;
+        path->push_back(graph_.vertex(current));
+    }
+    return true;
+}
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+void BasicIncrementalPathFinder<Graph, Heuristic, CostPolicy>::updateNode(uint32_t i)
+{
+    if (i != goal_)
+    {
+        float rhs = INFINITY;
+        graph_.forEachEdge(i, [&] (uint32_t to, float edgeCost) {
+            rhs = std::min(rhs, costPolicy_(graph_, i, to, edgeCost) + g_[to]);
+        });
+        rhs_[i] = rhs;
+    }
+
+    bool const consistent = (g_[i] == rhs_[i]);
+    if (inOpen_[i])
+    {
+        if (consistent)
+        {
+            open_.remove(i);
+            inOpen_[i] = false;
+        }
+        else
+        {
+            key_[i] = calculateKey(i);
+            open_.update(i);
+        }
+    }
+    else if (!consistent)
+    {
+        key_[i] = calculateKey(i);
+        inOpen_[i] = true;
+        open_.push(i);
+    }
+}
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+void BasicIncrementalPathFinder<Graph, Heuristic, CostPolicy>::computeShortestPath()
+{
+    expansions_ = 0;
+    while (!open_.empty() && (key_[open_.top()] < calculateKey(start_) || rhs_[start_] > g_[start_]))
+    {
+        uint32_t const u = open_.top();
+        Priority const oldKey = key_[u];
+        Priority const newKey = calculateKey(u);
+
+        // The key was computed before the start moved. Put it back with its current key.
+        if (oldKey < newKey)
+        {
+            key_[u] = newKey;
+            open_.update(u);
+            continue;
+        }
+
+        ++expansions_;
+        open_.pop();
+        inOpen_[u] = false;
+
+        if (g_[u] > rhs_[u])
+        {
+            // Overconsistent: the node's cost has dropped. Its new cost is final, so propagate it to its predecessors.
+            g_[u] = rhs_[u];
+            reverse_.forEachEdge(u, [&] (uint32_t from, float) { updateNode(from); });
+        }
+        else
+        {
+            // Underconsistent: the node's cost has risen. Invalidate it, and let it and its predecessors find their new
+            // costs.
+            g_[u] = INFINITY;
+            updateNode(u);
+            reverse_.forEachEdge(u, [&] (uint32_t from, float) { updateNode(from); });
+        }
+    }
+}
+
+extern template class BasicIncrementalPathFinder<NodeGraph, NodeHeuristic, EdgeCost>;
+
+//! Incremental pathfinder over a graph of user-defined nodes, with the costs of their edges and the nodes' heuristic.
+using IncrementalPathFinder = BasicIncrementalPathFinder<NodeGraph, NodeHeuristic, EdgeCost>;
+
+#endif // !defined(PATHFINDER_INCREMENTALPATHFINDER_H_INCLUDED)
@@ -0,0 +1,88 @@
+#if !defined(PATHFINDER_JUMPPOINTSEARCH_H_INCLUDED)
+#define PATHFINDER_JUMPPOINTSEARCH_H_INCLUDED
+
+#pragma once
+
+#include "GridGraph.h"
+#include "SearchContext.h"
+
+#include <cstdint>
+#include <vector>
+
+//! Jump Point Search for uniform-cost 8-connected grids.
+//!
+//! JPS finds the same shortest paths as A* on a grid with uniform costs, but it only expands "jump points", the cells
+//! at which an optimal path may have to turn. Runs of cells in between are skipped by scanning the grid in a straight
+//! line, so a search typically expands orders of magnitude fewer nodes.
+//!
+//! In JPS+ mode, the distance from every cell to the next jump point or wall in each of the 8 directions is
+//! precomputed, so the scans become table lookups. The table takes 16 bytes per cell and must be rebuilt by calling
+//! precompute() whenever the passability of the grid changes.
+//!
+//! The grid must have uniform costs and must not allow diagonal steps to cut corners.
+class JumpPointSearch
+{
+public:
+
+    //! Search modes.
+    enum class Mode
+    {
+        JPS,        //!< Jump points are found by scanning the grid
+        JPS_PLUS    //!< Jump points are found using precomputed jump distances
+    };
+
+    using Vertex  = uint32_t;               //!< A cell is identified by its index.
+    using Path    = std::vector<uint32_t>;  //!< A path.
+    using Context = SearchContext;          //!< The state of a search.
+
+    JumpPointSearch(GridGraph const & grid, Mode mode);
+
+    //! Recomputes the jump distances used by JPS+. Call this after the grid's passability has changed.
+    void precompute();
+
+    //! Finds the shortest path from (x0, y0) to (x1, y1). Returns true if a path was found.
+    bool findPath(int x0, int y0, int x1, int y1, Path * path);
+
+    //! Finds the shortest path. Returns true if a path was found.
+    bool findPath(Vertex start, Vertex end, Path * path);
+
+    //! Finds the shortest path using the given context. Returns true if a path was found.
+    bool findPath(Context & context, Vertex start, Vertex end, Path * path) const;
+
+    //! Returns the grid.
+    GridGraph const & graph() const { return grid_; }
+
+    //! Returns the mode.
+    Mode mode() const { return mode_; }
+
+private:
+
+    static int const DX[8];
+    static int const DY[8];
+
+    // Returns the index of the direction (dx, dy)
+    static int direction(int dx, int dy);
+
+    // Returns true if the cell is passable
+    bool passable(int x, int y) const { return grid_.passable(x, y); }
+
+    // Returns true if the cell has a forced neighbor when it is entered moving in the direction (dx, dy)
+    bool forced(int x, int y, int dx, int dy) const;
+
+    // Returns the directions in which to look for jump points from a cell reached from the given direction
+    unsigned successors(int x, int y, int dx, int dy) const;
+
+    // Finds the next jump point from a cell in the given direction, or returns NONE
+    uint32_t jump(int x, int y, int d, int gx, int gy) const;
+    uint32_t jumpPlus(int x, int y, int d, int gx, int gy) const;
+
+    // Constructs the path, filling in the cells between the jump points
+    void constructPath(Context const & context, uint32_t to, Path * path) const;
+
+    GridGraph grid_;
+    Mode mode_;
+    std::vector<int16_t> distances_;    // Jump distances for JPS+ (8 per cell, positive: jump point, else: -wall)
+    Context context_;                   // Context used by findPath when one is not provided
+};
+
+#endif // !defined(PATHFINDER_JUMPPOINTSEARCH_H_INCLUDED)
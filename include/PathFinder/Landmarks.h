@@ -0,0 +1,335 @@
+#if !defined(PATHFINDER_LANDMARKS_H_INCLUDED)
+#define PATHFINDER_LANDMARKS_H_INCLUDED
+
+#pragma once
+
+#include "Heuristics.h"
+#include "OpenList.h"
+#include "PathFinder.h"
+#include "ReverseAdjacency.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+//! View of the distance tables of a set of landmarks, such as those of a Landmarks or a GraphFile.
+//!
+//! The view does not own the tables, so it is cheap to copy, and the tables must outlive it. See Landmarks for how the
+//! bounds are computed and how the tables are laid out.
+class LandmarkTable
+{
+public:
+
+    //! Constructs a view of an empty set of landmarks.
+    LandmarkTable() = default;
+
+    //! Constructor. There are count landmark nodes, and size * 2 * count distances.
+    LandmarkTable(uint32_t size, uint32_t count, uint32_t const * landmarks, float const * distances)
+        : size_(size)
+        , count_(count)
+        , landmarks_(landmarks)
+        , distances_(distances)
+    {
+        assert(count == 0 || (landmarks && distances));
+    }
+
+    //! Returns a lower bound on the cost from one node to another.
+    float lowerBound(uint32_t from, uint32_t to) const
+    {
+        uint32_t const stride = 2 * count_;
+        float const * a = &distances_[(size_t)from * stride];
+        float const * b = &distances_[(size_t)to * stride];
+        float bound = 0.0f;
+        for (uint32_t k = 0; k < stride; k += 2)
+        {
+            // A landmark that cannot reach or be reached by one of the nodes gives no bound, and neither does one that
+            // has not been added yet
+            float forward  = b[k] - a[k];           // d(L, to) - d(L, from)
+            float backward = a[k + 1] - b[k + 1];   // d(from, L) - d(to, L)
+            if (std::isfinite(forward))
+                bound = std::max(bound, forward);
+            if (std::isfinite(backward))
+                bound = std::max(bound, backward);
+        }
+        return bound;
+    }
+
+    //! Returns the number of landmarks.
+    uint32_t count() const { return count_; }
+
+    //! Returns the number of nodes.
+    uint32_t size() const { return size_; }
+
+    //! Returns a landmark's node.
+    uint32_t landmark(uint32_t k) const { return landmarks_[k]; }
+
+    //! Returns the cost from a landmark to a node, or INFINITY if the node cannot be reached.
+    float fromLandmark(uint32_t k, uint32_t node) const { return distances_[(size_t)node * 2 * count_ + 2 * k]; }
+
+    //! Returns the cost from a node to a landmark, or INFINITY if the landmark cannot be reached.
+    float toLandmark(uint32_t k, uint32_t node) const { return distances_[(size_t)node * 2 * count_ + 2 * k + 1]; }
+
+    //! Returns the landmarks' nodes.
+    uint32_t const * landmarks() const { return landmarks_; }
+
+    //! Returns the distance tables, laid out as described by Landmarks::distances().
+    float const * distances() const { return distances_; }
+
+private:
+
+    uint32_t size_  = 0;
+    uint32_t count_ = 0;
+    uint32_t const * landmarks_ = nullptr;
+    float const * distances_    = nullptr;
+};
+
+//! Distances to and from a set of landmark nodes, giving lower bounds on the cost between any two nodes (ALT).
+//!
+//! By the triangle inequality, the cost from v to t is at least d(v, L) - d(t, L) and at least d(L, t) - d(L, v) for
+//! any landmark L. The best of these bounds over all of the landmarks is an admissible and consistent heuristic that
+//! knows about the graph's actual costs, including walls, portals and expensive terrain, which a geometric estimate
+//! cannot. It is best when the landmarks lie behind the goal as seen from the start, so they are spread around the
+//! edges of the graph:
+//!
+//! - FARTHEST picks each landmark as far as possible from the landmarks already picked.
+//! - AVOID (Goldberg and Werneck) grows a shortest path tree from a random node, and descends into the subtree where
+//!   the current landmarks give the worst bounds, but that has no landmark in it yet. It takes longer, and which of
+//!   the two gives better bounds depends on the graph.
+//!
+//! The tables are built with two Dijkstra searches per landmark: one forward from it and one backward to it. They are
+//! stored in one array ordered by node, so the distances of all of the landmarks for a node are contiguous.
+class Landmarks
+{
+public:
+
+    //! How the landmarks are selected.
+    enum class Selection
+    {
+        FARTHEST,
+        AVOID
+    };
+
+    //! Constructs an empty set of landmarks.
+    Landmarks() = default;
+
+    //! Selects the landmarks of a graph and computes their distance tables. The graph and cost policy have the same
+    //! requirements as for BasicPathFinder, and the edge costs must not be negative.
+    template <typename Graph, typename CostPolicy = EdgeCost>
+    Landmarks(Graph const &      graph,
+              uint32_t           count,
+              Selection          selection,
+              CostPolicy const & costPolicy = CostPolicy(),
+              uint32_t           seed       = 1);
+
+    //! Returns a lower bound on the cost from one node to another.
+    float lowerBound(uint32_t from, uint32_t to) const { return table().lowerBound(from, to); }
+
+    //! Returns the number of landmarks.
+    uint32_t count() const { return (uint32_t)landmarks_.size(); }
+
+    //! Returns the number of nodes.
+    uint32_t size() const { return size_; }
+
+    //! Returns a landmark's node.
+    uint32_t landmark(uint32_t k) const { return landmarks_[k]; }
+
+    //! Returns the cost from a landmark to a node, or INFINITY if the node cannot be reached.
+    float fromLandmark(uint32_t k, uint32_t node) const { return distances_[(size_t)node * stride_ + 2 * k]; }
+
+    //! Returns the cost from a node to a landmark, or INFINITY if the landmark cannot be reached.
+    float toLandmark(uint32_t k, uint32_t node) const { return distances_[(size_t)node * stride_ + 2 * k + 1]; }
+
+    //! Returns the distance tables. Node i's entries start at i * 2 * count(), with the distance from and then the
+    //! distance to each landmark.
+    std::vector<float> const & distances() const { return distances_; }
+
+    //! Returns a view of the tables. It remains valid until the landmarks are changed or destroyed.
+    LandmarkTable table() const { return LandmarkTable(size_, stride_ / 2, landmarks_.data(), distances_.data()); }
+
+    //! Returns the number of bytes used by the tables.
+    size_t memoryUsage() const
+    {
+        return distances_.size() * sizeof(float) + landmarks_.size() * sizeof(uint32_t);
+    }
+
+private:
+
+    // The state of a Dijkstra search used to build the tables
+    struct Search
+    {
+        std::vector<float> costs;           // Cost from (or to) the source
+        std::vector<uint32_t> predecessors; // Previous node in the shortest path tree
+        std::vector<uint32_t> order;        // Nodes in the order they were settled
+        std::vector<uint32_t> handles;      // Location of each open node in the open list
+        std::vector<bool> settled;
+    };
+
+    // Connects the open list to the search
+    struct OpenListAccess
+    {
+        float priority(uint32_t i) const { return search->costs[i]; }
+        uint32_t handle(uint32_t i) const { return search->handles[i]; }
+        void setHandle(uint32_t i, uint32_t handle) const { search->handles[i] = handle; }
+
+        Search * search;
+    };
+
+    // Searches forward from a node, or backward to it if reverse is given
+    template <typename Graph, typename CostPolicy>
+    static void dijkstra(Graph const &            graph,
+                         ReverseAdjacency const * reverse,
+                         CostPolicy const &       costPolicy,
+                         uint32_t                 source,
+                         Search *                 search);
+
+    // Returns the node farthest from the landmarks selected so far
+    uint32_t selectFarthest() const;
+
+    // Returns the landmark chosen by the avoid method from a search from a root node
+    uint32_t selectAvoid(Search const & tree) const;
+
+    // Adds a landmark, with the costs from it and to it
+    void add(uint32_t landmark, std::vector<float> const & from, std::vector<float> const & to);
+
+    uint32_t size_   = 0;
+    uint32_t stride_ = 0;           // Number of entries per node: two per landmark
+    std::vector<uint32_t> landmarks_;
+    std::vector<float> distances_;  // Costs from and to each landmark, for each node
+};
+
+//! @param  graph       Graph
+//! @param  count       Number of landmarks. Each one takes 8 bytes per node.
+//! @param  selection   How the landmarks are selected
+//! @param  costPolicy  Computes the cost of traversing an edge
+//! @param  seed        Seed for the random choices made by the selection
+
+template <typename Graph, typename CostPolicy>
+Landmarks::Landmarks(Graph const & graph, uint32_t count, Selection selection, CostPolicy const & costPolicy, uint32_t seed)
+    : size_(graph.size())
+    , stride_(2 * count)
+    , distances_((size_t)graph.size() * 2 * count, INFINITY)
+{
+    assert(size_ > 0 && count > 0);
+
+    ReverseAdjacency reverse(graph);
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<uint32_t> random(0, size_ - 1);
+    Search from;
+    Search to;
+
+    // Searches from a random node, trying again a few times if the node is isolated (such as a wall on a grid)
+    auto searchFromRandomNode = [&] {
+        for (int attempt = 0; attempt < 32; ++attempt)
+        {
+            dijkstra(graph, nullptr, costPolicy, random(rng), &from);
+            if (from.order.size() > 1)
+                break;
+        }
+    };
+
+    landmarks_.reserve(count);
+    while (landmarks_.size() < count)
+    {
+        // The first landmark is the node farthest from a random node
+        uint32_t landmark;
+        if (landmarks_.empty())
+        {
+            searchFromRandomNode();
+            landmark = from.order.back();
+        }
+        else if (selection == Selection::AVOID)
+        {
+            searchFromRandomNode();
+            landmark = selectAvoid(from);
+        }
+        else
+        {
+            landmark = selectFarthest();
+        }
+
+        dijkstra(graph, nullptr, costPolicy, landmark, &from);
+        dijkstra(graph, &reverse, costPolicy, landmark, &to);
+        add(landmark, from.costs, to.costs);
+    }
+}
+
+template <typename Graph, typename CostPolicy>
+void Landmarks::dijkstra(Graph const &            graph,
+                         ReverseAdjacency const * reverse,
+                         CostPolicy const &       costPolicy,
+                         uint32_t                 source,
+                         Search *                 search)
+{
+    uint32_t const size = graph.size();
+    search->costs.assign(size, INFINITY);
+    search->predecessors.assign(size, SearchContext::NONE);
+    search->handles.resize(size);
+    search->settled.assign(size, false);
+    search->order.clear();
+
+    IndexedHeapOpenList<uint32_t, OpenListAccess> open(OpenListAccess{ search });
+    search->costs[source] = 0.0f;
+    open.push(source);
+
+    while (!open.empty())
+    {
+        uint32_t current = open.top();
+        open.pop();
+        search->settled[current] = true;
+        search->order.push_back(current);
+
+        float const g = search->costs[current];
+        auto relax = [&] (uint32_t neighbor, float cost) {
+            if (search->settled[neighbor])
+                return;
+            float c = g + cost;
+            if (c < search->costs[neighbor])
+            {
+                bool const wasOpen = std::isfinite(search->costs[neighbor]);
+                search->costs[neighbor]        = c;
+                search->predecessors[neighbor] = current;
+                if (wasOpen)
+                    open.decrease(neighbor);
+                else
+                    open.push(neighbor);
+            }
+        };
+
+        if (reverse)
+            reverse->forEachEdge(current, [&] (uint32_t from, float cost) { relax(from, costPolicy(graph, from, current, cost)); });
+        else
+            graph.forEachEdge(current, [&] (uint32_t to, float cost) { relax(to, costPolicy(graph, current, to, cost)); });
+    }
+}
+
+//! Heuristic that gives the landmarks' lower bound on the cost to the goal, for any graph the landmarks were built from.
+struct LandmarkHeuristic
+{
+    template <typename Graph>
+    float operator ()(Graph const &, uint32_t from, uint32_t goal) const { return landmarks->lowerBound(from, goal); }
+
+    Landmarks const * landmarks = nullptr;  //!< Landmarks of the graph being searched
+};
+
+//! Heuristic that gives the lower bound of a view of landmark tables, such as those loaded from a GraphFile.
+struct LandmarkTableHeuristic
+{
+    template <typename Graph>
+    float operator ()(Graph const &, uint32_t from, uint32_t goal) const { return table.lowerBound(from, goal); }
+
+    LandmarkTable table;    //!< Tables of the graph being searched
+};
+
+extern template class BasicPathFinder<NodeGraph, LandmarkHeuristic, EdgeCost>;
+
+//! Pathfinder for graphs of user-defined nodes that uses landmarks in place of the nodes' heuristic.
+//!
+//! Example:
+//!
+//!     Landmarks landmarks(NodeGraph(&domain), 16, Landmarks::Selection::AVOID);
+//!     LandmarkPathFinder pathFinder(NodeGraph(&domain), policy, LandmarkHeuristic{ &landmarks });
+using LandmarkPathFinder = BasicPathFinder<NodeGraph, LandmarkHeuristic, EdgeCost>;
+
+#endif // !defined(PATHFINDER_LANDMARKS_H_INCLUDED)
@@ -0,0 +1,60 @@
+#if !defined(PATHFINDER_MOVINGAI_H_INCLUDED)
+#define PATHFINDER_MOVINGAI_H_INCLUDED
+
+#pragma once
+
+#include "GridGraph.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//! Grid map in the format of the MovingAI pathfinding benchmarks (.map files).
+//!
+//! The cells '.', 'G' (ground) and 'S' (swamp) are passable. All others, such as '@' and 'O' (out of bounds), 'T'
+//! (trees) and 'W' (water), are not. The first row of the file is row 0. The benchmarks' optimal lengths assume that
+//! straight steps cost 1, diagonal steps cost sqrt(2) and diagonal steps may not cut corners, which is the model of a
+//! GridGraph with uniform costs and corner cutting disabled, as returned by graph().
+struct MovingAiMap
+{
+    //! Loads a map of type "octile". Returns false if the file cannot be read or is not a valid map.
+    bool load(char const * path);
+
+    //! Returns a grid of the map, which refers to passable, so it is valid only as long as the map is.
+    GridGraph graph() const
+    {
+        GridGraph grid(width, height, passable.data());
+        grid.setCutCorners(false);
+        return grid;
+    }
+
+    int width  = 0;                 //!< Number of cells in each row
+    int height = 0;                 //!< Number of rows
+    std::vector<uint8_t> passable;  //!< 1 for each passable cell, row by row
+};
+
+//! Scenario of the MovingAI pathfinding benchmarks (.scen files): a list of queries on a map with their optimal
+//! lengths, grouped in buckets of similar lengths.
+struct MovingAiScenario
+{
+    //! A query.
+    struct Experiment
+    {
+        int bucket;         //!< Bucket of the query
+        std::string map;    //!< Name of the map file, as given in the scenario
+        int mapWidth;       //!< Width of the map
+        int mapHeight;      //!< Height of the map
+        int startX;         //!< Column of the start
+        int startY;         //!< Row of the start
+        int goalX;          //!< Column of the goal
+        int goalY;          //!< Row of the goal
+        double optimal;     //!< Length of an optimal path
+    };
+
+    //! Loads a scenario of version 0 or 1. Returns false if the file cannot be read or is not a valid scenario.
+    bool load(char const * path);
+
+    std::vector<Experiment> experiments;    //!< Queries, in the order of the file
+};
+
+#endif // !defined(PATHFINDER_MOVINGAI_H_INCLUDED)
@@ -0,0 +1,896 @@
+#if !defined(PATHFINDER_OPENLIST_H_INCLUDED)
+#define PATHFINDER_OPENLIST_H_INCLUDED
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+//! @file
+//! Open list implementations used by the pathfinder.
+//!
+//! Every open list has the same interface and is parameterized by the type of element it stores (Key) and an
+//! accessor object (Access) that connects the elements to their search state. The accessor must provide:
+//!
+//!     float priority(Key key) const;                  // Lower values are removed first (see below)
+//!     uint32_t handle(Key key) const;                 // Returns the handle stored by setHandle()
+//!     void setHandle(Key key, uint32_t handle);       // Records the element's location in the open list
+//!
+//! The handle lets an open list find an element in O(1) when its priority decreases.
+//!
+//! IndexedHeapOpenList also accepts priorities of any type ordered by < and <=, such as a lexicographic pair.
+//!
+//! BucketOpenList also requires the range of priorities held by each of its buckets:
+//!
+//!     float resolution() const;
+
+//! Open list implemented as a std::vector managed by push_heap/pop_heap.
+//!
+//! This is the original implementation. A decrease in priority requires the entire heap to be rebuilt, so it is
+//! O(n). It is kept as a baseline.
+template <typename Key, typename Access>
+class BinaryHeapOpenList
+{
+public:
+
+    explicit BinaryHeapOpenList(Access access) : access_(access) {}
+
+    //! Returns true if the open list is empty.
+    bool empty() const { return heap_.empty(); }
+
+    //! Returns the number of elements in the open list.
+    size_t size() const { return heap_.size(); }
+
+    //! Reserves space for the given number of elements.
+    void reserve(size_t n) { heap_.reserve(n); }
+
+    //! Removes all elements.
+    void clear() { heap_.clear(); }
+
+    //! Adds an element.
+    void push(Key key)
+    {
+        heap_.push_back(key);
+        std::push_heap(heap_.begin(), heap_.end(), Compare{ access_ });
+    }
+
+    //! Returns the element with the lowest priority value.
+    Key top() const
+    {
+        assert(!heap_.empty());
+        return heap_.front();
+    }
+
+    //! Removes the element with the lowest priority value.
+    void pop()
+    {
+        assert(!heap_.empty());
+        std::pop_heap(heap_.begin(), heap_.end(), Compare{ access_ });
+        heap_.pop_back();
+    }
+
+    //! Restores the ordering after the priority value of an element has been lowered.
+    void decrease(Key)
+    {
+        // The location of the element is not known, so the entire heap must be rebuilt.
+        std::make_heap(heap_.begin(), heap_.end(), Compare{ access_ });
+    }
+
+    //! Removes and returns an element with a high priority value. The element is a leaf of the heap so it is
+    //! guaranteed to be in the highest 50%, but it is not necessarily the highest.
+    Key evict()
+    {
+        assert(!heap_.empty());
+        Key key = heap_.back();
+        heap_.pop_back();
+        return key;
+    }
+
+private:
+
+    struct Compare
+    {
+        Access const & access;
+        bool operator ()(Key x, Key y) const { return access.priority(x) > access.priority(y); }
+    };
+
+    Access access_;
+    std::vector<Key> heap_;
+};
+
+//! Open list implemented as a d-ary heap that tracks the location of each element.
+//!
+//! Because each element's location is stored through the accessor, a decrease in priority is a single sift-up,
+//! O(log n), instead of a rebuild of the entire heap. A 4-ary heap is shallower than a binary heap and its children
+//! share a cache line, which generally makes it faster for the push-heavy workload of A*.
+template <typename Key, typename Access, unsigned D = 4>
+class IndexedHeapOpenList
+{
+    static_assert(D >= 2, "The arity of the heap must be at least 2.");
+
+public:
+
+    explicit IndexedHeapOpenList(Access access) : access_(access) {}
+
+    //! Returns true if the open list is empty.
+    bool empty() const { return heap_.empty(); }
+
+    //! Returns the number of elements in the open list.
+    size_t size() const { return heap_.size(); }
+
+    //! Reserves space for the given number of elements.
+    void reserve(size_t n) { heap_.reserve(n); }
+
+    //! Removes all elements.
+    void clear() { heap_.clear(); }
+
+    //! Adds an element.
+    void push(Key key)
+    {
+        heap_.push_back(key);
+        siftUp((uint32_t)heap_.size() - 1);
+    }
+
+    //! Returns the element with the lowest priority value.
+    Key top() const
+    {
+        assert(!heap_.empty());
+        return heap_.front();
+    }
+
+    //! Removes the element with the lowest priority value.
+    void pop()
+    {
+        assert(!heap_.empty());
+        Key last = heap_.back();
+        heap_.pop_back();
+        if (!heap_.empty())
+        {
+            heap_[0] = last;
+            siftDown(0);
+        }
+    }
+
+    //! Restores the ordering after the priority value of an element has been lowered.
+    void decrease(Key key)
+    {
+        uint32_t i = access_.handle(key);
+        assert(i < heap_.size() && heap_[i] == key);
+        siftUp(i);
+    }
+
+    //! Restores the ordering after the priority value of an element has changed in either direction.
+    void update(Key key)
+    {
+        uint32_t i = access_.handle(key);
+        assert(i < heap_.size() && heap_[i] == key);
+        siftUp(i);
+        siftDown(access_.handle(key));
+    }
+
+    //! Removes an element.
+    void remove(Key key)
+    {
+        uint32_t i = access_.handle(key);
+        assert(i < heap_.size() && heap_[i] == key);
+        Key last = heap_.back();
+        heap_.pop_back();
+        if (i < heap_.size())
+        {
+            heap_[i] = last;
+            siftUp(i);
+            siftDown(access_.handle(last));
+        }
+    }
+
+    //! Removes and returns an element with a high priority value. The element is a leaf of the heap so it is
+    //! guaranteed to be in the highest 50%, but it is not necessarily the highest.
+    Key evict()
+    {
+        assert(!heap_.empty());
+        Key key = heap_.back();
+        heap_.pop_back();
+        return key;
+    }
+
+private:
+
+    void siftUp(uint32_t i)
+    {
+        Key key = heap_[i];
+        auto const priority = access_.priority(key);
+        while (i > 0)
+        {
+            uint32_t parent = (i - 1) / D;
+            if (access_.priority(heap_[parent]) <= priority)
+                break;
+            place(i, heap_[parent]);
+            i = parent;
+        }
+        place(i, key);
+    }
+
+    void siftDown(uint32_t i)
+    {
+        Key key = heap_[i];
+        auto const priority = access_.priority(key);
+        uint32_t size = (uint32_t)heap_.size();
+        for (;;)
+        {
+            uint32_t first = i * D + 1;
+            if (first >= size)
+                break;
+
+            // Find the child with the lowest priority value
+            uint32_t last = std::min(first + D, size);
+            uint32_t best = first;
+            auto bestPriority = access_.priority(heap_[first]);
+            for (uint32_t c = first + 1; c < last; ++c)
+            {
+                auto const p = access_.priority(heap_[c]);
+                if (p < bestPriority)
+                {
+                    best = c;
+                    bestPriority = p;
+                }
+            }
+
+            if (priority <= bestPriority)
+                break;
+            place(i, heap_[best]);
+            i = best;
+        }
+        place(i, key);
+    }
+
+    void place(uint32_t i, Key key)
+    {
+        heap_[i] = key;
+        access_.setHandle(key, i);
+    }
+
+    Access access_;
+    std::vector<Key> heap_;
+};
+
+//! Open list implemented as a pairing heap.
+//!
+//! Insertion is O(1) and a decrease in priority is O(1) (amortized o(log n)). Removing the lowest element is
+//! O(log n) amortized. The heap's entries are kept in a pool that is reused across searches, so the open list does not
+//! allocate once it has grown to the size required by a search.
+template <typename Key, typename Access>
+class PairingHeapOpenList
+{
+public:
+
+    explicit PairingHeapOpenList(Access access) : access_(access) {}
+
+    //! Returns true if the open list is empty.
+    bool empty() const { return root_ == NIL; }
+
+    //! Returns the number of elements in the open list.
+    size_t size() const { return size_; }
+
+    //! Reserves space for the given number of elements.
+    void reserve(size_t n) { entries_.reserve(n); }
+
+    //! Removes all elements.
+    void clear()
+    {
+        entries_.clear();
+        free_  = NIL;
+        root_  = NIL;
+        size_  = 0;
+    }
+
+    //! Adds an element.
+    void push(Key key)
+    {
+        uint32_t e = allocate(key);
+        root_ = (root_ == NIL) ? e : meld(root_, e);
+        ++size_;
+    }
+
+    //! Returns the element with the lowest priority value.
+    Key top() const
+    {
+        assert(root_ != NIL);
+        return entries_[root_].key;
+    }
+
+    //! Removes the element with the lowest priority value.
+    void pop()
+    {
+        assert(root_ != NIL);
+        uint32_t old = root_;
+        root_ = mergePairs(entries_[old].child);
+        if (root_ != NIL)
+            entries_[root_].prev = NIL;
+        release(old);
+        --size_;
+    }
+
+    //! Restores the ordering after the priority value of an element has been lowered.
+    void decrease(Key key)
+    {
+        uint32_t e = access_.handle(key);
+        assert(e < entries_.size() && entries_[e].key == key);
+        if (e == root_)
+            return;
+        cut(e);
+        root_ = meld(root_, e);
+    }
+
+    //! Removes and returns an element with a high priority value. The element is a leaf of the heap, so no element
+    //! below it has a higher priority value, but it is not necessarily the highest.
+    Key evict()
+    {
+        assert(root_ != NIL);
+
+        // Follow the first children down to a leaf
+        uint32_t e = root_;
+        while (entries_[e].child != NIL)
+        {
+            e = entries_[e].child;
+        }
+
+        if (e == root_)
+            root_ = NIL;
+        else
+            cut(e);
+
+        Key key = entries_[e].key;
+        release(e);
+        --size_;
+        return key;
+    }
+
+private:
+
+    static uint32_t constexpr NIL = ~0u;
+
+    struct Entry
+    {
+        Key key;
+        uint32_t child;     // First child
+        uint32_t sibling;   // Next sibling
+        uint32_t prev;      // Previous sibling, or the parent if this is the first child
+    };
+
+    uint32_t allocate(Key key)
+    {
+        uint32_t e;
+        if (free_ != NIL)
+        {
+            e     = free_;
+            free_ = entries_[e].sibling;
+            entries_[e] = Entry{ key, NIL, NIL, NIL };
+        }
+        else
+        {
+            e = (uint32_t)entries_.size();
+            entries_.push_back(Entry{ key, NIL, NIL, NIL });
+        }
+        access_.setHandle(key, e);
+        return e;
+    }
+
+    void release(uint32_t e)
+    {
+        entries_[e].sibling = free_;
+        free_ = e;
+    }
+
+    // Melds two heaps and returns the root of the result. Both a and b must be roots.
+    uint32_t meld(uint32_t a, uint32_t b)
+    {
+        if (access_.priority(entries_[b].key) < access_.priority(entries_[a].key))
+            std::swap(a, b);
+
+        // b becomes the first child of a
+        Entry & ea = entries_[a];
+        Entry & eb = entries_[b];
+        eb.prev    = a;
+        eb.sibling = ea.child;
+        if (ea.child != NIL)
+            entries_[ea.child].prev = b;
+        ea.child   = b;
+        ea.sibling = NIL;
+        ea.prev    = NIL;
+        return a;
+    }
+
+    // Detaches the subtree rooted at e from its parent and siblings
+    void cut(uint32_t e)
+    {
+        Entry & entry = entries_[e];
+        assert(entry.prev != NIL);
+        Entry & prev = entries_[entry.prev];
+        if (prev.child == e)
+            prev.child = entry.sibling;
+        else
+            prev.sibling = entry.sibling;
+        if (entry.sibling != NIL)
+            entries_[entry.sibling].prev = entry.prev;
+        entry.sibling = NIL;
+        entry.prev    = NIL;
+    }
+
+    // Combines a list of siblings into a single heap using the two-pass method and returns its root
+    uint32_t mergePairs(uint32_t first)
+    {
+        if (first == NIL)
+            return NIL;
+
+        // First pass: meld pairs from left to right, linking the results into a list in reverse order
+        uint32_t merged = NIL;
+        while (first != NIL)
+        {
+            uint32_t a = first;
+            uint32_t b = entries_[a].sibling;
+            if (b == NIL)
+            {
+                entries_[a].prev = NIL;
+                entries_[a].sibling = merged;
+                merged = a;
+                break;
+            }
+            first = entries_[b].sibling;
+            entries_[a].sibling = NIL;
+            entries_[a].prev    = NIL;
+            entries_[b].sibling = NIL;
+            entries_[b].prev    = NIL;
+            uint32_t m = meld(a, b);
+            entries_[m].sibling = merged;
+            merged = m;
+        }
+
+        // Second pass: meld the results from right to left
+        uint32_t root = merged;
+        merged = entries_[root].sibling;
+        entries_[root].sibling = NIL;
+        while (merged != NIL)
+        {
+            uint32_t next = entries_[merged].sibling;
+            entries_[merged].sibling = NIL;
+            root = meld(root, merged);
+            merged = next;
+        }
+        return root;
+    }
+
+    Access access_;
+    std::vector<Entry> entries_;
+    uint32_t free_ = NIL;
+    uint32_t root_ = NIL;
+    size_t size_   = 0;
+};
+
+//! Open list implemented as a min-max heap that tracks the location of each element.
+//!
+//! The levels of the tree alternate between min levels, where each element is the lowest of its subtree, and max
+//! levels, where each element is the highest. So both the lowest element (the root) and the highest element (one of
+//! the root's children) are found in O(1), and removing either one is O(log n). Unlike the other open lists, evict()
+//! removes the element with the highest priority value, which is what a bounded-memory search needs.
+//!
+//! Elements with equal priority values are ordered by key, so the elements removed do not depend on the order in which
+//! they were added.
+template <typename Key, typename Access>
+class MinMaxHeapOpenList
+{
+public:
+
+    explicit MinMaxHeapOpenList(Access access) : access_(access) {}
+
+    //! Returns true if the open list is empty.
+    bool empty() const { return heap_.empty(); }
+
+    //! Returns the number of elements in the open list.
+    size_t size() const { return heap_.size(); }
+
+    //! Reserves space for the given number of elements.
+    void reserve(size_t n) { heap_.reserve(n); }
+
+    //! Removes all elements.
+    void clear() { heap_.clear(); }
+
+    //! Adds an element.
+    void push(Key key)
+    {
+        heap_.push_back(key);
+        uint32_t i = (uint32_t)heap_.size() - 1;
+        access_.setHandle(key, i);
+        restore(i);
+    }
+
+    //! Returns the element with the lowest priority value.
+    Key top() const
+    {
+        assert(!heap_.empty());
+        return heap_.front();
+    }
+
+    //! Removes the element with the lowest priority value.
+    void pop()
+    {
+        assert(!heap_.empty());
+        removeAt(0);
+    }
+
+    //! Restores the ordering after the priority value of an element has been lowered.
+    void decrease(Key key)
+    {
+        uint32_t i = access_.handle(key);
+        assert(i < heap_.size() && heap_[i] == key);
+        restore(i);
+    }
+
+    //! Removes and returns the element with the highest priority value.
+    Key evict()
+    {
+        assert(!heap_.empty());
+        uint32_t i = highest();
+        Key key = heap_[i];
+        removeAt(i);
+        return key;
+    }
+
+private:
+
+    // Returns true if element a is ordered before element b
+    bool less(Key a, Key b) const
+    {
+        auto const pa = access_.priority(a);
+        auto const pb = access_.priority(b);
+        return pa < pb || (!(pb < pa) && a < b);
+    }
+
+    // Returns true if the element at i is ordered before (on a min level) or after (on a max level) the one at j
+    bool better(uint32_t i, uint32_t j, bool min) const
+    {
+        return min ? less(heap_[i], heap_[j]) : less(heap_[j], heap_[i]);
+    }
+
+    // Returns true if location i is on a min level
+    static bool isMinLevel(uint32_t i)
+    {
+        unsigned level = 0;
+        for (uint32_t n = i + 1; n > 1; n >>= 1)
+        {
+            ++level;
+        }
+        return (level & 1) == 0;
+    }
+
+    // Returns the location of the element with the highest priority value
+    uint32_t highest() const
+    {
+        uint32_t size = (uint32_t)heap_.size();
+        if (size <= 2)
+            return size - 1;
+        return less(heap_[1], heap_[2]) ? 2 : 1;
+    }
+
+    void removeAt(uint32_t i)
+    {
+        Key last = heap_.back();
+        heap_.pop_back();
+        if (i < heap_.size())
+        {
+            place(i, last);
+            restore(i);
+        }
+    }
+
+    // Moves the element at i up or down to where it belongs
+    void restore(uint32_t i)
+    {
+        bool const min = isMinLevel(i);
+        if (i > 0)
+        {
+            // If the element belongs on the other kind of level, then it swaps with its parent and continues up from
+            // there, and the parent's element, which belongs below, continues down
+            uint32_t parent = (i - 1) / 2;
+            if (better(parent, i, min))
+            {
+                swap(i, parent);
+                trickleDown(i, min);
+                bubbleUp(parent, !min);
+                return;
+            }
+            if (bubbleUp(i, min))
+                return;
+        }
+        trickleDown(i, min);
+    }
+
+    // Moves the element at i up through the levels of the same kind. Returns true if it moved.
+    bool bubbleUp(uint32_t i, bool min)
+    {
+        bool moved = false;
+        while (i >= 3)
+        {
+            uint32_t grandparent = ((i - 1) / 2 - 1) / 2;
+            if (!better(i, grandparent, min))
+                break;
+            swap(i, grandparent);
+            i = grandparent;
+            moved = true;
+        }
+        return moved;
+    }
+
+    // Moves the element at i down through the levels of the same kind
+    void trickleDown(uint32_t i, bool min)
+    {
+        uint32_t const size = (uint32_t)heap_.size();
+        for (;;)
+        {
+            // Find the best of the children and grandchildren
+            uint32_t first = 2 * i + 1;
+            if (first >= size)
+                break;
+            uint32_t best = first;
+            uint32_t candidates[] = { first + 1, 2 * first + 1, 2 * first + 2, 2 * first + 3, 2 * first + 4 };
+            for (uint32_t c : candidates)
+            {
+                if (c < size && better(c, best, min))
+                    best = c;
+            }
+
+            if (!better(best, i, min))
+                break;
+            swap(i, best);
+            if (best <= first + 1)
+                break;
+
+            // A grandchild: the element moved down two levels, and it may belong above its new parent
+            uint32_t parent = (best - 1) / 2;
+            if (better(parent, best, min))
+                swap(best, parent);
+            i = best;
+        }
+    }
+
+    void swap(uint32_t i, uint32_t j)
+    {
+        Key key = heap_[i];
+        place(i, heap_[j]);
+        place(j, key);
+    }
+
+    void place(uint32_t i, Key key)
+    {
+        heap_[i] = key;
+        access_.setHandle(key, i);
+    }
+
+    Access access_;
+    std::vector<Key> heap_;
+};
+
+//! Open list implemented as a monotone bucket queue (Dial's algorithm).
+//!
+//! The priorities are divided into buckets of equal width (the accessor's resolution), stored in a ring, and each bucket
+//! is a doubly-linked list of the elements it holds. Push, decrease and pop are O(1), plus a scan of the empty buckets
+//! between the lowest priority and the next one, which is O(1) amortized over the search because the queue is
+//! monotone: no element is pushed with a lower priority than the last one removed. An element whose priority is lower
+//! anyway (such as with an inconsistent heuristic) is put in the lowest bucket.
+//!
+//! The elements in a bucket are removed in no particular order, so the queue only orders elements exactly when their
+//! priorities are multiples of the width (relative to the first element's priority). BasicPathFinder ensures this by
+//! quantizing its costs when it uses this open list. Each priority goes in the bucket of the nearest multiple, which
+//! absorbs floating point error. The ring grows to cover the range of priorities in the queue, which is bounded by the
+//! largest edge cost and change in the heuristic, divided by the width.
+template <typename Key, typename Access>
+class BucketOpenList
+{
+public:
+
+    explicit BucketOpenList(Access access) : access_(access), width_(access.resolution()) { assert(width_ > 0.0f); }
+
+    //! Returns true if the open list is empty.
+    bool empty() const { return size_ == 0; }
+
+    //! Returns the number of elements in the open list.
+    size_t size() const { return size_; }
+
+    //! Reserves space for the given number of elements.
+    void reserve(size_t n) { entries_.reserve(n); }
+
+    //! Removes all elements. The ring of buckets keeps its size.
+    void clear()
+    {
+        entries_.clear();
+        std::fill(buckets_.begin(), buckets_.end(), NIL);
+        free_    = NIL;
+        size_    = 0;
+        current_ = 0;
+        highest_ = 0;
+        started_ = false;
+    }
+
+    //! Adds an element.
+    void push(Key key)
+    {
+        // The buckets are numbered from the priority of the first element
+        if (!started_)
+        {
+            base_    = access_.priority(key);
+            started_ = true;
+        }
+
+        uint32_t e = allocate(key);
+        link(e, bucketOf(key));
+        ++size_;
+    }
+
+    //! Returns the element with the lowest priority value.
+    Key top() const
+    {
+        assert(size_ > 0);
+        advance();
+        return entries_[buckets_[current_ & mask_]].key;
+    }
+
+    //! Removes the element with the lowest priority value.
+    void pop()
+    {
+        assert(size_ > 0);
+        advance();
+        uint32_t e = buckets_[current_ & mask_];
+        unlink(e);
+        release(e);
+        --size_;
+    }
+
+    //! Restores the ordering after the priority value of an element has been lowered.
+    void decrease(Key key)
+    {
+        uint32_t e = access_.handle(key);
+        assert(e < entries_.size() && entries_[e].key == key);
+        uint64_t bucket = bucketOf(key);
+        if (bucket != entries_[e].bucket)
+        {
+            unlink(e);
+            link(e, bucket);
+        }
+    }
+
+    //! Removes and returns an element from the bucket with the highest priority values.
+    Key evict()
+    {
+        assert(size_ > 0);
+        while (buckets_[highest_ & mask_] == NIL)
+        {
+            --highest_;
+        }
+
+        uint32_t e = buckets_[highest_ & mask_];
+        Key key = entries_[e].key;
+        unlink(e);
+        release(e);
+        --size_;
+        return key;
+    }
+
+private:
+
+    static uint32_t constexpr NIL = ~0u;
+
+    struct Entry
+    {
+        Key key;
+        uint32_t next;      // Next element in the bucket
+        uint32_t prev;      // Previous element in the bucket
+        uint64_t bucket;    // Bucket holding the element
+    };
+
+    // Returns the bucket for an element's priority
+    uint64_t bucketOf(Key key) const
+    {
+        double offset = double(access_.priority(key) - base_) / width_;
+        assert(!std::isnan(offset) && offset < 1e18);
+        if (!(offset > double(current_)))
+            return current_;
+        return (uint64_t)(offset + 0.5);
+    }
+
+    uint32_t allocate(Key key)
+    {
+        uint32_t e;
+        if (free_ != NIL)
+        {
+            e     = free_;
+            free_ = entries_[e].next;
+            entries_[e].key = key;
+        }
+        else
+        {
+            e = (uint32_t)entries_.size();
+            entries_.push_back(Entry{ key, NIL, NIL, 0 });
+        }
+        access_.setHandle(key, e);
+        return e;
+    }
+
+    void release(uint32_t e)
+    {
+        entries_[e].next = free_;
+        free_ = e;
+    }
+
+    // Adds an element to the front of a bucket
+    void link(uint32_t e, uint64_t bucket)
+    {
+        if (bucket - current_ >= buckets_.size())
+            grow(bucket);
+
+        uint32_t & head = buckets_[bucket & mask_];
+        Entry & entry = entries_[e];
+        entry.bucket = bucket;
+        entry.prev   = NIL;
+        entry.next   = head;
+        if (head != NIL)
+            entries_[head].prev = e;
+        head = e;
+        highest_ = std::max(highest_, bucket);
+    }
+
+    // Removes an element from its bucket
+    void unlink(uint32_t e)
+    {
+        Entry const & entry = entries_[e];
+        if (entry.prev != NIL)
+            entries_[entry.prev].next = entry.next;
+        else
+            buckets_[entry.bucket & mask_] = entry.next;
+        if (entry.next != NIL)
+            entries_[entry.next].prev = entry.prev;
+    }
+
+    // Moves the lowest bucket up to the next one that is not empty. This is done when the lowest element is needed
+    // rather than after one is removed, because elements may still be added to the bucket of the last one removed.
+    void advance() const
+    {
+        while (buckets_[current_ & mask_] == NIL)
+        {
+            ++current_;
+        }
+    }
+
+    // Enlarges the ring so that it covers the buckets from the lowest one to the given one
+    void grow(uint64_t bucket)
+    {
+        size_t size = std::max<size_t>(64, buckets_.size());
+        while (size <= bucket - current_)
+        {
+            size *= 2;
+        }
+
+        std::vector<uint32_t> buckets(size, NIL);
+        for (uint64_t b = current_; b < current_ + buckets_.size(); ++b)
+        {
+            buckets[b & (size - 1)] = buckets_[b & mask_];
+        }
+        buckets_.swap(buckets);
+        mask_ = size - 1;
+    }
+
+    Access access_;
+    float width_;                       // Range of priorities in each bucket
+    float base_ = 0.0f;                 // Priority of the first bucket
+    std::vector<Entry> entries_;
+    std::vector<uint32_t> buckets_;     // First element in each bucket, in a ring of a power of two buckets
+    uint64_t mask_    = 0;              // Maps a bucket to its place in the ring
+    mutable uint64_t current_ = 0;      // No bucket lower than this one is not empty
+    uint64_t highest_ = 0;              // No bucket higher than this one is not empty
+    uint32_t free_    = NIL;
+    size_t size_      = 0;
+    bool started_     = false;
+};
+
+#endif // !defined(PATHFINDER_OPENLIST_H_INCLUDED)
@@ -0,0 +1,150 @@
+#if !defined(PATHFINDER_PATHCACHE_H_INCLUDED)
+#define PATHFINDER_PATHCACHE_H_INCLUDED
+
+#pragma once
+
+#include "Span.h"
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+//! Thread-safe, size-bounded LRU cache of paths, keyed by start, goal and graph version.
+//!
+//! Paths are stored as node indexes. Because every part of a shortest path is itself a shortest path, a cached path
+//! from s to g also answers a query from any node on it to g. Every node of a cached path is indexed, so such a
+//! suffix is found in O(1).
+//!
+//! Each path is stored with the version of the graph it was found in. A lookup with a different version is a miss, and
+//! removes the stale path. So, when the graph changes, the caller only has to increment its version. Alternatively,
+//! clear() removes everything at once.
+//!
+//! The cache is divided into shards by goal, each with its own lock and LRU list, so concurrent lookups of different
+//! goals rarely contend. When a shard exceeds its share of the memory budget, its least recently used paths are
+//! evicted. The memory counted for a path includes an estimate of the overhead of the containers.
+class PathCache
+{
+public:
+
+    //! Counts of the cache's activity since it was constructed.
+    struct Stats
+    {
+        uint64_t hits;          //!< Lookups answered by a path starting at the start
+        uint64_t suffixHits;    //!< Lookups answered by the suffix of a longer path
+        uint64_t misses;        //!< Lookups not answered
+        uint64_t stale;         //!< Paths removed because their version was out of date
+        uint64_t insertions;    //!< Paths added
+        uint64_t evictions;     //!< Paths evicted to stay within the memory budget
+        uint64_t paths;         //!< Number of paths in the cache
+        uint64_t bytes;         //!< Memory counted for the paths in the cache
+    };
+
+    //! Constructor. The memory budget is in bytes, and it is divided evenly between the shards.
+    explicit PathCache(size_t maxBytes, unsigned shards = 16);
+
+    ~PathCache();
+
+    PathCache(PathCache const &) = delete;
+    PathCache & operator =(PathCache const &) = delete;
+
+    //! Looks up the path from start to goal for a graph version. Returns true and the path if it is cached.
+    bool find(uint32_t start, uint32_t goal, uint64_t version, std::vector<uint32_t> * path);
+
+    //! Adds a path for a graph version. The path's first and last nodes are the start and the goal.
+    void insert(Span<uint32_t const> path, uint64_t version);
+
+    //! Removes all paths.
+    void clear();
+
+    //! Returns the counters.
+    Stats stats() const;
+
+    //! Finds a path with a pathfinder (such as PathFinder or GridPathFinder), using the cache. On a miss, the path is
+    //! found by the pathfinder and added to the cache. Returns true if a path was found.
+    template <typename Finder>
+    bool findPath(Finder const &               finder,
+                  typename Finder::Context &   context,
+                  typename Finder::Vertex      start,
+                  typename Finder::Vertex      goal,
+                  uint64_t                     version,
+                  typename Finder::Path *      path);
+
+private:
+
+    struct Entry;
+    struct Location;
+    struct Shard;
+
+    // Returns the memory counted for a path
+    static size_t estimateBytes(size_t length);
+
+    // Returns the shard that holds the paths to a goal
+    Shard & shardOf(uint32_t goal) const;
+
+    // Removes an entry from its shard
+    void erase(Shard & shard, std::list<Entry>::iterator entry);
+
+    std::unique_ptr<Shard[]> shards_;
+    unsigned shardCount_;
+    size_t maxShardBytes_;
+
+    std::atomic<uint64_t> hits_{ 0 };
+    std::atomic<uint64_t> suffixHits_{ 0 };
+    std::atomic<uint64_t> misses_{ 0 };
+    std::atomic<uint64_t> stale_{ 0 };
+    std::atomic<uint64_t> insertions_{ 0 };
+    std::atomic<uint64_t> evictions_{ 0 };
+};
+
+//! @param  finder      Pathfinder used on a miss
+//! @param  context     Search state used on a miss
+//! @param  start       Start node
+//! @param  goal        Goal node
+//! @param  version     Version of the pathfinder's graph
+//! @param  path        Path from start to goal
+//!
+//! @returns    true, if a path was found
+//!
+//! @note   Failed searches are not cached.
+
+template <typename Finder>
+bool PathCache::findPath(Finder const &               finder,
+                         typename Finder::Context &   context,
+                         typename Finder::Vertex      start,
+                         typename Finder::Vertex      goal,
+                         uint64_t                     version,
+                         typename Finder::Path *      path)
+{
+    auto const & graph = finder.graph();
+
+    // The indexes are kept in a thread-local buffer so that a warm lookup does not allocate
+    static thread_local std::vector<uint32_t> indexes;
+
+    if (find(graph.index(start), graph.index(goal), version, &indexes))
+    {
+        path->clear();
+        path->reserve(indexes.size());
+        for (uint32_t i : indexes)
+        {
+            path->push_back(graph.vertex(i));
+        }
+        return true;
+    }
+
+    if (!finder.findPath(context, start, goal, path))
+        return false;
+
+    indexes.clear();
+    for (auto const & node : *path)
+    {
+        indexes.push_back(graph.index(node));
+    }
+    insert(indexes, version);
+    return true;
+}
+
+#endif // !defined(PATHFINDER_PATHCACHE_H_INCLUDED)
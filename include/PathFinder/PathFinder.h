@@ -3,10 +3,18 @@
 
 #pragma once
 
+#include "BasicPathFinder.h"
+
+#include <cstdint>
 #include <vector>
 
-//! General A* Pathfinder.
-class PathFinder
+class CompactGraph;
+
+//! Graph of user-defined nodes linked by edges.
+//!
+//! The graph is a view of a list of nodes owned by the user. Each node provides its own heuristic by overriding
+//! Node::h().
+class NodeGraph
 {
 public:
 
@@ -15,37 +23,34 @@ public:
 
     using NodeList = std::vector<Node *>;   //!< A list of nodes.
     using EdgeList = std::vector<Edge *>;   //!< A list of edges.
-    using Path     = NodeList;              //!< A path.
+    using Vertex   = Node *;                //!< A node as identified by users of the graph.
 
-    //! Pathfinding parameters.
-    struct Policy
-    {
-        int maxNodes;   //!< Maximum number of nodes to be used in the search (or <= 0 for unlimited)
-    };
+    //! Constructor. The nodes are assigned their indexes in the list, so a node cannot belong to more than one list.
+    NodeGraph(NodeList * nodes);
 
-    PathFinder(NodeList * domain, Policy const & policy);
+    //! Returns the list of nodes.
+    NodeList * nodes() const { return nodes_; }
 
-    //! Finds the shortest path. Returns true if a path was found.
-    bool findPath(Node * start, Node * end, Path * path);
+    //! Returns the number of nodes.
+    uint32_t size() const { return nodes_ ? (uint32_t)nodes_->size() : 0; }
 
-private:
+    //! Returns the index of a node, or SearchContext::NONE if it is not in the list.
+    uint32_t index(Node const * node) const;
 
-    // Reset the status of all nodes in the domain
-    void resetNodes();
+    //! Returns the node with the given index.
+    Node * vertex(uint32_t i) const { return (*nodes_)[i]; }
 
-    // Constructs the path
-    void constructPath(Node * from, Node * to, Path * path);
+    //! Calls visit(to, cost) for each edge leaving a node for a node in the list.
+    template <typename Visitor>
+    void forEachEdge(uint32_t i, Visitor && visit) const;
 
-#if defined(_DEBUG)
-    void validateNode(Node * node);
-#endif
+private:
 
-    NodeList * domain_;
-    Policy policy_;
+    NodeList * nodes_;
 };
 
 //! Pathfinder node.
-class PathFinder::Node
+class NodeGraph::Node
 {
 public:
 
@@ -55,47 +60,20 @@ public:
     //! @note    This value is assumed to be constant.
     virtual float h(Node const & goal) const = 0;
 
-    //! Updates pathfinding values for the node.
-    void update(float cost, Node * pred);
-
-    //! Anticipates being added to the open queue.
-    void open(float cost, Node * pPredecessor, Node const & goal);
-
-    //! Returns true if the node is open.
-    bool isOpen() const { return status_ == Status::OPEN; }
-
-    //! Anticipates being closed.
-    void close();
-
-    //! Returns true if the node is closed.
-    bool isClosed() const { return status_ == Status::CLOSED; }
-
-    //! Resets the node's status to not visited.
-    void reset();
+    //! Returns the node's index in the graph.
+    uint32_t index() const { return index_; }
 
     EdgeList adjacencies;   //!< List of edges leaving the node
 
-    // For use by the pathfinder
-
-    float f;                        //!< Estimated cost of total path through this node
-    float g;                        //!< Cost of path to this node
-    Node * predecessor = nullptr;   //!< Previous node in the path (assuming the path goes through this node)
-
 private:
 
-    enum class Status
-    {
-        NOT_VISITED,
-        OPEN,
-        CLOSED
-    };
+    friend class NodeGraph;
 
-    float cachedH_;                         // Cached value of h()
-    Status status_ = Status::NOT_VISITED;   // Node status
+    uint32_t index_ = SearchContext::NONE;  // Index in the graph, assigned by the graph
 };
 
 //! Pathfinder edge.
-class PathFinder::Edge
+class NodeGraph::Edge
 {
 public:
 
@@ -103,4 +81,55 @@ public:
     Node * to = nullptr;    //!< Link to the edge's destination node.
 };
 
+inline uint32_t NodeGraph::index(Node const * node) const
+{
+    uint32_t const i = node ? node->index_ : SearchContext::NONE;
+    return (i < size() && (*nodes_)[i] == node) ? i : SearchContext::NONE;
+}
+
+template <typename Visitor>
+void NodeGraph::forEachEdge(uint32_t i, Visitor && visit) const
+{
+    // Edges to nodes that are not in the list are ignored
+    for (auto const & edge : (*nodes_)[i]->adjacencies)
+    {
+        uint32_t const to = index(edge->to);
+        if (to != SearchContext::NONE)
+            visit(to, edge->cost);
+    }
+}
+
+//! Heuristic provided by the nodes of a NodeGraph (Node::h).
+struct NodeHeuristic
+{
+    float operator ()(NodeGraph const & graph, uint32_t from, uint32_t goal) const
+    {
+        return graph.vertex(from)->h(*graph.vertex(goal));
+    }
+};
+
+extern template class BasicPathFinder<NodeGraph, NodeHeuristic, EdgeCost>;
+
+//! General A* Pathfinder.
+//!
+//! This is the instantiation of BasicPathFinder for graphs of user-defined nodes (NodeGraph), with the heuristic
+//! provided by the nodes.
+class PathFinder : public BasicPathFinder<NodeGraph, NodeHeuristic, EdgeCost>
+{
+public:
+
+    using Node      = NodeGraph::Node;          //!< A node.
+    using Edge      = NodeGraph::Edge;          //!< An edge.
+    using NodeList  = NodeGraph::NodeList;      //!< A list of nodes.
+    using EdgeList  = NodeGraph::EdgeList;      //!< A list of edges.
+    using IndexPath = std::vector<uint32_t>;    //!< A path of node indexes.
+
+    PathFinder(NodeList * domain, Policy const & policy);
+
+    using BasicPathFinder::findPath;
+
+    //! Finds the shortest path in a compact graph using the given context. Returns true if a path was found.
+    bool findPath(CompactGraph const & graph, Context & context, uint32_t start, uint32_t end, IndexPath * path) const;
+};
+
 #endif // !defined(PATHFINDER_H_INCLUDED)
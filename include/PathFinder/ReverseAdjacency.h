@@ -0,0 +1,94 @@
+#if !defined(PATHFINDER_REVERSEADJACENCY_H_INCLUDED)
+#define PATHFINDER_REVERSEADJACENCY_H_INCLUDED
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+//! The edges entering each node of a graph.
+//!
+//! Graphs only provide the edges leaving a node, but a search from the goal back toward the start must follow edges
+//! backward. The reverse adjacency is built once from any graph that can be searched by BasicPathFinder and is stored
+//! in compressed sparse row form, so an edge takes 8 bytes.
+//!
+//! The costs are the edge costs reported by the graph, before the cost policy is applied. The reverse adjacency is a
+//! snapshot, so it must be rebuilt if edges are added to or removed from the graph, or if their costs change.
+class ReverseAdjacency
+{
+public:
+
+    //! Constructs an empty reverse adjacency.
+    ReverseAdjacency() = default;
+
+    //! Constructs the reverse adjacency of a graph.
+    template <typename Graph>
+    explicit ReverseAdjacency(Graph const & graph);
+
+    //! Returns the number of nodes.
+    uint32_t size() const { return offsets_.empty() ? 0 : (uint32_t)offsets_.size() - 1; }
+
+    //! Returns the number of edges.
+    uint32_t edgeCount() const { return (uint32_t)sources_.size(); }
+
+    //! Calls visit(from, cost) for each edge entering a node.
+    template <typename Visitor>
+    void forEachEdge(uint32_t node, Visitor && visit) const
+    {
+        for (uint32_t e = offsets_[node], end = offsets_[node + 1]; e != end; ++e)
+        {
+            visit(sources_[e], costs_[e]);
+        }
+    }
+
+    //! Returns the number of bytes used by the arrays.
+    size_t memoryUsage() const
+    {
+        return offsets_.size() * sizeof(uint32_t) + sources_.size() * sizeof(uint32_t) + costs_.size() * sizeof(float);
+    }
+
+private:
+
+    std::vector<uint32_t> offsets_; // Index of the first edge entering each node, plus the total number of edges
+    std::vector<uint32_t> sources_; // Source of each edge
+    std::vector<float> costs_;      // Cost of each edge
+};
+
+//! @param  graph   Graph whose edges are reversed
+//!
+//! @note   The graph's edges are enumerated twice: once to count the edges entering each node, and once to store them.
+
+template <typename Graph>
+ReverseAdjacency::ReverseAdjacency(Graph const & graph)
+{
+    uint32_t const size = graph.size();
+
+    // Count the edges entering each node, then convert the counts to offsets
+
+    offsets_.assign(size + 1, 0);
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        graph.forEachEdge(i, [this] (uint32_t to, float) { ++offsets_[to + 1]; });
+    }
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        offsets_[i + 1] += offsets_[i];
+    }
+
+    // Store the edges
+
+    sources_.resize(offsets_[size]);
+    costs_.resize(offsets_[size]);
+    std::vector<uint32_t> next(offsets_.begin(), offsets_.end() - 1);
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        graph.forEachEdge(i, [&] (uint32_t to, float cost) {
+            uint32_t e   = next[to]++;
+            sources_[e] = i;
+            costs_[e]   = cost;
+        });
+    }
+}
+
+#endif // !defined(PATHFINDER_REVERSEADJACENCY_H_INCLUDED)
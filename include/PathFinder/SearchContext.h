@@ -0,0 +1,285 @@
+#if !defined(PATHFINDER_SEARCHCONTEXT_H_INCLUDED)
+#define PATHFINDER_SEARCHCONTEXT_H_INCLUDED
+
+#pragma once
+
+#include "SearchStats.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+//! Per-search state of the nodes in a graph.
+//!
+//! The state is stored as a set of parallel arrays indexed by node index, so the graph itself is never modified by a
+//! search. Any number of searches may run concurrently on the same graph as long as each one uses its own context.
+//!
+//! Each node's state is stamped with the generation of the search that set it. A node is treated as not visited
+//! unless its stamp matches the current generation, so starting a new search is O(1) and does not touch the nodes.
+//!
+//! The estimated cost of the total path through a node is f = g + w * h, where the weight w is 1 unless an anytime
+//! search inflates it.
+//!
+//! A bidirectional search keeps the state of its backward half in a second context owned by this one.
+//!
+//! The context counts the nodes expanded, opened, updated and evicted by the search in its SearchStats, if statistics
+//! are enabled.
+class SearchContext
+{
+public:
+
+    //! Status of a node in the current search.
+    enum class Status : uint8_t
+    {
+        NOT_VISITED,
+        OPEN,
+        CLOSED,
+        FORGOTTEN,  //!< Removed from the open list to save memory. Its cost, predecessor and f are kept.
+        EXPIRED     //!< Closed by an earlier pass of an anytime search. Its cost and predecessor are kept.
+    };
+
+    static uint32_t constexpr NONE = ~0u;   //!< Index denoting no node
+
+    SearchContext() = default;
+    SearchContext(SearchContext &&) = default;
+    SearchContext & operator =(SearchContext &&) = default;
+
+    //! Prepares the context for a new search of a graph with the given number of nodes.
+    void begin(size_t size)
+    {
+        if (size > stamp_.size())
+        {
+            f_.resize(size);
+            g_.resize(size);
+            h_.resize(size);
+            predecessor_.resize(size);
+            handle_.resize(size);
+            status_.resize(size);
+            stamp_.resize(size, 0);
+        }
+
+        // If the generation wraps around, then the old stamps could match new generations, so they must be cleared.
+        if (++generation_ == 0)
+        {
+            std::fill(stamp_.begin(), stamp_.end(), 0);
+            generation_ = 1;
+        }
+
+        expansions_ = 0;
+        weight_     = 1.0f;
+#if PATHFINDER_ENABLE_STATS
+        stats_ = SearchStats();
+#endif
+    }
+
+    //! Returns the node's status.
+    Status status(uint32_t i) const { return (stamp_[i] == generation_) ? status_[i] : Status::NOT_VISITED; }
+
+    //! Returns true if the node is open.
+    bool isOpen(uint32_t i) const { return status(i) == Status::OPEN; }
+
+    //! Returns true if the node is closed.
+    bool isClosed(uint32_t i) const { return status(i) == Status::CLOSED; }
+
+    //! Opens a node that has not been visited.
+    void open(uint32_t i, float g, float h, uint32_t predecessor)
+    {
+        assert(status(i) == Status::NOT_VISITED);
+        stamp_[i]  = generation_;
+        status_[i] = Status::OPEN;
+        h_[i]      = h;
+        set(i, g, predecessor);
+#if PATHFINDER_ENABLE_STATS
+        ++stats_.opened;
+#endif
+    }
+
+    //! Updates the cost of the path to a node.
+    void update(uint32_t i, float g, uint32_t predecessor)
+    {
+        set(i, g, predecessor);
+#if PATHFINDER_ENABLE_STATS
+        ++stats_.updated;
+#endif
+    }
+
+    //! Sets the cost of the path to a node and its predecessor, opening it if it has not been visited, without
+    //! counting it in the statistics. This is used to link a path found by a search into the context.
+    void link(uint32_t i, float g, uint32_t predecessor)
+    {
+        if (status(i) == Status::NOT_VISITED)
+        {
+            stamp_[i]  = generation_;
+            status_[i] = Status::OPEN;
+            h_[i]      = 0.0f;
+        }
+        set(i, g, predecessor);
+    }
+
+    //! Closes an open node.
+    void close(uint32_t i)
+    {
+        assert(status(i) == Status::OPEN);
+        status_[i] = Status::CLOSED;
+    }
+
+    //! Forgets an open node that has been removed from the open list to save memory.
+    void forget(uint32_t i)
+    {
+        assert(status(i) == Status::OPEN);
+        status_[i] = Status::FORGOTTEN;
+#if PATHFINDER_ENABLE_STATS
+        ++stats_.evicted;
+#endif
+    }
+
+    //! Marks a node closed by an earlier pass of an anytime search, so that a later pass can open it again.
+    void expire(uint32_t i)
+    {
+        assert(status(i) == Status::CLOSED);
+        status_[i] = Status::EXPIRED;
+    }
+
+    //! Opens a closed, forgotten or expired node again, with the given cost of the path to it.
+    void reopen(uint32_t i, float g, uint32_t predecessor)
+    {
+        assert(status(i) == Status::CLOSED || status(i) == Status::FORGOTTEN || status(i) == Status::EXPIRED);
+        status_[i] = Status::OPEN;
+        set(i, g, predecessor);
+#if PATHFINDER_ENABLE_STATS
+        ++stats_.opened;
+#endif
+    }
+
+    //! Sets the estimated cost of the total path through an open or forgotten node to a value backed up from a
+    //! forgotten successor.
+    void backUp(uint32_t i, float f)
+    {
+        assert(status(i) == Status::OPEN || status(i) == Status::FORGOTTEN);
+        f_[i] = f;
+    }
+
+    //! Closes an open node and counts it as expanded.
+    void expand(uint32_t i)
+    {
+        close(i);
+        ++expansions_;
+#if PATHFINDER_ENABLE_STATS
+        ++stats_.expanded;
+#endif
+    }
+
+    //! Notes the size of the open list, for the statistics.
+    void recordOpenListSize(size_t size)
+    {
+#if PATHFINDER_ENABLE_STATS
+        stats_.peakOpen = std::max(stats_.peakOpen, (uint32_t)size);
+#endif
+        (void)size;
+    }
+
+#if PATHFINDER_ENABLE_STATS
+    //! Returns the statistics of the current search. Only available if statistics are enabled.
+    SearchStats & stats() { return stats_; }
+#endif
+
+    //! Returns the statistics of the current search. They are all 0 unless statistics are enabled.
+    SearchStats const & stats() const
+    {
+#if PATHFINDER_ENABLE_STATS
+        return stats_;
+#else
+        static SearchStats const none;
+        return none;
+#endif
+    }
+
+    //! Sets the weight of the heuristic in the estimated costs computed from now on. Existing estimates are unchanged.
+    void setWeight(float weight)
+    {
+        assert(weight >= 1.0f);
+        weight_ = weight;
+    }
+
+    //! Returns the weight of the heuristic.
+    float weight() const { return weight_; }
+
+    //! Returns the number of nodes expanded by the current search.
+    uint32_t expansions() const { return expansions_; }
+
+    //! Returns the context holding the state of the backward half of a bidirectional search.
+    SearchContext & backward()
+    {
+        if (!backward_)
+            backward_ = std::make_unique<SearchContext>();
+        return *backward_;
+    }
+
+    //! Returns the context holding the state of the backward half of a bidirectional search.
+    SearchContext const & backward() const
+    {
+        assert(backward_);
+        return *backward_;
+    }
+
+    //! Returns true if the context has been used for a bidirectional search.
+    bool hasBackward() const { return backward_ != nullptr; }
+
+    //! Returns the estimated cost of the total path through a visited node.
+    float f(uint32_t i) const { return f_[i]; }
+
+    //! Returns the cost of the path to a visited node.
+    float g(uint32_t i) const { return g_[i]; }
+
+    //! Returns the estimated cost from a visited node to the goal.
+    float h(uint32_t i) const { return h_[i]; }
+
+    //! Returns the previous node in the path to a visited node, or NONE.
+    uint32_t predecessor(uint32_t i) const { return predecessor_[i]; }
+
+    //! Returns the location of an open node in the open list.
+    uint32_t handle(uint32_t i) const { return handle_[i]; }
+
+    //! Sets the location of an open node in the open list.
+    void setHandle(uint32_t i, uint32_t handle) { handle_[i] = handle; }
+
+private:
+
+    // Sets the cost of the path to a node and its predecessor
+    void set(uint32_t i, float g, uint32_t predecessor)
+    {
+        g_[i]           = g;
+        f_[i]           = g + weight_ * h_[i];
+        predecessor_[i] = predecessor;
+    }
+
+    std::vector<float> f_;              // Estimated cost of total path through the node
+    std::vector<float> g_;              // Cost of path to the node
+    std::vector<float> h_;              // Cached value of the heuristic
+    std::vector<uint32_t> predecessor_; // Previous node in the path
+    std::vector<uint32_t> handle_;      // Location of the node in the open list
+    std::vector<Status> status_;        // Node status
+    std::vector<uint32_t> stamp_;       // Generation of the search that last visited the node
+    uint32_t generation_ = 0;           // Generation of the current search
+    uint32_t expansions_ = 0;           // Number of nodes expanded by the current search
+    float weight_ = 1.0f;               // Weight of the heuristic in f
+    std::conditional_t<SearchStats::ENABLED, SearchStats, NoSearchStats> stats_; // Statistics of the search, if enabled
+    std::unique_ptr<SearchContext> backward_;   // State of the backward half of a bidirectional search
+};
+
+//! Connects an open list (see OpenList.h) to the search state stored in a context. The priority of a node is its f.
+struct SearchContextAccess
+{
+    float priority(uint32_t i) const { return context->f(i); }
+    uint32_t handle(uint32_t i) const { return context->handle(i); }
+    void setHandle(uint32_t i, uint32_t handle) const { context->setHandle(i, handle); }
+    float resolution() const { return bucketWidth; }
+
+    SearchContext * context;
+    float bucketWidth = 1.0f;   //!< Range of priorities in each bucket of a BucketOpenList
+};
+
+#endif // !defined(PATHFINDER_SEARCHCONTEXT_H_INCLUDED)
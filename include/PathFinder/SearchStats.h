@@ -0,0 +1,153 @@
+#if !defined(PATHFINDER_SEARCHSTATS_H_INCLUDED)
+#define PATHFINDER_SEARCHSTATS_H_INCLUDED
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+#if !defined(PATHFINDER_ENABLE_STATS)
+#define PATHFINDER_ENABLE_STATS 0   //!< Define as 1 to collect search statistics (see SearchStats)
+#endif
+
+//! Statistics of a search.
+//!
+//! The statistics are collected only if PATHFINDER_ENABLE_STATS is defined as 1, which the PathFinder_ENABLE_STATS
+//! option of the build does for the library and the code that uses it. Otherwise, the code that collects them is
+//! compiled out, so it costs nothing, and the statistics remain 0.
+//!
+//! The counts are kept by the SearchContext, so they are collected for any search that uses one. BasicPathFinder also
+//! records the path and the time taken by each query, and adds the statistics to its SearchCounters.
+struct SearchStats
+{
+    using Clock = std::chrono::steady_clock;    //!< Clock used to time queries
+
+    static bool constexpr ENABLED = PATHFINDER_ENABLE_STATS != 0;  //!< True if statistics are collected
+
+    uint32_t expanded   = 0;        //!< Number of nodes expanded
+    uint32_t opened     = 0;        //!< Number of nodes added to the open list, including nodes added again
+    uint32_t updated    = 0;        //!< Number of lower costs found for open nodes (each one a decrease-key)
+    uint32_t evicted    = 0;        //!< Number of nodes removed from the open list to keep it within maxNodes
+    uint32_t peakOpen   = 0;        //!< Largest size of the open list, summed over the directions of a search
+    uint32_t pathLength = 0;        //!< Number of nodes in the path, or 0 if none was found
+    float cost          = INFINITY; //!< Cost of the path, or INFINITY if none was found
+    double seconds      = 0.0;      //!< Time taken by the query
+
+    //! Adds the counts of another search, such as the backward half of a bidirectional search.
+    void merge(SearchStats const & other)
+    {
+        expanded += other.expanded;
+        opened   += other.opened;
+        updated  += other.updated;
+        evicted  += other.evicted;
+        peakOpen += other.peakOpen;
+    }
+
+    //! Returns the time at which a query starts, if statistics are collected.
+    static Clock::time_point start() { return ENABLED ? Clock::now() : Clock::time_point(); }
+
+    //! Returns the time in seconds since a query started.
+    static double elapsed(Clock::time_point t0) { return std::chrono::duration<double>(Clock::now() - t0).count(); }
+};
+
+//! Totals of the statistics of any number of searches, which any number of threads can add to at the same time.
+class SearchCounters
+{
+public:
+
+    //! The totals at one time.
+    struct Totals
+    {
+        uint64_t queries     = 0;   //!< Number of queries
+        uint64_t found       = 0;   //!< Number of queries that found a path
+        uint64_t expanded    = 0;   //!< Number of nodes expanded
+        uint64_t opened      = 0;   //!< Number of nodes added to open lists
+        uint64_t updated     = 0;   //!< Number of lower costs found for open nodes
+        uint64_t evicted     = 0;   //!< Number of nodes evicted from open lists
+        uint64_t pathLength  = 0;   //!< Number of nodes in the paths found
+        uint64_t nanoseconds = 0;   //!< Time taken by the queries
+        uint32_t peakOpen    = 0;   //!< Largest size of the open list of any query
+    };
+
+    SearchCounters() = default;
+
+    //! Copies the totals of other counters.
+    SearchCounters(SearchCounters const & other) { *this = other; }
+
+    //! Copies the totals of other counters.
+    SearchCounters & operator =(SearchCounters const & other)
+    {
+        Totals const totals = other.totals();
+        queries_.store(totals.queries, std::memory_order_relaxed);
+        found_.store(totals.found, std::memory_order_relaxed);
+        expanded_.store(totals.expanded, std::memory_order_relaxed);
+        opened_.store(totals.opened, std::memory_order_relaxed);
+        updated_.store(totals.updated, std::memory_order_relaxed);
+        evicted_.store(totals.evicted, std::memory_order_relaxed);
+        pathLength_.store(totals.pathLength, std::memory_order_relaxed);
+        nanoseconds_.store(totals.nanoseconds, std::memory_order_relaxed);
+        peakOpen_.store(totals.peakOpen, std::memory_order_relaxed);
+        return *this;
+    }
+
+    //! Adds the statistics of a query.
+    void add(SearchStats const & stats)
+    {
+        queries_.fetch_add(1, std::memory_order_relaxed);
+        found_.fetch_add(stats.pathLength > 0 ? 1 : 0, std::memory_order_relaxed);
+        expanded_.fetch_add(stats.expanded, std::memory_order_relaxed);
+        opened_.fetch_add(stats.opened, std::memory_order_relaxed);
+        updated_.fetch_add(stats.updated, std::memory_order_relaxed);
+        evicted_.fetch_add(stats.evicted, std::memory_order_relaxed);
+        pathLength_.fetch_add(stats.pathLength, std::memory_order_relaxed);
+        nanoseconds_.fetch_add((uint64_t)(stats.seconds * 1e9), std::memory_order_relaxed);
+
+        // Raise the peak unless another thread has raised it higher
+        uint32_t peak = peakOpen_.load(std::memory_order_relaxed);
+        while (stats.peakOpen > peak &&
+               !peakOpen_.compare_exchange_weak(peak, stats.peakOpen, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    //! Returns the totals. Queries being added at the same time may be partly included.
+    Totals totals() const
+    {
+        Totals totals;
+        totals.queries     = queries_.load(std::memory_order_relaxed);
+        totals.found       = found_.load(std::memory_order_relaxed);
+        totals.expanded    = expanded_.load(std::memory_order_relaxed);
+        totals.opened      = opened_.load(std::memory_order_relaxed);
+        totals.updated     = updated_.load(std::memory_order_relaxed);
+        totals.evicted     = evicted_.load(std::memory_order_relaxed);
+        totals.pathLength  = pathLength_.load(std::memory_order_relaxed);
+        totals.nanoseconds = nanoseconds_.load(std::memory_order_relaxed);
+        totals.peakOpen    = peakOpen_.load(std::memory_order_relaxed);
+        return totals;
+    }
+
+    //! Sets the totals to 0.
+    void reset() { *this = SearchCounters(); }
+
+private:
+
+    std::atomic<uint64_t> queries_{ 0 };
+    std::atomic<uint64_t> found_{ 0 };
+    std::atomic<uint64_t> expanded_{ 0 };
+    std::atomic<uint64_t> opened_{ 0 };
+    std::atomic<uint64_t> updated_{ 0 };
+    std::atomic<uint64_t> evicted_{ 0 };
+    std::atomic<uint64_t> pathLength_{ 0 };
+    std::atomic<uint64_t> nanoseconds_{ 0 };
+    std::atomic<uint32_t> peakOpen_{ 0 };
+};
+
+//! Takes the place of the SearchStats of a SearchContext and the SearchCounters of a BasicPathFinder when statistics
+//! are disabled, so that they take no space.
+struct NoSearchStats
+{
+};
+
+#endif // !defined(PATHFINDER_SEARCHSTATS_H_INCLUDED)
@@ -0,0 +1,88 @@
+#if !defined(PATHFINDER_SEARCHWORKSPACE_H_INCLUDED)
+#define PATHFINDER_SEARCHWORKSPACE_H_INCLUDED
+
+#pragma once
+
+#include "OpenList.h"
+#include "SearchContext.h"
+
+#include <cstdint>
+#include <memory>
+#include <tuple>
+
+//! Memory reused by the searches of BasicPathFinder: the state of the nodes and the open lists.
+//!
+//! A search that is given only a SearchContext creates its open list, and the open list allocates as it grows. A
+//! workspace keeps an open list of each implementation for each direction of a search, created the first time it is
+//! used, and clears it rather than freeing it when the next search begins. Once a workspace has run a query, another
+//! query of the same graph that visits no more nodes does not allocate any memory. Paths are written by following the
+//! predecessors from the end twice (once to count the nodes and once to store them), so no scratch space is needed
+//! to put them in order.
+//!
+//! The open lists refer to the context, which is allocated separately so that a workspace can be moved.
+class SearchWorkspace
+{
+public:
+
+    using Access = SearchContextAccess; //!< Connects the open lists to the context
+    SearchWorkspace() : context_(std::make_unique<SearchContext>()) {}
+    SearchWorkspace(SearchWorkspace &&) = default;
+    SearchWorkspace & operator =(SearchWorkspace &&) = default;
+
+    //! Returns the state of the last search.
+    SearchContext & context() { return *context_; }
+
+    //! Returns the state of the last search.
+    SearchContext const & context() const { return *context_; }
+
+    //! Returns an empty open list of the given implementation, for the forward search or for the backward half of a
+    //! bidirectional search. It keeps its memory from the last search that used it.
+    template <typename Open>
+    Open & openList(float bucketWidth, bool backward = false);
+
+private:
+
+    // An open list and the bucket width it was created with
+    template <typename Open>
+    struct Slot
+    {
+        std::unique_ptr<Open> open;
+        float bucketWidth = 0.0f;
+    };
+
+    using OpenLists = std::tuple<Slot<BinaryHeapOpenList<uint32_t, Access>>,
+                                 Slot<IndexedHeapOpenList<uint32_t, Access>>,
+                                 Slot<PairingHeapOpenList<uint32_t, Access>>,
+                                 Slot<MinMaxHeapOpenList<uint32_t, Access>>,
+                                 Slot<BucketOpenList<uint32_t, Access>>>;
+
+    std::unique_ptr<SearchContext> context_;
+    OpenLists forward_;     // Open lists of forward searches
+    OpenLists backward_;    // Open lists of the backward halves of bidirectional searches
+};
+
+//! @param  bucketWidth     Range of priorities in each bucket of a BucketOpenList
+//! @param  backward        If true, the open list is connected to the context of the backward half of a search
+//!
+//! @returns    the open list, which is empty
+//!
+//! @note   The open list is created again if the bucket width differs from the last search that used it.
+
+template <typename Open>
+Open & SearchWorkspace::openList(float bucketWidth, bool backward)
+{
+    Slot<Open> & slot = std::get<Slot<Open>>(backward ? backward_ : forward_);
+    if (!slot.open || slot.bucketWidth != bucketWidth)
+    {
+        SearchContext * context = backward ? &context_->backward() : context_.get();
+        slot.open        = std::make_unique<Open>(Access{ context, bucketWidth });
+        slot.bucketWidth = bucketWidth;
+    }
+    else
+    {
+        slot.open->clear();
+    }
+    return *slot.open;
+}
+
+#endif // !defined(PATHFINDER_SEARCHWORKSPACE_H_INCLUDED)
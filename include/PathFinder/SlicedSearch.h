@@ -0,0 +1,361 @@
+#if !defined(PATHFINDER_SLICEDSEARCH_H_INCLUDED)
+#define PATHFINDER_SLICEDSEARCH_H_INCLUDED
+
+#pragma once
+
+#include "BasicPathFinder.h"
+#include "OpenList.h"
+#include "PathFinder.h"
+#include "SearchContext.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+//! A search that runs in slices, for callers that can spend only a limited time on pathfinding in each frame.
+//!
+//! The search is started by the constructor or restart(), and each call to step() expands nodes until the search ends
+//! or the slice's budget (a number of expansions or a deadline) runs out. The open list and the state of the nodes are
+//! kept between slices, so a search that is run in slices expands the same nodes, in the same order, as one that is
+//! run at once, and finds the same path.
+//!
+//! The search uses the graph, heuristic and cost policy of a BasicPathFinder, which must outlive it, and must not be
+//! modified while the search is in progress. The search is an A* search from the start to the end using an indexed
+//! heap; the finder's policy is not used. Each search has its own context, so any number of searches can be
+//! interleaved on a thread, and each search can run on a different thread from one slice to the next.
+//!
+//! SearchScheduler divides a budget among several searches.
+template <typename Graph, typename Heuristic = ZeroHeuristic, typename CostPolicy = EdgeCost>
+class BasicSlicedSearch
+{
+public:
+
+    using Finder = BasicPathFinder<Graph, Heuristic, CostPolicy>;   //!< Pathfinder providing the graph.
+    using Vertex = typename Finder::Vertex;                         //!< A node as identified by users of the graph.
+    using Path   = typename Finder::Path;                           //!< A path.
+    using Clock  = std::chrono::steady_clock;                       //!< Clock measuring deadlines.
+
+    //! Status of the search.
+    enum class Status
+    {
+        IN_PROGRESS,    //!< The search has not ended.
+        FOUND,          //!< A path has been found.
+        NO_PATH         //!< There is no path.
+    };
+
+    BasicSlicedSearch(Finder const & finder, Vertex start, Vertex end);
+
+    // The open list refers to the context, so the search cannot be copied or moved
+    BasicSlicedSearch(BasicSlicedSearch const &) = delete;
+    BasicSlicedSearch & operator =(BasicSlicedSearch const &) = delete;
+
+    //! Abandons the search and starts a new one. The memory used by the search is kept.
+    void restart(Vertex start, Vertex end);
+
+    //! Expands up to the given number of nodes. Returns the status of the search.
+    Status step(uint32_t maxExpansions);
+
+    //! Expands nodes until the deadline. Returns the status of the search.
+    Status step(Clock::time_point deadline);
+
+    //! Returns the status of the search.
+    Status status() const { return status_; }
+
+    //! Gets the path that was found. Returns false if the search has not found one.
+    bool getPath(Path * path) const;
+
+    //! Returns the cost of the path that was found, or INFINITY if the search has not found one.
+    float cost() const { return (status_ == Status::FOUND) ? context_.g(end_) : INFINITY; }
+
+    //! Returns the number of nodes expanded so far.
+    uint32_t expansions() const { return context_.expansions(); }
+
+    //! Returns the state of the search.
+    SearchContext const & context() const { return context_; }
+
+private:
+
+    using Open = IndexedHeapOpenList<uint32_t, SearchContextAccess>;
+
+    // Expands nodes until the search ends or done(n) returns true after n expansions in this slice
+    template <typename Done>
+    Status run(Done && done);
+
+    Finder const * finder_;
+    SearchContext context_;
+    Open open_;
+    uint32_t start_ = SearchContext::NONE;
+    uint32_t end_   = SearchContext::NONE;
+    Status status_  = Status::IN_PROGRESS;
+};
+
+//! Divides a budget among sliced searches by priority.
+//!
+//! Each call to run() gives the budget to the search with the highest priority, or to the earliest added of those
+//! with the same priority. If the search ends before the budget runs out, it is removed, and the rest of the budget
+//! goes to the next one. A search that is still in progress keeps its place for the next call. The caller owns the
+//! searches, and checks their statuses to find out which have ended.
+//!
+//! A search with a low priority gets no time while searches with higher priorities are in progress. To prevent that, a
+//! caller can remove a search and add it again with a higher priority.
+template <typename Search>
+class SearchScheduler
+{
+public:
+
+    using Clock = std::chrono::steady_clock;    //!< Clock measuring deadlines.
+
+    //! Adds a search. Searches with higher priorities run first.
+    void add(Search * search, int priority = 0);
+
+    //! Removes a search. Returns false if it was not scheduled.
+    bool remove(Search * search);
+
+    //! Runs the scheduled searches for up to the given number of expansions in total. Returns the number used.
+    uint32_t run(uint32_t maxExpansions);
+
+    //! Runs the scheduled searches until the deadline. Returns the number of expansions.
+    uint32_t run(Clock::time_point deadline);
+
+    //! Returns the number of scheduled searches.
+    size_t size() const { return entries_.size(); }
+
+    //! Returns true if no searches are scheduled.
+    bool empty() const { return entries_.empty(); }
+
+private:
+
+    struct Entry
+    {
+        Search * search;
+        int priority;
+        uint64_t sequence;  // Order in which the searches were added
+    };
+
+    // Runs the searches in order, calling step(search) for each, until one is still in progress
+    template <typename Step>
+    uint32_t runUsing(Step && step);
+
+    std::vector<Entry> entries_;    // In the order in which they run
+    uint64_t sequence_ = 0;
+};
+
+//! @param  finder  Pathfinder providing the graph, heuristic and cost policy
+//! @param  start   Start node
+//! @param  end     End node
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+BasicSlicedSearch<Graph, Heuristic, CostPolicy>::BasicSlicedSearch(Finder const & finder, Vertex start, Vertex end)
+    : finder_(&finder)
+    , open_(SearchContextAccess{ &context_ })
+{
+    restart(start, end);
+}
+
+//! @param  start   Start node
+//! @param  end     End node
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+void BasicSlicedSearch<Graph, Heuristic, CostPolicy>::restart(Vertex start, Vertex end)
+{
+    Graph const & graph = finder_->graph();
+    start_ = graph.index(start);
+    end_   = graph.index(end);
+    assert(start_ < graph.size() && end_ < graph.size());
+
+    open_.clear();
+    context_.begin(graph.size());
+    context_.open(start_, 0.0f, finder_->heuristic()(graph, start_, end_), SearchContext::NONE);
+    open_.push(start_);
+    status_ = Status::IN_PROGRESS;
+}
+
+//! @param  maxExpansions   Maximum number of nodes to expand
+//!
+//! @returns    the status of the search
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+typename BasicSlicedSearch<Graph, Heuristic, CostPolicy>::Status
+BasicSlicedSearch<Graph, Heuristic, CostPolicy>::step(uint32_t maxExpansions)
+{
+    return run([maxExpansions] (uint32_t n) { return n >= maxExpansions; });
+}
+
+//! @param  deadline    Time at which to stop
+//!
+//! @returns    the status of the search
+//!
+//! @note   The clock is read every few expansions, so the search may run a few expansions past the deadline. If the
+//!         deadline has already passed, no nodes are expanded.
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+typename BasicSlicedSearch<Graph, Heuristic, CostPolicy>::Status
+BasicSlicedSearch<Graph, Heuristic, CostPolicy>::step(Clock::time_point deadline)
+{
+    // The clock is read once every this many expansions
+    uint32_t constexpr CLOCK_INTERVAL = 64;
+
+    return run([deadline] (uint32_t n) { return n % CLOCK_INTERVAL == 0 && Clock::now() >= deadline; });
+}
+
+//! @param  path    Path from the start to the end, including both
+//!
+//! @returns    true, if the search has found a path
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+bool BasicSlicedSearch<Graph, Heuristic, CostPolicy>::getPath(Path * path) const
+{
+    assert(path);
+
+    path->clear();
+    if (status_ != Status::FOUND)
+        return false;
+
+    for (uint32_t i = end_; i != SearchContext::NONE; i = context_.predecessor(i))
+    {
+        path->push_back(finder_->graph().vertex(i));
+    }
+    std::reverse(path->begin(), path->end());
+    return true;
+}
+
+template <typename Graph, typename Heuristic, typename CostPolicy>
+template <typename Done>
+typename BasicSlicedSearch<Graph, Heuristic, CostPolicy>::Status
+BasicSlicedSearch<Graph, Heuristic, CostPolicy>::run(Done && done)
+{
+    Graph const & graph           = finder_->graph();
+    Heuristic const & heuristic   = finder_->heuristic();
+    CostPolicy const & costPolicy = finder_->costPolicy();
+
+    for (uint32_t n = 0; status_ == Status::IN_PROGRESS && !done(n); ++n)
+    {
+        if (open_.empty())
+        {
+            status_ = Status::NO_PATH;
+            break;
+        }
+
+        uint32_t const current = open_.top();
+        context_.expand(current);
+        open_.pop();
+
+        if (current == end_)
+        {
+            status_ = Status::FOUND;
+            break;
+        }
+
+        float const g = context_.g(current);
+        graph.forEachEdge(current, [&] (uint32_t neighbor, float edgeCost) {
+            if (context_.isClosed(neighbor))
+                return;
+
+            float const cost = g + costPolicy(graph, current, neighbor, edgeCost);
+            if (!context_.isOpen(neighbor))
+            {
+                context_.open(neighbor, cost, heuristic(graph, neighbor, end_), current);
+                open_.push(neighbor);
+            }
+            else if (cost < context_.g(neighbor))
+            {
+                context_.update(neighbor, cost, current);
+                open_.decrease(neighbor);
+            }
+        });
+    }
+
+    // A search whose open list ran out during the last expansion ends now rather than in the next slice
+    if (status_ == Status::IN_PROGRESS && open_.empty())
+        status_ = Status::NO_PATH;
+
+    return status_;
+}
+
+//! @param  search      Search to run. It must remain valid until it is removed or it ends.
+//! @param  priority    Priority of the search. Searches with higher priorities run first.
+
+template <typename Search>
+void SearchScheduler<Search>::add(Search * search, int priority)
+{
+    assert(search);
+
+    Entry const entry{ search, priority, sequence_++ };
+    auto position = std::upper_bound(entries_.begin(), entries_.end(), entry, [] (Entry const & a, Entry const & b) {
+        return a.priority > b.priority || (a.priority == b.priority && a.sequence < b.sequence);
+    });
+    entries_.insert(position, entry);
+}
+
+//! @param  search  Search to remove
+//!
+//! @returns    true, if the search was scheduled
+
+template <typename Search>
+bool SearchScheduler<Search>::remove(Search * search)
+{
+    auto entry = std::find_if(entries_.begin(), entries_.end(), [search] (Entry const & e) {
+        return e.search == search;
+    });
+    if (entry == entries_.end())
+        return false;
+    entries_.erase(entry);
+    return true;
+}
+
+//! @param  maxExpansions   Maximum number of nodes to expand, over all of the searches
+//!
+//! @returns    the number of nodes expanded
+
+template <typename Search>
+uint32_t SearchScheduler<Search>::run(uint32_t maxExpansions)
+{
+    uint32_t remaining = maxExpansions;
+    return runUsing([&remaining] (Search & search) {
+        uint32_t const before = search.expansions();
+        auto const status = search.step(remaining);
+        remaining -= search.expansions() - before;
+        return status;
+    });
+}
+
+//! @param  deadline    Time at which to stop
+//!
+//! @returns    the number of nodes expanded
+
+template <typename Search>
+uint32_t SearchScheduler<Search>::run(Clock::time_point deadline)
+{
+    return runUsing([deadline] (Search & search) { return search.step(deadline); });
+}
+
+template <typename Search>
+template <typename Step>
+uint32_t SearchScheduler<Search>::runUsing(Step && step)
+{
+    uint32_t expansions = 0;
+    size_t ended = 0;
+    for (Entry const & entry : entries_)
+    {
+        uint32_t const before = entry.search->expansions();
+        bool const inProgress = (step(*entry.search) == Search::Status::IN_PROGRESS);
+        expansions += entry.search->expansions() - before;
+        if (inProgress)
+            break;
+        ++ended;
+    }
+
+    // The searches that ended are at the front
+    entries_.erase(entries_.begin(), entries_.begin() + ended);
+    return expansions;
+}
+
+extern template class BasicSlicedSearch<NodeGraph, NodeHeuristic, EdgeCost>;
+
+//! Sliced search over a graph of user-defined nodes, using a PathFinder's graph.
+using SlicedSearch = BasicSlicedSearch<NodeGraph, NodeHeuristic, EdgeCost>;
+
+#endif // !defined(PATHFINDER_SLICEDSEARCH_H_INCLUDED)
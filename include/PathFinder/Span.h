@@ -0,0 +1,58 @@
+#if !defined(PATHFINDER_SPAN_H_INCLUDED)
+#define PATHFINDER_SPAN_H_INCLUDED
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+
+//! A non-owning view of a contiguous array, like std::span in C++20.
+template <typename T>
+class Span
+{
+public:
+
+    //! Constructs an empty span.
+    Span() = default;
+
+    //! Constructs a span of an array.
+    Span(T * data, size_t size)
+        : data_(data)
+        , size_(size)
+    {
+    }
+
+    //! Constructs a span of a container with contiguous storage, such as a std::vector.
+    template <typename Container>
+    Span(Container & container)
+        : data_(container.data())
+        , size_(container.size())
+    {
+    }
+
+    //! Returns the first element.
+    T * data() const { return data_; }
+
+    //! Returns the number of elements.
+    size_t size() const { return size_; }
+
+    //! Returns true if the span has no elements.
+    bool empty() const { return size_ == 0; }
+
+    //! Returns an element.
+    T & operator [](size_t i) const
+    {
+        assert(i < size_);
+        return data_[i];
+    }
+
+    T * begin() const { return data_; }
+    T * end() const { return data_ + size_; }
+
+private:
+
+    T * data_    = nullptr;
+    size_t size_ = 0;
+};
+
+#endif // !defined(PATHFINDER_SPAN_H_INCLUDED)
@@ -0,0 +1,86 @@
+#if !defined(PATHFINDER_THREADPOOL_H_INCLUDED)
+#define PATHFINDER_THREADPOOL_H_INCLUDED
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+//! A fixed set of worker threads that run batches of independent tasks, balancing the load by work stealing.
+//!
+//! A batch of tasks is split evenly between the workers. Each worker takes tasks from the front of its own range, and
+//! a worker that runs out steals the back half of the range of another worker. So, a worker that is stuck on a long
+//! task does not hold up the tasks behind it, and the workers stay busy until the whole batch is done.
+//!
+//! The thread that calls run() is one of the workers, so a pool of size 1 has no threads of its own and runs the tasks
+//! in order.
+class ThreadPool
+{
+public:
+
+    //! Constructor. If the number of workers is 0, there is one per hardware thread.
+    explicit ThreadPool(unsigned workers = 0);
+
+    ~ThreadPool();
+
+    ThreadPool(ThreadPool const &) = delete;
+    ThreadPool & operator =(ThreadPool const &) = delete;
+
+    //! Returns the number of workers, including the thread that calls run().
+    unsigned size() const { return size_; }
+
+    //! Calls task(index, worker) for each index in [0, count), and returns when all of the calls have returned.
+    //! The worker is in [0, size()) and identifies the worker making the call, so it can be used to select per-worker
+    //! state. The calls are made concurrently, so they must not throw.
+    template <typename Task>
+    void run(uint32_t count, Task && task)
+    {
+        using Function = std::remove_reference_t<Task>;
+        execute(count, [] (void * task, uint32_t index, unsigned worker) { (*static_cast<Function *>(task))(index, worker); },
+                const_cast<void *>(static_cast<void const *>(&task)));
+    }
+
+private:
+
+    using Call = void (*)(void * task, uint32_t index, unsigned worker);
+
+    // A worker's range of remaining tasks. Each one is on its own cache line so that workers do not interfere.
+    struct alignas(64) Queue
+    {
+        std::mutex mutex;
+        uint32_t begin = 0;
+        uint32_t end   = 0;
+    };
+
+    // Runs a batch of tasks
+    void execute(uint32_t count, Call call, void * task);
+
+    // Main function of a worker thread
+    void loop(unsigned worker);
+
+    // Runs tasks until there are none left to run or steal
+    void work(unsigned worker);
+
+    // Gets the next task for a worker, stealing if necessary. Returns false if there are no tasks left.
+    bool next(unsigned worker, uint32_t * index);
+
+    unsigned size_;
+    std::unique_ptr<Queue[]> queues_;
+    std::vector<std::thread> threads_;
+
+    std::mutex mutex_;                  // Guards the following
+    std::condition_variable started_;   // Signaled when a batch starts or the pool is destroyed
+    std::condition_variable finished_;  // Signaled when a worker thread has finished its part of a batch
+    uint64_t batch_ = 0;                // Number of batches started
+    unsigned busy_  = 0;                // Number of worker threads that have not finished the current batch
+    bool stop_      = false;            // True if the threads should exit
+    Call call_      = nullptr;          // Function running the tasks of the current batch
+    void * task_    = nullptr;          // Task of the current batch
+};
+
+#endif // !defined(PATHFINDER_THREADPOOL_H_INCLUDED)